@@ -0,0 +1,147 @@
+#include "benchdata.h"
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
+#include "datasetgenerator.h"
+#include "sparkplugencoder.h"
+
+namespace {
+
+// CBOR数据项头部，参数按最短形式编码
+void appendCborHead(QByteArray *out, quint8 major, quint64 argument)
+{
+    major <<= 5;
+    if (argument < 24) {
+        out->append(char(major | argument));
+        return;
+    }
+    int size = argument <= 0xff ? 1 : argument <= 0xffff ? 2 : argument <= 0xffffffffULL ? 4 : 8;
+    out->append(char(major | (size == 1 ? 24 : size == 2 ? 25 : size == 4 ? 26 : 27)));
+    for (int shift = (size - 1) * 8; shift >= 0; shift -= 8) {
+        out->append(char(argument >> shift));
+    }
+}
+
+void appendCborText(QByteArray *out, const char *text)
+{
+    int size = int(strlen(text));
+    appendCborHead(out, 3, size);
+    out->append(text, size);
+}
+
+void appendCborDouble(QByteArray *out, double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    out->append(char(0xfb));
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out->append(char(bits >> shift));
+    }
+}
+
+}
+
+namespace BenchData {
+
+QByteArray sceneJson(int itemCount)
+{
+    return DatasetGenerator().scene(itemCount, qMax(1, itemCount / 3));
+}
+
+QByteArray valuesMessage(int sampleCount, int addressCount, double offset)
+{
+    QByteArray message("{\"timestamp\":\"1700000000000\",\"body\":[");
+    for (int i = 0; i < sampleCount; ++i) {
+        if (i > 0) {
+            message.append(',');
+        }
+        message.append("{\"addr\":");
+        message.append(QByteArray::number(i % qMax(1, addressCount)));
+        message.append(",\"val\":");
+        message.append(QByteArray::number(offset + i * 0.25, 'f', 2));
+        message.append('}');
+    }
+    message.append("]}");
+    return message;
+}
+
+QByteArray cborValuesMessage(int sampleCount, int addressCount, double offset)
+{
+    QByteArray message;
+    appendCborHead(&message, 5, 2);
+    appendCborText(&message, "timestamp");
+    appendCborHead(&message, 0, 1700000000000ULL);
+    appendCborText(&message, "body");
+    appendCborHead(&message, 4, quint64(sampleCount));
+    for (int i = 0; i < sampleCount; ++i) {
+        appendCborHead(&message, 5, 2);
+        appendCborText(&message, "addr");
+        appendCborHead(&message, 0, quint64(i % qMax(1, addressCount)));
+        appendCborText(&message, "val");
+        appendCborDouble(&message, offset + i * 0.25);
+    }
+    return message;
+}
+
+QByteArray packedValuesMessage(int sampleCount, int addressCount, double offset)
+{
+    QByteArray message(20 + sampleCount * 12, '\0');
+    uchar *data = reinterpret_cast<uchar *>(message.data());
+    memcpy(data, "SCPK", 4);
+    data[4] = 1;
+    qToLittleEndian<quint32>(quint32(sampleCount), data + 8);
+    qToLittleEndian<qint64>(Q_INT64_C(1700000000000), data + 12);
+    uchar *record = data + 20;
+    for (int i = 0; i < sampleCount; ++i) {
+        double value = offset + i * 0.25;
+        quint64 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        qToLittleEndian<quint32>(quint32(i % qMax(1, addressCount)), record);
+        qToLittleEndian<quint64>(bits, record + 4);
+        record += 12;
+    }
+    return message;
+}
+
+QByteArray variableConfig(int variableCount)
+{
+    return DatasetGenerator().variableConfig(variableCount, variableCount);
+}
+
+QByteArray componentLibrary(int componentCount)
+{
+    return DatasetGenerator().componentLibrary(componentCount);
+}
+
+QByteArray sparkplugBirth(int addressCount)
+{
+    // 指标名称和别名都是地址
+    QByteArray message;
+    SparkplugEncoder encoder(&message);
+    encoder.addTimestamp(1700000000000ULL);
+    for (int addr = 0; addr < addressCount; ++addr) {
+        encoder.addDoubleMetric(QByteArray::number(addr), quint64(addr), 0);
+    }
+    encoder.addSequence(0);
+    return message;
+}
+
+QByteArray sparkplugData(int sampleCount, int addressCount, double offset)
+{
+    QByteArray message;
+    SparkplugEncoder encoder(&message);
+    encoder.addTimestamp(1700000000000ULL);
+    for (int i = 0; i < sampleCount; ++i) {
+        encoder.addDoubleMetric(QByteArray(), quint64(i % qMax(1, addressCount)), offset + i * 0.25);
+    }
+    encoder.addSequence(1);
+    return message;
+}
+
+bool writeFile(const QString &fileName, const QByteArray &data)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+}
@@ -0,0 +1,43 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief 基准测试的输入数据
+ * 场景、配置和组件库由DatasetGenerator按固定种子生成，内容只由规模决定
+ */
+namespace BenchData {
+
+// 设计器场景JSON，数值显示绑定的地址个数为组件个数的三分之一
+QByteArray sceneJson(int itemCount);
+
+// MQTT数据报文 {timestamp, body:[{addr,val}]}，地址在 [0, addressCount) 内循环，
+// offset不同的报文中同一地址的值不同
+QByteArray valuesMessage(int sampleCount, int addressCount, double offset = 0);
+
+// 与valuesMessage内容相同的CBOR报文
+QByteArray cborValuesMessage(int sampleCount, int addressCount, double offset = 0);
+
+// 与valuesMessage内容相同的定长记录报文（格式见PackedValueDecoder）
+QByteArray packedValuesMessage(int sampleCount, int addressCount, double offset = 0);
+
+// Sparkplug B的NBIRTH报文：指标名称为地址 "0".."<n-1>"，别名与地址相同，类型为Double
+QByteArray sparkplugBirth(int addressCount);
+
+// 与valuesMessage内容相同的Sparkplug B数据报文，指标只带别名
+QByteArray sparkplugData(int sampleCount, int addressCount, double offset = 0);
+
+// XmlConfig配置文件，包含variableCount个变量和同样个数的绑定
+QByteArray variableConfig(int variableCount);
+
+// 组件库components.xml，包含componentCount个带预览图的组件，组件名为 "C0".."C<n-1>"
+QByteArray componentLibrary(int componentCount);
+
+// 写入文件，失败时返回false
+bool writeFile(const QString &fileName, const QByteArray &data);
+
+}
+
+#endif // BENCHDATA_H
@@ -0,0 +1,148 @@
+#include "designerbench.h"
+#include <QtTest>
+#include "benchdata.h"
+#include "xmlconfig.h"
+#include "componentfactory.h"
+#include "mainwindow.h"
+
+void DesignerBench::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void DesignerBench::addSizes(const char *column, std::initializer_list<int> sizes)
+{
+    QTest::addColumn<int>(column);
+    for (int size : sizes) {
+        QTest::newRow(qPrintable(QString::number(size))) << size;
+    }
+}
+
+QString DesignerBench::writeConfig(int variables)
+{
+    QString fileName = m_dir.filePath(QString("config_%1.xml").arg(variables));
+    if (!QFile::exists(fileName)) {
+        BenchData::writeFile(fileName, BenchData::variableConfig(variables));
+    }
+    return fileName;
+}
+
+QString DesignerBench::writeLibrary(int components)
+{
+    QString fileName = m_dir.filePath(QString("components_%1.xml").arg(components));
+    if (!QFile::exists(fileName)) {
+        BenchData::writeFile(fileName, BenchData::componentLibrary(components));
+    }
+    return fileName;
+}
+
+QString DesignerBench::writeScene(int items)
+{
+    QString fileName = m_dir.filePath(QString("scene_%1.json").arg(items));
+    if (!QFile::exists(fileName)) {
+        BenchData::writeFile(fileName, BenchData::sceneJson(items));
+    }
+    return fileName;
+}
+
+void DesignerBench::loadConfig_data()
+{
+    addSizes("variables", { 100, 1000, 10000 });
+}
+
+void DesignerBench::loadConfig()
+{
+    QFETCH(int, variables);
+    QString fileName = writeConfig(variables);
+
+    XmlConfig config;
+    QBENCHMARK {
+        QVERIFY(config.loadConfig(fileName));
+    }
+    QCOMPARE(config.getAvailableVariables().size(), variables);
+}
+
+void DesignerBench::saveConfig_data()
+{
+    addSizes("variables", { 100, 1000, 10000 });
+}
+
+void DesignerBench::saveConfig()
+{
+    QFETCH(int, variables);
+
+    XmlConfig config;
+    QVERIFY(config.loadConfig(writeConfig(variables)));
+    QString fileName = m_dir.filePath("saved_config.xml");
+    QBENCHMARK {
+        QVERIFY(config.saveConfig(fileName));
+    }
+}
+
+void DesignerBench::createComponent_data()
+{
+    addSizes("components", { 10, 100, 1000 });
+}
+
+void DesignerBench::createComponent()
+{
+    QFETCH(int, components);
+    QVERIFY(ComponentFactory::loadComponentLibrary(writeLibrary(components)));
+
+    QString type = QString("C%1").arg(components - 1);
+    QBENCHMARK {
+        QGraphicsItem *item = ComponentFactory::createComponent(type, QPointF(100, 100));
+        QVERIFY(item);
+        delete item;
+    }
+}
+
+void DesignerBench::createComponentIcon_data()
+{
+    addSizes("components", { 10, 100, 1000 });
+}
+
+void DesignerBench::createComponentIcon()
+{
+    QFETCH(int, components);
+    QVERIFY(ComponentFactory::loadComponentLibrary(writeLibrary(components)));
+
+    QString type = QString("C%1").arg(components - 1);
+    QBENCHMARK {
+        QIcon icon = ComponentFactory::createComponentIcon(type);
+        QVERIFY(!icon.isNull());
+    }
+}
+
+void DesignerBench::saveToFile_data()
+{
+    addSizes("items", { 100, 1000, 10000 });
+}
+
+void DesignerBench::saveToFile()
+{
+    QFETCH(int, items);
+
+    MainWindow window;
+    QVERIFY(window.loadScene(writeScene(items)));
+    QString fileName = m_dir.filePath("saved_scene.json");
+    QBENCHMARK {
+        QVERIFY(window.saveScene(fileName));
+    }
+}
+
+void DesignerBench::openFromFile_data()
+{
+    addSizes("items", { 100, 1000, 10000 });
+}
+
+void DesignerBench::openFromFile()
+{
+    QFETCH(int, items);
+
+    MainWindow window;
+    QString fileName = writeScene(items);
+    QBENCHMARK {
+        QVERIFY(window.loadScene(fileName));
+    }
+}
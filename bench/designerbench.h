@@ -0,0 +1,44 @@
+#ifndef DESIGNERBENCH_H
+#define DESIGNERBENCH_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+/**
+ * @brief 设计器热点路径的基准测试
+ */
+class DesignerBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // XmlConfig::loadConfig / saveConfig
+    void loadConfig_data();
+    void loadConfig();
+    void saveConfig_data();
+    void saveConfig();
+
+    // ComponentFactory::createComponent / createComponentIcon（查找组件库中最后一个组件）
+    void createComponent_data();
+    void createComponent();
+    void createComponentIcon_data();
+    void createComponentIcon();
+
+    // MainWindow::saveToFile / openFromFile 的文件读写部分
+    void saveToFile_data();
+    void saveToFile();
+    void openFromFile_data();
+    void openFromFile();
+
+private:
+    void addSizes(const char *column, std::initializer_list<int> sizes);
+    QString writeConfig(int variables);
+    QString writeLibrary(int components);
+    QString writeScene(int items);
+
+    QTemporaryDir m_dir;    // 生成的输入文件
+};
+
+#endif // DESIGNERBENCH_H
@@ -0,0 +1,33 @@
+#include <QApplication>
+#include <QtTest>
+#include <QDir>
+#include "runtimebench.h"
+#include "designerbench.h"
+
+int main(int argc, char *argv[])
+{
+    // 没有显示器的构建机上也能运行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication a(argc, argv);
+
+    // 结果目录：BENCH_OUTPUT_DIR，默认为当前目录下的bench-results
+    QString outputDir = qEnvironmentVariable("BENCH_OUTPUT_DIR", "bench-results");
+    QDir().mkpath(outputDir);
+
+    RuntimeBench runtimeBench;
+    DesignerBench designerBench;
+    QList<QObject *> benches = { &runtimeBench, &designerBench };
+
+    // 每个测试类输出一个XML结果文件，同时在终端输出文本结果
+    int failures = 0;
+    for (QObject *bench : benches) {
+        QStringList args = a.arguments();
+        QString resultFile = QDir(outputDir).filePath(
+            QString("%1.xml").arg(bench->metaObject()->className()));
+        args << "-o" << resultFile + ",xml" << "-o" << "-,txt";
+        failures += QTest::qExec(bench, args);
+    }
+    return failures;
+}
@@ -0,0 +1,148 @@
+#include "runtimebench.h"
+#include <QtTest>
+#include <QtMqtt/QMqttTopicName>
+#include "benchdata.h"
+#include "mqttcomm.h"
+#include "runtimeviewer.h"
+#include "scenefile.h"
+
+namespace {
+
+// 不连接任何服务器，构造时的连接请求立即失败
+RuntimeOptions offlineOptions()
+{
+    RuntimeOptions options;
+    options.brokerHost = "127.0.0.1";
+    options.brokerPort = 1;
+    options.headless = true;
+    return options;
+}
+
+}
+
+void RuntimeBench::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void RuntimeBench::handleMessage_data()
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<int>("samples");
+    QTest::addColumn<int>("addresses");
+
+    const QString formats[] = {"json", "cbor", "packed", "sparkplug"};
+    const int sizes[][2] = {{1, 100}, {10, 100}, {100, 1000}, {1000, 10000}, {10000, 10000}};
+    for (const QString &format : formats) {
+        for (const auto &size : sizes) {
+            QTest::newRow(qPrintable(QString("%1/%2x%3").arg(format).arg(size[0]).arg(size[1])))
+                << format << size[0] << size[1];
+        }
+    }
+}
+
+void RuntimeBench::handleMessage()
+{
+    QFETCH(QString, format);
+    QFETCH(int, samples);
+    QFETCH(int, addresses);
+
+    TagTable tags;
+    MqttComm comm(&tags);
+    bool sparkplug = format == "sparkplug";
+    const QString topicName = sparkplug ? "spBv1.0/bench/NDATA/node" : "scada/values";
+    QVector<int> boundTags;
+    for (int addr = 0; addr < addresses; ++addr) {
+        boundTags.append(tags.intern(topicName, QString::number(addr)));
+    }
+    comm.setTags(boundTags);
+    QVector<int> changed;
+
+    // Sparkplug B先处理NBIRTH建立别名表，之后的报文只按别名查找
+    if (sparkplug) {
+        comm.handleMessage(BenchData::sparkplugBirth(addresses), QMqttTopicName("spBv1.0/bench/NBIRTH/node"));
+        tags.takeChanged(&changed);
+    }
+
+    // 两条报文交替处理，每轮的值都与上一轮不同
+    auto encode = format == "cbor" ? BenchData::cborValuesMessage
+                : format == "packed" ? BenchData::packedValuesMessage
+                : sparkplug ? BenchData::sparkplugData
+                : BenchData::valuesMessage;
+    const QByteArray messages[2] = {
+        encode(samples, addresses, 1),
+        encode(samples, addresses, 2)
+    };
+    const QMqttTopicName topic(topicName);
+    int round = 0;
+
+    QBENCHMARK {
+        comm.handleMessage(messages[round++ & 1], topic);
+        tags.takeChanged(&changed);
+    }
+    QCOMPARE(changed.size(), qMin(samples, addresses));
+}
+
+void RuntimeBench::loadScene_data()
+{
+    QTest::addColumn<int>("items");
+    QTest::addColumn<bool>("compiled");
+
+    for (int items : { 100, 1000, 10000 }) {
+        QTest::newRow(qPrintable(QString("json/%1").arg(items))) << items << false;
+        QTest::newRow(qPrintable(QString("scnb/%1").arg(items))) << items << true;
+    }
+}
+
+void RuntimeBench::loadScene()
+{
+    QFETCH(int, items);
+    QFETCH(bool, compiled);
+
+    QString jsonFile = m_dir.filePath(QString("scene_%1.json").arg(items));
+    QVERIFY(BenchData::writeFile(jsonFile, BenchData::sceneJson(items)));
+    QString sceneFile = jsonFile;
+    if (compiled) {
+        QString errorString;
+        sceneFile = m_dir.filePath(QString("scene_%1.scnb").arg(items));
+        QVERIFY2(SceneFile::compile(jsonFile, sceneFile, &errorString), qPrintable(errorString));
+    }
+
+    // 场景只在构造时加载，每次迭代构造新的查看器（包含创建数据源的开销）
+    int itemCount = 0;
+    QBENCHMARK {
+        RuntimeViewer viewer(sceneFile, offlineOptions());
+        itemCount = viewer.sceneItemCount();
+    }
+    QCOMPARE(itemCount, items);
+}
+
+void RuntimeBench::handleValueChanged_data()
+{
+    QTest::addColumn<int>("items");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void RuntimeBench::handleValueChanged()
+{
+    QFETCH(int, items);
+
+    QString sceneFile = m_dir.filePath(QString("scene_%1.json").arg(items));
+    QVERIFY(BenchData::writeFile(sceneFile, BenchData::sceneJson(items)));
+    RuntimeViewer viewer(sceneFile, offlineOptions());
+    int tagCount = viewer.tags().size();
+    QVERIFY(tagCount > 0);
+
+    // 每轮使用新值，保证每个组件的文本都发生变化
+    double value = 0;
+    QBENCHMARK {
+        value += 1.5;
+        for (int tag = 0; tag < tagCount; ++tag) {
+            TagValue sample = TagValue::fromDouble(value + tag);
+            viewer.handleValueChanged(tag, sample.convert(TagDouble, viewer.tags().type(tag)));
+        }
+    }
+}
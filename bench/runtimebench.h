@@ -0,0 +1,33 @@
+#ifndef RUNTIMEBENCH_H
+#define RUNTIMEBENCH_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+/**
+ * @brief 运行时热点路径的基准测试
+ */
+class RuntimeBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // MqttComm::handleMessage：解码报文并更新变量表
+    void handleMessage_data();
+    void handleMessage();
+
+    // 构造RuntimeViewer并加载场景：JSON场景和编译场景
+    void loadScene_data();
+    void loadScene();
+
+    // RuntimeViewer::handleValueChanged：刷新所有绑定组件一次
+    void handleValueChanged_data();
+    void handleValueChanged();
+
+private:
+    QTemporaryDir m_dir;    // 生成的场景文件
+};
+
+#endif // RUNTIMEBENCH_H
@@ -0,0 +1,247 @@
+#include "asynclogger.h"
+#include <QThread>
+#include <QFile>
+#include <QTime>
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <cstdio>
+
+namespace AsyncLogger {
+
+namespace {
+
+/**
+ * @brief 有界多生产者单消费者队列
+ * 每个槽位带序号，生产者用CAS领取位置，写完后发布序号，消费者按序号判断槽位是否可读
+ */
+class MessageQueue
+{
+public:
+    explicit MessageQueue(int capacity)
+        : m_mask(0)
+        , m_enqueue(0)
+        , m_dequeue(0)
+    {
+        int size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_data = new Slot[size];
+        for (int i = 0; i < size; ++i) {
+            m_data[i].sequence.store(uint(i));
+        }
+    }
+
+    ~MessageQueue()
+    {
+        delete[] m_data;
+    }
+
+    bool push(QByteArray &&line)
+    {
+        uint position = m_enqueue.load();
+        for (;;) {
+            Slot &slot = m_data[position & m_mask];
+            int diff = int(slot.sequence.loadAcquire() - position);
+            if (diff == 0) {
+                if (m_enqueue.testAndSetRelaxed(position, position + 1, position)) {
+                    slot.line = std::move(line);
+                    slot.sequence.storeRelease(position + 1);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // 队列已满
+            } else {
+                position = m_enqueue.load();
+            }
+        }
+    }
+
+    // 只由写线程调用，写线程退出后才可由fatal处理取出剩余消息
+    bool pop(QByteArray *line)
+    {
+        Slot &slot = m_data[m_dequeue & m_mask];
+        if (int(slot.sequence.loadAcquire() - (m_dequeue + 1)) < 0) {
+            return false;
+        }
+        *line = std::move(slot.line);
+        slot.line = QByteArray();
+        slot.sequence.storeRelease(m_dequeue + m_mask + 1);
+        ++m_dequeue;
+        return true;
+    }
+
+private:
+    struct Slot {
+        QAtomicInteger<uint> sequence;
+        QByteArray line;
+    };
+
+    Q_DISABLE_COPY(MessageQueue)
+
+    Slot *m_data;
+    uint m_mask;
+    QAtomicInteger<uint> m_enqueue;     // 下一个写入位置（多个生产者竞争）
+    uint m_dequeue;                     // 下一个读取位置（只有写线程使用）
+};
+
+/**
+ * @brief 日志写线程
+ */
+class WriterThread : public QThread
+{
+public:
+    WriterThread(MessageQueue *queue, FILE *output)
+        : m_queue(queue)
+        , m_output(output)
+        , m_stop(0)
+    {
+        setObjectName("AsyncLogger");
+    }
+
+    void stop() { m_stop.store(1); }
+
+protected:
+    void run() override
+    {
+        QByteArray line;
+        for (;;) {
+            bool wrote = false;
+            while (m_queue->pop(&line)) {
+                fwrite(line.constData(), 1, size_t(line.size()), m_output);
+                wrote = true;
+            }
+            if (wrote) {
+                fflush(m_output);
+            }
+            if (m_stop.load()) {
+                // 退出前再取一次，避免丢掉停止之前写入的消息
+                if (!m_queue->pop(&line)) {
+                    break;
+                }
+                fwrite(line.constData(), 1, size_t(line.size()), m_output);
+                continue;
+            }
+            // 队列空时短暂休眠，生产者不需要唤醒写线程
+            msleep(10);
+        }
+        fflush(m_output);
+    }
+
+private:
+    MessageQueue *m_queue;
+    FILE *m_output;
+    QAtomicInteger<int> m_stop;
+};
+
+MessageQueue *g_queue = nullptr;
+WriterThread *g_writer = nullptr;
+FILE *g_output = nullptr;
+QtMessageHandler g_previousHandler = nullptr;
+QAtomicInteger<int> g_dropped(0);
+
+const char *levelName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return "D";
+    case QtInfoMsg: return "I";
+    case QtWarningMsg: return "W";
+    case QtCriticalMsg: return "C";
+    case QtFatalMsg: return "F";
+    }
+    return "?";
+}
+
+QByteArray formatLine(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    QByteArray line;
+    line.reserve(message.size() + 64);
+    line.append(QTime::currentTime().toString("hh:mm:ss.zzz").toLatin1());
+    line.append(' ');
+    line.append(levelName(type));
+    line.append(' ');
+    if (context.category && qstrcmp(context.category, "default") != 0) {
+        line.append(context.category);
+        line.append(": ");
+    }
+    line.append(message.toUtf8());
+    line.append('\n');
+    return line;
+}
+
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    QByteArray line = formatLine(type, context, message);
+
+    // fatal之后进程立即终止，必须同步写出；先停止写线程并写出队列中之前的消息，
+    // 写线程退出后由当前线程取队列，不会与它同时消费
+    if (type == QtFatalMsg) {
+        g_writer->stop();
+        if (QThread::currentThread() != g_writer) {
+            g_writer->wait();
+        }
+        QByteArray pending;
+        while (g_queue->pop(&pending)) {
+            fwrite(pending.constData(), 1, size_t(pending.size()), g_output);
+        }
+        fwrite(line.constData(), 1, size_t(line.size()), g_output);
+        fflush(g_output);
+        return;
+    }
+
+    if (!g_queue->push(std::move(line))) {
+        g_dropped.ref();
+    }
+}
+
+}
+
+bool install(const QString &fileName, int capacity)
+{
+    if (g_queue) {
+        return true;
+    }
+
+    g_output = stderr;
+    if (!fileName.isEmpty()) {
+        FILE *file = fopen(QFile::encodeName(fileName).constData(), "a");
+        if (!file) {
+            return false;
+        }
+        g_output = file;
+    }
+
+    g_queue = new MessageQueue(qMax(16, capacity));
+    g_writer = new WriterThread(g_queue, g_output);
+    g_writer->start(QThread::LowPriority);
+    g_previousHandler = qInstallMessageHandler(messageHandler);
+    return true;
+}
+
+void shutdown()
+{
+    if (!g_queue) {
+        return;
+    }
+
+    qInstallMessageHandler(g_previousHandler);
+    g_writer->stop();
+    g_writer->wait();
+
+    int dropped = g_dropped.load();
+    if (dropped > 0) {
+        fprintf(g_output, "%d log messages dropped (queue full)\n", dropped);
+    }
+    if (g_output != stderr) {
+        fclose(g_output);
+    }
+
+    delete g_writer;
+    delete g_queue;
+    g_writer = nullptr;
+    g_queue = nullptr;
+    g_output = nullptr;
+}
+
+}
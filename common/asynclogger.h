@@ -0,0 +1,23 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <QString>
+
+/**
+ * @brief 异步日志
+ * 接管Qt的消息输出：调用线程只格式化一行文本并写入无锁队列，
+ * 由后台线程写到标准错误或日志文件，磁盘和终端的延迟不会阻塞界面和采集线程。
+ * 级别过滤由QLoggingCategory完成，被关闭的级别在qCDebug等宏处直接跳过，不计算参数。
+ * 队列满时丢弃新消息并计数，fatal消息同步输出
+ */
+namespace AsyncLogger {
+
+// 安装消息处理函数并启动写线程，fileName为空时写到标准错误
+bool install(const QString &fileName = QString(), int capacity = 8192);
+
+// 写出队列中剩余的消息并停止写线程，恢复默认的消息处理函数
+void shutdown();
+
+}
+
+#endif // ASYNCLOGGER_H
@@ -0,0 +1,8 @@
+#include "logcategories.h"
+
+Q_LOGGING_CATEGORY(lcMqtt, "scada.mqtt", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcModbus, "scada.modbus", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcRuntime, "scada.runtime", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcConfig, "scada.config", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcComponents, "scada.components", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcDesigner, "scada.designer", QtInfoMsg)
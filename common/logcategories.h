@@ -0,0 +1,15 @@
+#ifndef LOGCATEGORIES_H
+#define LOGCATEGORIES_H
+
+#include <QLoggingCategory>
+
+// 日志分类，默认只输出info及以上级别，
+// 调试输出用QT_LOGGING_RULES或运行时的--log-rules打开，例如 "scada.mqtt.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcMqtt)          // scada.mqtt：MQTT连接、订阅和报文
+Q_DECLARE_LOGGING_CATEGORY(lcModbus)        // scada.modbus：Modbus TCP连接和轮询
+Q_DECLARE_LOGGING_CATEGORY(lcRuntime)       // scada.runtime：运行时场景和显示刷新
+Q_DECLARE_LOGGING_CATEGORY(lcConfig)        // scada.config：变量配置
+Q_DECLARE_LOGGING_CATEGORY(lcComponents)    // scada.components：组件库和组件设计器
+Q_DECLARE_LOGGING_CATEGORY(lcDesigner)      // scada.designer：设计器界面
+
+#endif // LOGCATEGORIES_H
@@ -0,0 +1,204 @@
+#include "trace.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <chrono>
+
+namespace Trace {
+
+QBasicAtomicInt g_enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+
+const int kChunkSize = 65536;       // 每块的记录数
+const int kMaxChunks = 64;          // 每个线程最多的块数，超出后丢弃新记录
+
+struct Event {
+    const char *name;
+    qint64 start;
+    qint64 end;
+};
+
+/**
+ * @brief 单个线程的记录缓冲区
+ * 只由所属线程写入；写入记录后以release方式发布计数，导出时以acquire方式读取
+ */
+struct ThreadBuffer {
+    ThreadBuffer()
+        : count(0)
+        , generation(0)
+        , dropped(0)
+        , tid(0)
+    {
+        for (int i = 0; i < kMaxChunks; ++i) {
+            chunks[i].store(nullptr);
+        }
+    }
+
+    QAtomicPointer<Event> chunks[kMaxChunks];
+    QAtomicInteger<int> count;
+    QAtomicInteger<int> generation; // 缓冲区对应的记录轮次
+    QAtomicInteger<int> dropped;
+    int tid;
+    QByteArray threadName;
+};
+
+QMutex g_mutex;                         // 保护缓冲区列表
+QVector<ThreadBuffer *> g_buffers;      // 所有线程的缓冲区（线程结束后保留到导出）
+QAtomicInteger<int> g_generation(0);    // 每次开始记录时加一，各线程据此清空自己的缓冲区
+QAtomicInteger<qint64> g_origin(0);     // 本轮记录的时间起点
+
+ThreadBuffer *threadBuffer()
+{
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (!buffer) {
+        buffer = new ThreadBuffer;
+        QMutexLocker locker(&g_mutex);
+        buffer->tid = g_buffers.size() + 1;
+        g_buffers.append(buffer);
+    }
+    return buffer;
+}
+
+QByteArray jsonEscape(const char *text)
+{
+    QByteArray escaped;
+    for (const char *p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') {
+            escaped.append('\\');
+        }
+        escaped.append(*p);
+    }
+    return escaped;
+}
+
+}
+
+void setEnabled(bool enabled)
+{
+    if (enabled && !isEnabled()) {
+        g_origin.store(now());
+        g_generation.ref();
+    }
+    g_enabled.store(enabled ? 1 : 0);
+}
+
+qint64 now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void record(const char *name, qint64 start, qint64 end)
+{
+    ThreadBuffer *buffer = threadBuffer();
+
+    // 新一轮记录开始后丢弃本线程之前的内容
+    int generation = g_generation.load();
+    if (buffer->generation.load() != generation) {
+        buffer->count.storeRelease(0);
+        buffer->dropped.store(0);
+        buffer->generation.store(generation);
+    }
+
+    int index = buffer->count.load();
+    int chunkIndex = index / kChunkSize;
+    if (chunkIndex >= kMaxChunks) {
+        buffer->dropped.store(buffer->dropped.load() + 1);
+        return;
+    }
+    Event *chunk = buffer->chunks[chunkIndex].load();
+    if (!chunk) {
+        chunk = new Event[kChunkSize];
+        buffer->chunks[chunkIndex].storeRelease(chunk);
+    }
+    chunk[index % kChunkSize] = { name, start, end };
+    buffer->count.storeRelease(index + 1);
+}
+
+void setThreadName(const char *name)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    QMutexLocker locker(&g_mutex);
+    buffer->threadName = name;
+}
+
+bool writeChromeTrace(const QString &fileName, QString *errorString)
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+
+    qint64 pid = QCoreApplication::applicationPid();
+    qint64 origin = g_origin.load();
+    int generation = g_generation.load();
+
+    QByteArray json("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    QMutexLocker locker(&g_mutex);
+    for (ThreadBuffer *buffer : g_buffers) {
+        if (!buffer->threadName.isEmpty()) {
+            json.append(first ? "" : ",\n");
+            first = false;
+            json.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":");
+            json.append(QByteArray::number(pid));
+            json.append(",\"tid\":");
+            json.append(QByteArray::number(buffer->tid));
+            json.append(",\"args\":{\"name\":\"");
+            json.append(jsonEscape(buffer->threadName.constData()));
+            json.append("\"}}");
+        }
+
+        // 还没有进入本轮的线程，缓冲区中是上一轮的内容
+        if (buffer->generation.load() != generation) {
+            continue;
+        }
+        int count = buffer->count.loadAcquire();
+        for (int i = 0; i < count; ++i) {
+            const Event &event = buffer->chunks[i / kChunkSize].loadAcquire()[i % kChunkSize];
+            json.append(first ? "" : ",\n");
+            first = false;
+            // 完整事件：ts和dur的单位为微秒
+            json.append("{\"name\":\"");
+            json.append(jsonEscape(event.name));
+            json.append("\",\"cat\":\"scada\",\"ph\":\"X\",\"ts\":");
+            json.append(QByteArray::number((event.start - origin) / 1000.0, 'f', 3));
+            json.append(",\"dur\":");
+            json.append(QByteArray::number((event.end - event.start) / 1000.0, 'f', 3));
+            json.append(",\"pid\":");
+            json.append(QByteArray::number(pid));
+            json.append(",\"tid\":");
+            json.append(QByteArray::number(buffer->tid));
+            json.append('}');
+
+            if (json.size() > 1024 * 1024) {
+                file.write(json);
+                json.clear();
+            }
+        }
+        if (buffer->dropped.load() > 0) {
+            qWarning("Trace buffer full, %d spans dropped on thread %d",
+                     buffer->dropped.load(), buffer->tid);
+        }
+    }
+    json.append("\n]}\n");
+    file.write(json);
+
+    if (!file.commit()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,74 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QAtomicInt>
+
+/**
+ * @brief 性能跟踪
+ * 用TRACE_SCOPE在函数或代码块中记录一段耗时，导出为Chrome trace_event格式的JSON，
+ * 可在chrome://tracing或Perfetto中查看。
+ * 运行时用Trace::setEnabled开关，关闭时每个跟踪点只有一次原子读；
+ * 定义SCADA_NO_TRACE后所有跟踪点在编译期完全去掉。
+ * 记录写入各线程自己的缓冲区，不加锁
+ */
+namespace Trace {
+
+// 是否正在记录（热路径上内联检查）
+extern QBasicAtomicInt g_enabled;
+inline bool isEnabled() { return g_enabled.load() != 0; }
+
+// 开始或停止记录，开始时清除之前的记录
+void setEnabled(bool enabled);
+
+// 单调时钟（纳秒）
+qint64 now();
+
+// 记录一段耗时，name必须是静态字符串
+void record(const char *name, qint64 start, qint64 end);
+
+// 为当前线程命名，在跟踪视图中显示
+void setThreadName(const char *name);
+
+// 写出已记录的内容（Chrome trace_event JSON），记录可以仍在进行
+bool writeChromeTrace(const QString &fileName, QString *errorString = nullptr);
+
+/**
+ * @brief 作用域跟踪点，构造时开始、析构时结束
+ */
+class Span
+{
+public:
+    explicit Span(const char *name)
+        : m_name(isEnabled() ? name : nullptr)
+        , m_start(m_name ? now() : 0)
+    {
+    }
+
+    ~Span()
+    {
+        if (m_name) {
+            record(m_name, m_start, now());
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(Span)
+
+    const char *m_name;
+    qint64 m_start;
+};
+
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#ifndef SCADA_NO_TRACE
+#define TRACE_SCOPE(name) Trace::Span TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) (void)0
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,38 @@
+#include "bindingtable.h"
+
+BindingTable::BindingTable()
+{
+}
+
+void BindingTable::clear()
+{
+    m_pending.clear();
+    m_offsets.clear();
+    m_bindings.clear();
+}
+
+void BindingTable::add(int tag, const ValueBinding &binding)
+{
+    m_pending.append(qMakePair(tag, binding));
+}
+
+void BindingTable::compile(int tagCount)
+{
+    // 计数排序：先统计每个变量的绑定数，再按偏移放置
+    m_offsets.fill(0, tagCount + 1);
+    for (const auto &entry : m_pending) {
+        ++m_offsets[entry.first + 1];
+    }
+    for (int tag = 0; tag < tagCount; ++tag) {
+        m_offsets[tag + 1] += m_offsets.at(tag);
+    }
+
+    m_bindings.resize(m_pending.size());
+    QVector<int> cursor = m_offsets;
+    for (const auto &entry : m_pending) {
+        m_bindings[cursor[entry.first]++] = entry.second;
+    }
+
+    m_pending.clear();
+    m_pending.squeeze();
+}
@@ -0,0 +1,60 @@
+#ifndef BINDINGTABLE_H
+#define BINDINGTABLE_H
+
+#include <QVector>
+#include <QPair>
+
+class ValueDisplayItem;
+
+/**
+ * @brief 数值显示格式
+ */
+struct ValueFormat {
+    char format = 'f';      // QString::number的格式字符
+    int precision = 1;      // 小数位数
+};
+
+/**
+ * @brief 一个图形组件与变量的绑定
+ */
+struct ValueBinding {
+    ValueDisplayItem *display;  // 显示数值的组件
+    ValueFormat format;         // 显示格式
+};
+
+/**
+ * @brief 编译后的绑定表
+ * 加载场景时登记绑定，compile后按变量ID存放为连续数组，
+ * 数值变化时只访问绑定到该变量的组件
+ */
+class BindingTable
+{
+public:
+    BindingTable();
+
+    // 清空绑定
+    void clear();
+
+    // 登记一个绑定（加载期间调用）
+    void add(int tag, const ValueBinding &binding);
+
+    // 按变量ID整理为连续数组，tagCount为变量总数
+    void compile(int tagCount);
+
+    // 绑定到指定变量的组件范围 [begin, end)
+    inline const ValueBinding *begin(int tag) const { return m_bindings.constData() + m_offsets.at(tag); }
+    inline const ValueBinding *end(int tag) const { return m_bindings.constData() + m_offsets.at(tag + 1); }
+
+    // 变量总数
+    int tagCount() const { return m_offsets.isEmpty() ? 0 : m_offsets.size() - 1; }
+
+    // 绑定总数
+    int size() const { return m_bindings.size(); }
+
+private:
+    QVector<QPair<int, ValueBinding>> m_pending;    // 尚未整理的绑定
+    QVector<int> m_offsets;                         // 每个变量在m_bindings中的起始位置
+    QVector<ValueBinding> m_bindings;               // 按变量ID排列的绑定
+};
+
+#endif // BINDINGTABLE_H
@@ -0,0 +1,509 @@
+#include "cborvaluedecoder.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const int kMaxDepth = 64;   // 跳过未知字段时允许的最大嵌套深度
+
+// 主类型
+enum {
+    MajorUnsigned = 0,
+    MajorNegative = 1,
+    MajorBytes = 2,
+    MajorText = 3,
+    MajorArray = 4,
+    MajorMap = 5,
+    MajorTag = 6,
+    MajorSimple = 7
+};
+
+const quint8 kIndefinite = 31;  // 附加信息：不定长
+const uchar kBreak = 0xff;      // 不定长项的结束标记
+
+inline bool keyEquals(const char *key, int size, const char *literal, int literalSize)
+{
+    return size == literalSize && memcmp(key, literal, size) == 0;
+}
+
+// 地址取值规则与JSON解码器一致：超出int范围或不是整数时取0
+int toAddress(TagValue addr, TagType type)
+{
+    if (type == TagInt) {
+        return (addr.i >= -2147483647LL - 1 && addr.i <= 2147483647LL) ? int(addr.i) : 0;
+    }
+    return (addr.d >= -2147483648.0 && addr.d <= 2147483647.0
+            && int(addr.d) == addr.d) ? int(addr.d) : 0;
+}
+
+// 半精度浮点数（RFC 8949 附录D）
+double halfToDouble(quint16 half)
+{
+    int exponent = (half >> 10) & 0x1f;
+    int mantissa = half & 0x3ff;
+    double value;
+    if (exponent == 0) {
+        value = std::ldexp(double(mantissa), -24);
+    } else if (exponent != 31) {
+        value = std::ldexp(double(mantissa + 1024), exponent - 25);
+    } else {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity()
+                              : std::numeric_limits<double>::quiet_NaN();
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+} // namespace
+
+CborValueDecoder::CborValueDecoder()
+    : m_begin(nullptr)
+    , m_pos(nullptr)
+    , m_end(nullptr)
+    , m_sink(nullptr)
+{
+}
+
+bool CborValueDecoder::decode(const QByteArray &payload, ValueSink *sink)
+{
+    m_begin = reinterpret_cast<const uchar *>(payload.constData());
+    m_pos = m_begin;
+    m_end = m_begin + payload.size();
+    m_sink = sink;
+    reset();
+
+    // 可选的自描述标签55799（0xd9d9f7）
+    if (m_end - m_pos >= 3 && m_pos[0] == 0xd9 && m_pos[1] == 0xd9 && m_pos[2] == 0xf7) {
+        m_pos += 3;
+    }
+
+    if (!parseRoot()) {
+        return false;
+    }
+    if (m_pos != m_end) {
+        return fail("garbage at the end of the document");
+    }
+    return true;
+}
+
+bool CborValueDecoder::parseRoot()
+{
+    Head head;
+    if (!readHead(&head)) {
+        return false;
+    }
+    if (head.major != MajorMap) {
+        return fail("document is not a map");
+    }
+
+    for (quint64 i = 0; head.info == kIndefinite || i < head.argument; ++i) {
+        if (head.info == kIndefinite && atBreak()) {
+            break;
+        }
+
+        // 非文本的键连同其值一起跳过
+        if (m_pos != m_end && (*m_pos >> 5) != MajorText) {
+            if (!skipItem(1) || !skipItem(1)) {
+                return false;
+            }
+            continue;
+        }
+
+        const char *key;
+        int keySize;
+        if (!readText(&key, &keySize)) {
+            return false;
+        }
+        if (keyEquals(key, keySize, "timestamp", 9)) {
+            if (!parseTimestamp()) {
+                return false;
+            }
+        } else if (keyEquals(key, keySize, "body", 4) && m_pos != m_end && (*m_pos >> 5) == MajorArray) {
+            if (!parseBody()) {
+                return false;
+            }
+        } else if (!skipItem(1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CborValueDecoder::parseTimestamp()
+{
+    if (m_pos == m_end) {
+        return fail("unexpected end of data");
+    }
+
+    // 文本原样传递，无符号整数按Unix毫秒转换为与JSON相同的数字文本
+    quint8 major = *m_pos >> 5;
+    if (major == MajorText) {
+        const char *value;
+        int valueSize;
+        if (!readText(&value, &valueSize)) {
+            return false;
+        }
+        m_sink->onTimestamp(value, valueSize);
+        return true;
+    }
+    if (major == MajorUnsigned) {
+        Head head;
+        if (!readHead(&head)) {
+            return false;
+        }
+        char digits[24];
+        m_sink->onTimestamp(digits, formatUnsigned(head.argument, digits));
+        return true;
+    }
+    return skipItem(1);
+}
+
+bool CborValueDecoder::parseBody()
+{
+    Head head;
+    if (!readHead(&head)) {
+        return false;
+    }
+    m_hasBody = true;
+
+    for (quint64 i = 0; head.info == kIndefinite || i < head.argument; ++i) {
+        if (head.info == kIndefinite && atBreak()) {
+            break;
+        }
+
+        quint8 major = m_pos != m_end ? quint8(*m_pos >> 5) : quint8(MajorSimple);
+        if (major == MajorMap || major == MajorArray) {
+            Head entry;
+            if (!readHead(&entry)) {
+                return false;
+            }
+            bool ok = major == MajorMap ? parseEntryMap(entry) : parseEntryArray(entry);
+            if (!ok) {
+                return false;
+            }
+        } else if (!skipItem(1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CborValueDecoder::parseEntryMap(const Head &head)
+{
+    // 与JSON解码器一致：缺失或非法时取0
+    TagValue addr = TagValue::fromInt(0);
+    TagType addrType = TagInt;
+    TagValue value = TagValue::fromDouble(0.0);
+    TagType type = TagDouble;
+
+    for (quint64 i = 0; head.info == kIndefinite || i < head.argument; ++i) {
+        if (head.info == kIndefinite && atBreak()) {
+            break;
+        }
+
+        if (m_pos != m_end && (*m_pos >> 5) != MajorText) {
+            if (!skipItem(2) || !skipItem(2)) {
+                return false;
+            }
+            continue;
+        }
+
+        const char *key;
+        int keySize;
+        if (!readText(&key, &keySize)) {
+            return false;
+        }
+
+        bool isNumber;
+        if (keyEquals(key, keySize, "addr", 4)) {
+            TagValue number;
+            TagType numberType;
+            if (!parseNumber(&number, &numberType, &isNumber)) {
+                return false;
+            }
+            if (isNumber && numberType != TagBool) {
+                addr = number;
+                addrType = numberType;
+            }
+        } else if (keyEquals(key, keySize, "val", 3)) {
+            TagValue number;
+            TagType numberType;
+            if (!parseNumber(&number, &numberType, &isNumber)) {
+                return false;
+            }
+            if (isNumber) {
+                value = number;
+                type = numberType;
+            }
+        } else if (!skipItem(2)) {
+            return false;
+        }
+    }
+
+    m_sink->onSample(toAddress(addr, addrType), value, type);
+    ++m_sampleCount;
+    return true;
+}
+
+bool CborValueDecoder::parseEntryArray(const Head &head)
+{
+    // [addr, val]，多出的元素忽略
+    TagValue addr = TagValue::fromInt(0);
+    TagType addrType = TagInt;
+    TagValue value = TagValue::fromDouble(0.0);
+    TagType type = TagDouble;
+
+    for (quint64 i = 0; head.info == kIndefinite || i < head.argument; ++i) {
+        if (head.info == kIndefinite && atBreak()) {
+            break;
+        }
+
+        if (i >= 2) {
+            if (!skipItem(2)) {
+                return false;
+            }
+            continue;
+        }
+
+        TagValue number;
+        TagType numberType;
+        bool isNumber;
+        if (!parseNumber(&number, &numberType, &isNumber)) {
+            return false;
+        }
+        if (!isNumber) {
+            continue;
+        }
+        if (i == 0 && numberType != TagBool) {
+            addr = number;
+            addrType = numberType;
+        } else if (i == 1) {
+            value = number;
+            type = numberType;
+        }
+    }
+
+    m_sink->onSample(toAddress(addr, addrType), value, type);
+    ++m_sampleCount;
+    return true;
+}
+
+bool CborValueDecoder::parseNumber(TagValue *value, TagType *type, bool *isNumber)
+{
+    *isNumber = false;
+
+    // 标签不改变数值本身，直接解开
+    while (m_pos != m_end && (*m_pos >> 5) == MajorTag) {
+        Head tag;
+        if (!readHead(&tag)) {
+            return false;
+        }
+    }
+    if (m_pos == m_end) {
+        return fail("unexpected end of data");
+    }
+
+    // 字符串、数组、映射不是数值，整体跳过
+    quint8 major = *m_pos >> 5;
+    if (major != MajorUnsigned && major != MajorNegative && major != MajorSimple) {
+        return skipItem(2);
+    }
+
+    Head head;
+    if (!readHead(&head)) {
+        return false;
+    }
+
+    switch (head.major) {
+    case MajorUnsigned:
+        if (head.argument <= quint64(std::numeric_limits<qint64>::max())) {
+            *value = TagValue::fromInt(qint64(head.argument));
+            *type = TagInt;
+        } else {
+            *value = TagValue::fromDouble(double(head.argument));
+            *type = TagDouble;
+        }
+        break;
+    case MajorNegative:
+        // 数值为 -1 - argument
+        if (head.argument <= quint64(std::numeric_limits<qint64>::max())) {
+            *value = TagValue::fromInt(qint64(-1) - qint64(head.argument));
+            *type = TagInt;
+        } else {
+            *value = TagValue::fromDouble(-1.0 - double(head.argument));
+            *type = TagDouble;
+        }
+        break;
+    default:
+        switch (head.info) {
+        case 20:
+        case 21:
+            *value = TagValue::fromBool(head.info == 21);
+            *type = TagBool;
+            break;
+        case 25:
+            *value = TagValue::fromDouble(halfToDouble(quint16(head.argument)));
+            *type = TagDouble;
+            break;
+        case 26: {
+            quint32 bits = quint32(head.argument);
+            float single;
+            memcpy(&single, &bits, sizeof(single));
+            *value = TagValue::fromDouble(double(single));
+            *type = TagDouble;
+            break;
+        }
+        case 27: {
+            double number;
+            memcpy(&number, &head.argument, sizeof(number));
+            *value = TagValue::fromDouble(number);
+            *type = TagDouble;
+            break;
+        }
+        case kIndefinite:
+            --m_pos;
+            return fail("unexpected break");
+        default:
+            // null、undefined等不是数值
+            return true;
+        }
+        break;
+    }
+    *isNumber = true;
+    return true;
+}
+
+bool CborValueDecoder::readHead(Head *head)
+{
+    if (m_pos == m_end) {
+        return fail("unexpected end of data");
+    }
+    uchar initial = *m_pos++;
+    head->major = initial >> 5;
+    head->info = initial & 0x1f;
+
+    if (head->info < 24) {
+        head->argument = head->info;
+        return true;
+    }
+    if (head->info == kIndefinite) {
+        // 只有字符串、数组、映射可以不定长；主类型7的31是结束标记，由调用者处理
+        if (head->major == MajorUnsigned || head->major == MajorNegative || head->major == MajorTag) {
+            --m_pos;
+            return fail("illegal indefinite length");
+        }
+        head->argument = 0;
+        return true;
+    }
+    if (head->info > 27) {
+        --m_pos;
+        return fail("illegal additional information");
+    }
+
+    int size = 1 << (head->info - 24);
+    if (m_end - m_pos < size) {
+        return fail("unexpected end of data");
+    }
+    quint64 argument = 0;
+    for (int i = 0; i < size; ++i) {
+        argument = (argument << 8) | m_pos[i];
+    }
+    m_pos += size;
+    head->argument = argument;
+    return true;
+}
+
+bool CborValueDecoder::readText(const char **begin, int *size)
+{
+    Head head;
+    if (!readHead(&head)) {
+        return false;
+    }
+    if (head.major != MajorText || head.info == kIndefinite) {
+        return fail("expected a definite-length text string");
+    }
+    if (head.argument > quint64(m_end - m_pos)) {
+        return fail("unexpected end of data");
+    }
+    *begin = reinterpret_cast<const char *>(m_pos);
+    *size = int(head.argument);
+    m_pos += head.argument;
+    return true;
+}
+
+bool CborValueDecoder::atBreak()
+{
+    if (m_pos != m_end && *m_pos == kBreak) {
+        ++m_pos;
+        return true;
+    }
+    return false;
+}
+
+bool CborValueDecoder::skipItem(int depth)
+{
+    if (depth > kMaxDepth) {
+        return fail("too deeply nested");
+    }
+
+    Head head;
+    if (!readHead(&head)) {
+        return false;
+    }
+
+    switch (head.major) {
+    case MajorUnsigned:
+    case MajorNegative:
+        return true;
+    case MajorBytes:
+    case MajorText:
+        if (head.info == kIndefinite) {
+            while (!atBreak()) {
+                Head chunk;
+                if (!readHead(&chunk)) {
+                    return false;
+                }
+                if (chunk.major != head.major || chunk.info == kIndefinite
+                        || chunk.argument > quint64(m_end - m_pos)) {
+                    return fail("illegal string chunk");
+                }
+                m_pos += chunk.argument;
+            }
+            return true;
+        }
+        if (head.argument > quint64(m_end - m_pos)) {
+            return fail("unexpected end of data");
+        }
+        m_pos += head.argument;
+        return true;
+    case MajorArray:
+    case MajorMap: {
+        int perEntry = head.major == MajorMap ? 2 : 1;
+        for (quint64 i = 0; head.info == kIndefinite || i < head.argument; ++i) {
+            if (head.info == kIndefinite && atBreak()) {
+                break;
+            }
+            for (int j = 0; j < perEntry; ++j) {
+                if (!skipItem(depth + 1)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    case MajorTag:
+        return skipItem(depth + 1);
+    default:
+        if (head.info == kIndefinite) {
+            --m_pos;
+            return fail("unexpected break");
+        }
+        return true;
+    }
+}
+
+bool CborValueDecoder::fail(const char *error)
+{
+    m_error = error;
+    m_errorOffset = int(m_pos - m_begin);
+    return false;
+}
@@ -0,0 +1,46 @@
+#ifndef CBORVALUEDECODER_H
+#define CBORVALUEDECODER_H
+
+#include "valuedecoder.h"
+
+/**
+ * @brief CBOR数据报文的流式解码器
+ * 结构与JSON报文相同：{"timestamp": 文本或Unix毫秒, "body": [{"addr": 整数, "val": 数值}]}，
+ * body中的数据点也可以写成两个元素的数组 [addr, val]。
+ * 整数为TagInt，true/false为TagBool，半精度/单精度/双精度浮点数为TagDouble；
+ * 支持定长和不定长的数组与映射，未知的键和标签直接跳过
+ */
+class CborValueDecoder : public ValueDecoder
+{
+public:
+    CborValueDecoder();
+
+    bool decode(const QByteArray &payload, ValueSink *sink) override;
+
+private:
+    // 数据项的头部
+    struct Head {
+        quint8 major;       // 主类型（0~7）
+        quint8 info;        // 附加信息，31表示不定长
+        quint64 argument;   // 长度、整数值或浮点数的原始位
+    };
+
+    bool parseRoot();
+    bool parseTimestamp();
+    bool parseBody();
+    bool parseEntryMap(const Head &head);
+    bool parseEntryArray(const Head &head);
+    bool parseNumber(TagValue *value, TagType *type, bool *isNumber);
+    bool readHead(Head *head);
+    bool readText(const char **begin, int *size);
+    bool atBreak();
+    bool skipItem(int depth);
+    bool fail(const char *error);
+
+    const uchar *m_begin;   // 报文起始
+    const uchar *m_pos;     // 当前扫描位置
+    const uchar *m_end;     // 报文结束
+    ValueSink *m_sink;      // 结果接收者
+};
+
+#endif // CBORVALUEDECODER_H
@@ -0,0 +1,132 @@
+#include "datasource.h"
+#include "trace.h"
+
+DataSource::DataSource(TagTable *tags, QObject *parent)
+    : QObject(parent)
+    , m_tags(tags)
+    , m_latency(nullptr)
+    , m_messageTime(0)
+    , m_messageChanges(0)
+    , m_ring(nullptr)
+    , m_backlogTimer(new QTimer(this))
+    , m_wakeRequested(false)
+    , m_receivedMessages(0)
+    , m_receivedSamples(0)
+    , m_receiveTime(0)
+    , m_decodeErrors(0)
+    , m_unknownAddresses(0)
+    , m_connected(0)
+{
+    m_backlogTimer->setSingleShot(true);
+    m_backlogTimer->setInterval(5);
+    connect(m_backlogTimer, &QTimer::timeout, this, &DataSource::flushBacklog);
+}
+
+void DataSource::setSampleRing(SampleRing *ring)
+{
+    m_ring = ring;
+}
+
+void DataSource::setLatencyTracker(LatencyTracker *latency)
+{
+    m_latency = latency;
+}
+
+void DataSource::beginMessage()
+{
+    m_messageTime = Trace::now();
+    m_messageChanges = 0;
+}
+
+void DataSource::finishMessage(int samples, qint64 sourceTime, qint64 receiveTime)
+{
+    m_receivedMessages.store(m_receivedMessages.load() + 1);
+    m_receivedSamples.store(m_receivedSamples.load() + samples);
+
+    if (m_latency && samples > 0) {
+        m_latency->recordMessage(sourceTime, receiveTime, LatencyTracker::wallClockUs(),
+                                 samples, m_messageChanges);
+    }
+
+    // 整条报文处理完再唤醒界面线程，延迟记录先于数据点被取走
+    wakeIfRequested();
+}
+
+void DataSource::failMessage()
+{
+    m_decodeErrors.store(m_decodeErrors.load() + 1);
+    wakeIfRequested();
+}
+
+void DataSource::wakeIfRequested()
+{
+    if (m_wakeRequested) {
+        m_wakeRequested = false;
+        emit samplesReady();
+    }
+}
+
+void DataSource::applySample(int tag, TagValue decoded, TagType decodedType)
+{
+    // 转换为变量配置的类型，类型相同时不做任何转换
+    TagValue value = decoded.convert(decodedType, m_tags->type(tag));
+
+    // 采集线程模式下只入队，变量表由界面线程更新
+    if (m_ring) {
+        markChanged();
+        pushSample(tag, value);
+        return;
+    }
+
+    // 更新值，同一帧内的多次变化只保留最新值
+    if (m_tags->update(tag, value)) {
+        markChanged();
+        emit valuesChanged();
+    }
+}
+
+void DataSource::pushSample(int tag, TagValue value)
+{
+    // 已有暂存数据时也先暂存，避免新值被之后补发的旧值覆盖
+    if (m_backlogTags.isEmpty() && m_ring->push({tag, value})) {
+        if (m_ring->requestWake()) {
+            m_wakeRequested = true;
+        }
+        return;
+    }
+
+    if (tag >= m_backlogged.size()) {
+        m_backlogged.resize(m_tags->size());
+        m_backlogValues.resize(m_tags->size());
+    }
+    m_backlogValues[tag] = value;
+    if (!m_backlogged.at(tag)) {
+        m_backlogged[tag] = true;
+        m_backlogTags.append(tag);
+    }
+
+    if (!m_backlogTimer->isActive()) {
+        m_backlogTimer->start();
+    }
+}
+
+void DataSource::flushBacklog()
+{
+    int flushed = 0;
+    while (flushed < m_backlogTags.size()) {
+        int tag = m_backlogTags.at(flushed);
+        if (!m_ring->push({tag, m_backlogValues.at(tag)})) {
+            break;
+        }
+        m_backlogged[tag] = false;
+        ++flushed;
+    }
+    m_backlogTags.remove(0, flushed);
+    if (flushed > 0 && m_ring->requestWake()) {
+        emit samplesReady();
+    }
+
+    if (!m_backlogTags.isEmpty()) {
+        m_backlogTimer->start();
+    }
+}
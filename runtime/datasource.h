@@ -0,0 +1,116 @@
+#ifndef DATASOURCE_H
+#define DATASOURCE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <QAtomicInteger>
+#include "tagtable.h"
+#include "samplering.h"
+#include "latencytracker.h"
+
+/**
+ * @brief 数据源
+ * 各协议采集驱动的公共基类：数据点按变量的类型写入变量表，同一帧内的多次变化只保留最新值；
+ * 采集线程模式下写入环形队列，队列满时按变量合并暂存。
+ * 多个数据源共用一个变量表，每个数据源只写自己负责的变量。
+ * 环形队列只允许一个生产者，采集线程模式下所有数据源运行在同一个采集线程中
+ */
+class DataSource : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DataSource(TagTable *tags, QObject *parent = nullptr);
+
+    // 开始采集，在数据源所在的线程中调用
+    virtual void start() = 0;
+
+    // 采集线程模式：数据点写入环形队列，由界面线程取出后更新变量表。
+    // 必须在登记变量之后、moveToThread之前调用
+    void setSampleRing(SampleRing *ring);
+
+    // 设置端到端延迟统计，接收和解码完成时记录，必须在moveToThread之前调用
+    void setLatencyTracker(LatencyTracker *latency);
+
+    // 累计收到的报文数和数据点数（可在其他线程读取）
+    qint64 receivedMessages() const { return m_receivedMessages.load(); }
+    qint64 receivedSamples() const { return m_receivedSamples.load(); }
+
+    // 累计解码失败的报文数、地址未映射的数据点数（可在其他线程读取）
+    qint64 decodeErrors() const { return m_decodeErrors.load(); }
+    qint64 unknownAddresses() const { return m_unknownAddresses.load(); }
+
+    // 当前是否已连接（可在其他线程读取）
+    bool isConnected() const { return m_connected.load() != 0; }
+
+    // 取出并清除上次取出之后第一条产生变化的报文的接收时间（Trace::now），没有时返回0。
+    // 可在其他线程调用
+    qint64 takeReceiveTime() { return m_receiveTime.fetchAndStoreRelaxed(0); }
+
+signals:
+    // 变量表中出现新的变化时发出（变化被取走前只发一次）
+    void valuesChanged();
+
+    // 采集线程模式下队列中有新数据时发出（被取走前只发一次）
+    void samplesReady();
+
+protected:
+    // 开始处理一条报文：记录接收时间，清零变化计数
+    void beginMessage();
+
+    // 报文处理完：累计计数、记录延迟（sourceTime为系统时间微秒，-1表示没有），
+    // 需要时唤醒界面线程
+    void finishMessage(int samples, qint64 sourceTime, qint64 receiveTime);
+
+    // 报文解码失败：计数，出错之前已写入的数据点照常唤醒界面线程
+    void failMessage();
+
+    // 按变量的类型写入一个数据点，调用方已确认变量属于本数据源
+    void applySample(int tag, TagValue value, TagType type);
+
+    // 计数（只由采集线程写，不需要原子的读-改-写）
+    inline void countUnknownAddress() { m_unknownAddresses.store(m_unknownAddresses.load() + 1); }
+    inline void setConnected(bool connected) { m_connected.store(connected ? 1 : 0); }
+
+    TagTable *m_tags;               // 变量表
+    LatencyTracker *m_latency;      // 端到端延迟统计
+
+private slots:
+    // 队列满时暂存的数据点重新写入队列
+    void flushBacklog();
+
+private:
+    // 写入环形队列，队列满时按变量合并暂存
+    void pushSample(int tag, TagValue value);
+
+    // 报文处理完后按需唤醒界面线程
+    void wakeIfRequested();
+
+    // 当前报文产生了一个变化：记录接收时间（已有未取走的时间时保留更早的）并计数
+    inline void markChanged()
+    {
+        ++m_messageChanges;
+        if (m_receiveTime.load() == 0) {
+            m_receiveTime.store(m_messageTime);
+        }
+    }
+
+    qint64 m_messageTime;                       // 当前报文的接收时间
+    int m_messageChanges;                       // 当前报文产生的变化个数
+
+    SampleRing *m_ring;                         // 采集线程模式下的输出队列
+    QVector<int> m_backlogTags;                 // 队列满时暂存的变量ID
+    QVector<TagValue> m_backlogValues;          // 暂存变量的最新值
+    QVector<bool> m_backlogged;                 // 变量是否已在暂存列表中
+    QTimer *m_backlogTimer;                     // 暂存数据的重试定时器
+    bool m_wakeRequested;                       // 报文处理完后需要唤醒界面线程
+
+    QAtomicInteger<qint64> m_receivedMessages;  // 累计报文数（只由采集线程写）
+    QAtomicInteger<qint64> m_receivedSamples;   // 累计数据点数（只由采集线程写）
+    QAtomicInteger<qint64> m_receiveTime;       // 尚未显示的最早接收时间
+    QAtomicInteger<qint64> m_decodeErrors;      // 累计解码失败的报文数（只由采集线程写）
+    QAtomicInteger<qint64> m_unknownAddresses;  // 累计地址未映射的数据点数（只由采集线程写）
+    QAtomicInt m_connected;                     // 是否已连接
+};
+
+#endif // DATASOURCE_H
@@ -0,0 +1,529 @@
+#include "jsonvaluedecoder.h"
+#include <cstring>
+
+namespace {
+
+// 精确可表示的10的幂（Clinger快速路径）
+const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+const int kMaxDepth = 64;   // 跳过未知字段时允许的最大嵌套深度
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// 比较键名，带转义的键名边还原边比较（要匹配的字段名都是ASCII，还原出非ASCII字符即不相等）
+bool keyEquals(const char *key, int size, bool escaped, const char *literal, int literalSize)
+{
+    if (!escaped) {
+        return size == literalSize && memcmp(key, literal, size) == 0;
+    }
+
+    int length = 0;
+    for (int i = 0; i < size; ++i) {
+        char c = key[i];
+        if (c == '\\') {
+            if (++i == size) {
+                return false;
+            }
+            switch (key[i]) {
+            case '"':
+            case '\\':
+            case '/':
+                c = key[i];
+                break;
+            case 'b':
+                c = '\b';
+                break;
+            case 'f':
+                c = '\f';
+                break;
+            case 'n':
+                c = '\n';
+                break;
+            case 'r':
+                c = '\r';
+                break;
+            case 't':
+                c = '\t';
+                break;
+            case 'u': {
+                if (size - i <= 4) {
+                    return false;
+                }
+                int code = 0;
+                for (int j = 1; j <= 4; ++j) {
+                    int digit = hexValue(key[i + j]);
+                    if (digit < 0) {
+                        return false;
+                    }
+                    code = code * 16 + digit;
+                }
+                if (code >= 0x80) {
+                    return false;
+                }
+                c = char(code);
+                i += 4;
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        if (length == literalSize || c != literal[length]) {
+            return false;
+        }
+        ++length;
+    }
+    return length == literalSize;
+}
+
+} // namespace
+
+JsonValueDecoder::JsonValueDecoder()
+    : m_begin(nullptr)
+    , m_pos(nullptr)
+    , m_end(nullptr)
+    , m_sink(nullptr)
+    , m_escaped(false)
+{
+}
+
+bool JsonValueDecoder::decode(const QByteArray &payload, ValueSink *sink)
+{
+    m_begin = payload.constData();
+    m_pos = m_begin;
+    m_end = m_begin + payload.size();
+    m_sink = sink;
+    reset();
+
+    if (!parseRoot()) {
+        return false;
+    }
+
+    skipWhitespace();
+    if (m_pos != m_end) {
+        return fail("garbage at the end of the document");
+    }
+    return true;
+}
+
+bool JsonValueDecoder::parseRoot()
+{
+    skipWhitespace();
+    if (m_pos == m_end || *m_pos != '{') {
+        return fail("document is not an object");
+    }
+    ++m_pos;
+
+    skipWhitespace();
+    if (m_pos != m_end && *m_pos == '}') {
+        ++m_pos;
+        return true;
+    }
+
+    for (;;) {
+        const char *key;
+        int keySize;
+        skipWhitespace();
+        if (!parseString(&key, &keySize)) {
+            return false;
+        }
+        bool escaped = m_escaped;
+        skipWhitespace();
+        if (m_pos == m_end || *m_pos != ':') {
+            return fail("missing name separator");
+        }
+        ++m_pos;
+        skipWhitespace();
+
+        if (keyEquals(key, keySize, escaped, "timestamp", 9) && m_pos != m_end && *m_pos == '"') {
+            const char *value;
+            int valueSize;
+            if (!parseString(&value, &valueSize)) {
+                return false;
+            }
+            m_sink->onTimestamp(value, valueSize);
+        } else if (keyEquals(key, keySize, escaped, "body", 4) && m_pos != m_end && *m_pos == '[') {
+            if (!parseBody()) {
+                return false;
+            }
+        } else if (!skipValue(0)) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (m_pos == m_end) {
+            return fail("unterminated object");
+        }
+        if (*m_pos == '}') {
+            ++m_pos;
+            return true;
+        }
+        if (*m_pos != ',') {
+            return fail("missing value separator");
+        }
+        ++m_pos;
+    }
+}
+
+bool JsonValueDecoder::parseBody()
+{
+    m_hasBody = true;
+    ++m_pos;  // '['
+
+    skipWhitespace();
+    if (m_pos != m_end && *m_pos == ']') {
+        ++m_pos;
+        return true;
+    }
+
+    for (;;) {
+        skipWhitespace();
+        if (m_pos != m_end && *m_pos == '{') {
+            if (!parseEntry()) {
+                return false;
+            }
+        } else if (!skipValue(1)) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (m_pos == m_end) {
+            return fail("unterminated array");
+        }
+        if (*m_pos == ']') {
+            ++m_pos;
+            return true;
+        }
+        if (*m_pos != ',') {
+            return fail("missing value separator");
+        }
+        ++m_pos;
+    }
+}
+
+bool JsonValueDecoder::parseEntry()
+{
+    ++m_pos;  // '{'
+
+    // 与QJsonValue::toInt()/toDouble()一致：缺失或非法时取0
+    int addr = 0;
+    TagValue value = TagValue::fromDouble(0.0);
+    TagType type = TagDouble;
+
+    skipWhitespace();
+    if (m_pos != m_end && *m_pos == '}') {
+        ++m_pos;
+        m_sink->onSample(addr, value, type);
+        ++m_sampleCount;
+        return true;
+    }
+
+    for (;;) {
+        const char *key;
+        int keySize;
+        skipWhitespace();
+        if (!parseString(&key, &keySize)) {
+            return false;
+        }
+        bool escaped = m_escaped;
+        skipWhitespace();
+        if (m_pos == m_end || *m_pos != ':') {
+            return fail("missing name separator");
+        }
+        ++m_pos;
+        skipWhitespace();
+
+        bool isNumber = m_pos != m_end && (*m_pos == '-' || isDigit(*m_pos));
+        if (keyEquals(key, keySize, escaped, "addr", 4) && isNumber) {
+            TagValue number;
+            TagType numberType;
+            if (!parseNumber(&number, &numberType)) {
+                return false;
+            }
+            if (numberType == TagInt) {
+                addr = (number.i >= -2147483647LL - 1 && number.i <= 2147483647LL) ? int(number.i) : 0;
+            } else {
+                addr = (number.d >= -2147483648.0 && number.d <= 2147483647.0
+                        && int(number.d) == number.d) ? int(number.d) : 0;
+            }
+        } else if (keyEquals(key, keySize, escaped, "val", 3) && isNumber) {
+            if (!parseNumber(&value, &type)) {
+                return false;
+            }
+        } else if (keyEquals(key, keySize, escaped, "val", 3) && m_pos != m_end && (*m_pos == 't' || *m_pos == 'f')) {
+            // 开关量直接取为TagBool
+            bool isTrue = *m_pos == 't';
+            if (!skipValue(2)) {
+                return false;
+            }
+            value = TagValue::fromBool(isTrue);
+            type = TagBool;
+        } else if (!skipValue(2)) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (m_pos == m_end) {
+            return fail("unterminated object");
+        }
+        if (*m_pos == '}') {
+            ++m_pos;
+            break;
+        }
+        if (*m_pos != ',') {
+            return fail("missing value separator");
+        }
+        ++m_pos;
+    }
+
+    m_sink->onSample(addr, value, type);
+    ++m_sampleCount;
+    return true;
+}
+
+bool JsonValueDecoder::parseString(const char **begin, int *size)
+{
+    if (m_pos == m_end || *m_pos != '"') {
+        return fail("expected string");
+    }
+    ++m_pos;
+    const char *start = m_pos;
+
+    // 只定位结束引号，转义序列原样保留，需要时由调用方还原
+    m_escaped = false;
+    while (m_pos != m_end) {
+        char c = *m_pos;
+        if (c == '"') {
+            *begin = start;
+            *size = int(m_pos - start);
+            ++m_pos;
+            return true;
+        }
+        if (c == '\\') {
+            m_escaped = true;
+            ++m_pos;
+            if (m_pos == m_end) {
+                break;
+            }
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            return fail("control character in string");
+        }
+        ++m_pos;
+    }
+    return fail("unterminated string");
+}
+
+bool JsonValueDecoder::parseNumber(TagValue *value, TagType *type)
+{
+    const char *start = m_pos;
+    bool negative = false;
+    if (*m_pos == '-') {
+        negative = true;
+        ++m_pos;
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0;       // 计入尾数的有效数字个数
+    int exponent = 0;     // 十进制指数修正
+    bool integral = true; // 没有小数部分和指数部分
+
+    if (m_pos == m_end || !isDigit(*m_pos)) {
+        return fail("illegal number");
+    }
+    if (*m_pos == '0') {
+        ++m_pos;
+    } else {
+        while (m_pos != m_end && isDigit(*m_pos)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + quint64(*m_pos - '0');
+                ++digits;
+            } else {
+                ++exponent;
+            }
+            ++m_pos;
+        }
+    }
+
+    if (m_pos != m_end && *m_pos == '.') {
+        integral = false;
+        ++m_pos;
+        if (m_pos == m_end || !isDigit(*m_pos)) {
+            return fail("illegal number");
+        }
+        while (m_pos != m_end && isDigit(*m_pos)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + quint64(*m_pos - '0');
+                if (mantissa != 0) {
+                    ++digits;
+                }
+                --exponent;
+            }
+            ++m_pos;
+        }
+    }
+
+    if (m_pos != m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+        integral = false;
+        ++m_pos;
+        bool negativeExponent = false;
+        if (m_pos != m_end && (*m_pos == '+' || *m_pos == '-')) {
+            negativeExponent = *m_pos == '-';
+            ++m_pos;
+        }
+        if (m_pos == m_end || !isDigit(*m_pos)) {
+            return fail("illegal number");
+        }
+        int e = 0;
+        while (m_pos != m_end && isDigit(*m_pos)) {
+            if (e < 100000) {
+                e = e * 10 + (*m_pos - '0');
+            }
+            ++m_pos;
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+
+    // 整数直接取为64位整数，不经过浮点转换；"-0"按浮点数-0.0保留符号，与QJsonDocument一致
+    if (integral && exponent == 0 && !(negative && mantissa == 0)
+            && mantissa <= quint64(9223372036854775807LL) + (negative ? 1 : 0)) {
+        *value = TagValue::fromInt(negative ? qint64(0 - mantissa) : qint64(mantissa));
+        *type = TagInt;
+        return true;
+    }
+    *type = TagDouble;
+
+    // 快速路径：尾数不超过2^53且指数在精确范围内时结果与strtod一致
+    if (mantissa <= (quint64(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double result = double(mantissa);
+        result = exponent < 0 ? result / kPow10[-exponent] : result * kPow10[exponent];
+        *value = TagValue::fromDouble(negative ? -result : result);
+        return true;
+    }
+
+    // 罕见的长尾数/大指数回退到Qt的区域无关转换
+    bool ok = false;
+    *value = TagValue::fromDouble(QByteArray(start, int(m_pos - start)).toDouble(&ok));
+    if (!ok) {
+        return fail("illegal number");
+    }
+    return true;
+}
+
+bool JsonValueDecoder::skipValue(int depth)
+{
+    if (depth > kMaxDepth) {
+        return fail("too deeply nested document");
+    }
+
+    skipWhitespace();
+    if (m_pos == m_end) {
+        return fail("unexpected end of document");
+    }
+
+    switch (*m_pos) {
+    case '"': {
+        const char *s;
+        int size;
+        return parseString(&s, &size);
+    }
+    case '{':
+    case '[': {
+        char close = *m_pos == '{' ? '}' : ']';
+        bool isObject = close == '}';
+        ++m_pos;
+        skipWhitespace();
+        if (m_pos != m_end && *m_pos == close) {
+            ++m_pos;
+            return true;
+        }
+        for (;;) {
+            if (isObject) {
+                const char *key;
+                int keySize;
+                skipWhitespace();
+                if (!parseString(&key, &keySize)) {
+                    return false;
+                }
+                skipWhitespace();
+                if (m_pos == m_end || *m_pos != ':') {
+                    return fail("missing name separator");
+                }
+                ++m_pos;
+            }
+            if (!skipValue(depth + 1)) {
+                return false;
+            }
+            skipWhitespace();
+            if (m_pos == m_end) {
+                return fail("unterminated container");
+            }
+            if (*m_pos == close) {
+                ++m_pos;
+                return true;
+            }
+            if (*m_pos != ',') {
+                return fail("missing value separator");
+            }
+            ++m_pos;
+        }
+    }
+    case 't':
+        if (m_end - m_pos >= 4 && memcmp(m_pos, "true", 4) == 0) {
+            m_pos += 4;
+            return true;
+        }
+        return fail("illegal value");
+    case 'f':
+        if (m_end - m_pos >= 5 && memcmp(m_pos, "false", 5) == 0) {
+            m_pos += 5;
+            return true;
+        }
+        return fail("illegal value");
+    case 'n':
+        if (m_end - m_pos >= 4 && memcmp(m_pos, "null", 4) == 0) {
+            m_pos += 4;
+            return true;
+        }
+        return fail("illegal value");
+    default: {
+        TagValue ignored;
+        TagType ignoredType;
+        return parseNumber(&ignored, &ignoredType);
+    }
+    }
+}
+
+void JsonValueDecoder::skipWhitespace()
+{
+    while (m_pos != m_end
+           && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+        ++m_pos;
+    }
+}
+
+bool JsonValueDecoder::fail(const char *error)
+{
+    m_error = error;
+    m_errorOffset = int(m_pos - m_begin);
+    return false;
+}
@@ -0,0 +1,36 @@
+#ifndef JSONVALUEDECODER_H
+#define JSONVALUEDECODER_H
+
+#include "valuedecoder.h"
+
+/**
+ * @brief scada/values 报文的流式JSON解码器
+ * 直接在原始字节上单遍扫描 {timestamp, body:[{addr,val}]}，
+ * 不构造QJsonDocument，每个数据点不产生堆分配
+ */
+class JsonValueDecoder : public ValueDecoder
+{
+public:
+    JsonValueDecoder();
+
+    // 解码报文，逐个数据点回调sink；语法错误时返回false
+    bool decode(const QByteArray &payload, ValueSink *sink) override;
+
+private:
+    bool parseRoot();
+    bool parseBody();
+    bool parseEntry();
+    bool parseString(const char **begin, int *size);
+    bool parseNumber(TagValue *value, TagType *type);
+    bool skipValue(int depth);
+    void skipWhitespace();
+    bool fail(const char *error);
+
+    const char *m_begin;    // 报文起始
+    const char *m_pos;      // 当前扫描位置
+    const char *m_end;      // 报文结束
+    ValueSink *m_sink;      // 结果接收者
+    bool m_escaped;         // 最近一次parseString的字符串是否含转义序列
+};
+
+#endif // JSONVALUEDECODER_H
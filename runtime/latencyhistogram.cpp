@@ -0,0 +1,98 @@
+#include "latencyhistogram.h"
+#include <QtAlgorithms>
+
+LatencyHistogram::LatencyHistogram()
+    : m_total(0)
+    , m_sum(0)
+    , m_max(0)
+{
+}
+
+int LatencyHistogram::bucketIndex(qint64 value)
+{
+    if (value < kSubBucketCount) {
+        return value < 0 ? 0 : int(value);
+    }
+
+    // 小于32的数值精确记录，之后每个2的幂区间分为32个子桶
+    int exponent = 63 - int(qCountLeadingZeroBits(quint64(value)));
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    int shift = exponent - kSubBucketBits;
+    int subBucket = int(value >> shift) - kSubBucketCount;
+    return kSubBucketCount + shift * kSubBucketCount + subBucket;
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    int shift = (index - kSubBucketCount) / kSubBucketCount;
+    qint64 subBucket = (index - kSubBucketCount) % kSubBucketCount;
+    qint64 lower = (kSubBucketCount + subBucket) << shift;
+    return lower + (qint64(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 value, qint64 count)
+{
+    if (value < 0) {
+        value = 0;
+    }
+    QAtomicInteger<qint64> &bucket = m_counts[bucketIndex(value)];
+    bucket.store(bucket.load() + count);
+    m_total.store(m_total.load() + count);
+    m_sum.store(m_sum.load() + value * count);
+    if (value > m_max.load()) {
+        m_max.store(value);
+    }
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const
+{
+    LatencySnapshot snapshot;
+    snapshot.counts.resize(kBucketCount);
+    qint64 total = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        snapshot.counts[i] = m_counts[i].load();
+        total += snapshot.counts.at(i);
+    }
+    // 以各桶之和为准，记录线程同时写入时总数与桶计数保持一致
+    snapshot.total = total;
+    snapshot.sum = m_sum.load();
+    snapshot.max = m_max.load();
+    return snapshot;
+}
+
+qint64 LatencySnapshot::percentile(double percentile) const
+{
+    if (total == 0) {
+        return 0;
+    }
+    qint64 target = qint64(total * qBound(0.0, percentile, 100.0) / 100.0 + 0.5);
+    target = qBound(qint64(1), target, total);
+
+    qint64 seen = 0;
+    for (int i = 0; i < counts.size(); ++i) {
+        seen += counts.at(i);
+        if (seen >= target) {
+            return qMin(LatencyHistogram::bucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+double LatencySnapshot::fractionAtOrBelow(qint64 limit) const
+{
+    if (total == 0) {
+        return 1.0;
+    }
+    // 与limit同桶的记录按不超过处理，误差在桶宽度以内
+    int last = LatencyHistogram::bucketIndex(limit);
+    qint64 seen = 0;
+    for (int i = 0; i <= last && i < counts.size(); ++i) {
+        seen += counts.at(i);
+    }
+    return double(seen) / total;
+}
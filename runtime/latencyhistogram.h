@@ -0,0 +1,64 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QAtomicInteger>
+#include <QVector>
+
+/**
+ * @brief 延迟直方图的快照
+ * 只在读取方使用，提供百分位等统计
+ */
+struct LatencySnapshot {
+    QVector<qint64> counts;     // 各桶计数
+    qint64 total = 0;           // 记录总数
+    qint64 sum = 0;             // 数值合计（微秒）
+    qint64 max = 0;             // 最大值（微秒）
+
+    // 百分位对应的数值（桶的上界，微秒），percentile取0~100
+    qint64 percentile(double percentile) const;
+
+    // 不超过limit的记录所占比例（0~1）
+    double fractionAtOrBelow(qint64 limit) const;
+
+    double mean() const { return total > 0 ? double(sum) / total : 0.0; }
+};
+
+/**
+ * @brief HDR风格的延迟直方图（微秒）
+ * 桶按2的幂分段，每段再等分为32个子桶，任意数值的相对误差不超过约3%，
+ * 占用固定内存，记录只需一次位运算和一次计数。
+ * 只允许一个线程记录，其他线程可以随时取快照
+ */
+class LatencyHistogram
+{
+public:
+    static const int kSubBucketBits = 5;
+    static const int kSubBucketCount = 1 << kSubBucketBits;
+    static const int kMaxExponent = 40;     // 最大可记录约2^40微秒（12天）
+    static const int kBucketCount = kSubBucketCount * (kMaxExponent - kSubBucketBits + 2);
+
+    LatencyHistogram();
+
+    // 记录count个相同的数值
+    void record(qint64 value, qint64 count = 1);
+
+    // 取当前计数的快照（可在其他线程调用）
+    LatencySnapshot snapshot() const;
+
+    // 数值所在桶的序号
+    static int bucketIndex(qint64 value);
+
+    // 桶内的最大数值
+    static qint64 bucketUpperBound(int index);
+
+private:
+    Q_DISABLE_COPY(LatencyHistogram)
+
+    // 只有记录线程写，读-改-写不需要原子操作，原子类型只保证读取方看到完整的值
+    QAtomicInteger<qint64> m_counts[kBucketCount];
+    QAtomicInteger<qint64> m_total;
+    QAtomicInteger<qint64> m_sum;
+    QAtomicInteger<qint64> m_max;
+};
+
+#endif // LATENCYHISTOGRAM_H
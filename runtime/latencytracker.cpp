@@ -0,0 +1,166 @@
+#include "latencytracker.h"
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <chrono>
+
+LatencyTracker::LatencyTracker(int capacity)
+    : m_head(0)
+    , m_tail(0)
+    , m_dropped(0)
+    , m_paintTracking(true)
+    , m_skewed(0)
+    , m_invalid(0)
+{
+    int size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_stamps.resize(size);
+    m_slots = m_stamps.data();
+    m_mask = quint32(size - 1);
+    m_unpainted.reserve(256);
+}
+
+qint64 LatencyTracker::wallClockUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+qint64 LatencyTracker::parseTimestamp(const char *data, int size)
+{
+    // 常见格式为毫秒数，直接按数字解析
+    qint64 msecs = 0;
+    int i = 0;
+    for (; i < size && data[i] >= '0' && data[i] <= '9'; ++i) {
+        msecs = msecs * 10 + (data[i] - '0');
+    }
+    if (i == size && size > 0) {
+        return msecs * 1000;
+    }
+
+    QDateTime time = QDateTime::fromString(QString::fromLatin1(data, size), Qt::ISODateWithMs);
+    return time.isValid() ? time.toMSecsSinceEpoch() * 1000 : -1;
+}
+
+void LatencyTracker::record(Stage stage, qint64 sourceTime, qint64 now, qint64 count)
+{
+    qint64 latency = now - sourceTime;
+    if (latency < 0) {
+        m_skewed.ref();
+        latency = 0;
+    }
+    m_histograms[stage].record(latency, count);
+}
+
+void LatencyTracker::recordMessage(qint64 sourceTime, qint64 receiveTime, qint64 decodeTime,
+                                   int samples, int changed)
+{
+    if (sourceTime < 0) {
+        m_invalid.ref();
+        return;
+    }
+    record(Receive, sourceTime, receiveTime, samples);
+    record(Decode, sourceTime, decodeTime, samples);
+
+    if (changed == 0) {
+        return;
+    }
+
+    // 界面线程来不及取时丢弃，不阻塞接收线程
+    quint32 head = m_head.load();
+    if (head - m_tail.loadAcquire() > m_mask) {
+        m_dropped.ref();
+        return;
+    }
+    m_slots[head & m_mask] = { sourceTime, changed };
+    m_head.storeRelease(head + 1);
+}
+
+void LatencyTracker::dispatched()
+{
+    quint32 tail = m_tail.load();
+    quint32 head = m_head.loadAcquire();
+    if (tail == head) {
+        return;
+    }
+
+    qint64 now = wallClockUs();
+    for (; tail != head; ++tail) {
+        const MessageStamp &stamp = m_slots[tail & m_mask];
+        record(Dispatch, stamp.sourceTime, now, stamp.changed);
+        if (!m_paintTracking) {
+            continue;
+        }
+        // 窗口最小化等情况下长时间不绘制，超过队列容量后不再等待绘制
+        if (m_unpainted.size() > int(m_mask)) {
+            m_dropped.ref();
+            continue;
+        }
+        m_unpainted.append(stamp);
+    }
+    m_tail.storeRelease(tail);
+}
+
+void LatencyTracker::painted()
+{
+    qint64 now = wallClockUs();
+    for (const MessageStamp &stamp : m_unpainted) {
+        record(Paint, stamp.sourceTime, now, stamp.changed);
+    }
+    m_unpainted.clear();
+}
+
+const char *LatencyTracker::stageName(Stage stage)
+{
+    switch (stage) {
+    case Receive: return "receive";
+    case Decode: return "decode";
+    case Dispatch: return "dispatch";
+    case Paint: return "paint";
+    case StageCount: break;
+    }
+    return "?";
+}
+
+QString LatencyTracker::report(qint64 budgetUs) const
+{
+    QString text;
+    QTextStream out(&text);
+    out << QDateTime::currentDateTime().toString(Qt::ISODateWithMs)
+        << " latency from payload timestamp (ms), budget " << budgetUs / 1000.0 << " ms\n";
+    out << QString::asprintf("%-9s %12s %9s %9s %9s %9s %9s %9s %9s\n",
+                             "stage", "samples", "mean", "p50", "p90", "p99", "p99.9", "max", "in budget");
+    for (int stage = 0; stage < StageCount; ++stage) {
+        LatencySnapshot snapshot = m_histograms[stage].snapshot();
+        out << QString::asprintf("%-9s %12lld %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %8.3f%%\n",
+                                 stageName(Stage(stage)), snapshot.total,
+                                 snapshot.mean() / 1000.0,
+                                 snapshot.percentile(50) / 1000.0,
+                                 snapshot.percentile(90) / 1000.0,
+                                 snapshot.percentile(99) / 1000.0,
+                                 snapshot.percentile(99.9) / 1000.0,
+                                 snapshot.max / 1000.0,
+                                 snapshot.fractionAtOrBelow(budgetUs) * 100.0);
+    }
+    out << "dropped " << m_dropped.load()
+        << ", clock skew " << m_skewed.load()
+        << ", invalid timestamp " << m_invalid.load() << "\n";
+    out.flush();
+    return text;
+}
+
+bool LatencyTracker::writeReport(const QString &fileName, qint64 budgetUs, QString *errorString) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    file.write(report(budgetUs).toUtf8());
+    file.write("\n");
+    return true;
+}
@@ -0,0 +1,96 @@
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include <QAtomicInteger>
+#include <QString>
+#include <QVector>
+#include "latencyhistogram.h"
+
+/**
+ * @brief 端到端延迟统计
+ * 以报文中的timestamp（发布方的毫秒时间）为起点，分别统计数据点到达以下各阶段的延迟：
+ * 收到报文（receive）、解码完成（decode）、应用到组件（dispatch）和绘制到屏幕（paint）。
+ * receive和decode由接收线程按报文记录，数据点个数作为权重；
+ * 产生变化的报文通过单生产者/单消费者队列交给界面线程，
+ * 在应用和随后的绘制时分别记录dispatch和paint。
+ * 时间都取系统时间，发布方与运行时的时钟偏差会直接计入延迟
+ */
+class LatencyTracker
+{
+public:
+    enum Stage {
+        Receive,
+        Decode,
+        Dispatch,
+        Paint,
+        StageCount
+    };
+
+    explicit LatencyTracker(int capacity = 4096);
+
+    // 系统时间（微秒）
+    static qint64 wallClockUs();
+
+    // 解析报文时间戳：毫秒数，或ISO 8601时间。无法解析时返回-1
+    static qint64 parseTimestamp(const char *data, int size);
+
+    // 接收线程：记录一条报文，changed为产生变化的数据点个数
+    void recordMessage(qint64 sourceTime, qint64 receiveTime, qint64 decodeTime,
+                       int samples, int changed);
+
+    // 是否统计paint阶段（无窗口运行时不绘制，应关闭）
+    void setPaintTracking(bool enabled) { m_paintTracking = enabled; }
+
+    // 界面线程：本帧的变化已应用到组件
+    void dispatched();
+
+    // 界面线程：是否有已应用但尚未绘制的数据
+    bool hasUnpainted() const { return !m_unpainted.isEmpty(); }
+
+    // 界面线程：已应用的数据绘制完成
+    void painted();
+
+    // 各阶段的统计表，budgetUs为延迟预算
+    QString report(qint64 budgetUs) const;
+
+    // 把统计表追加写入文件
+    bool writeReport(const QString &fileName, qint64 budgetUs, QString *errorString = nullptr) const;
+
+    static const char *stageName(Stage stage);
+
+private:
+    Q_DISABLE_COPY(LatencyTracker)
+
+    static const int kCacheLineSize = 64;
+
+    /**
+     * @brief 产生变化的一条报文
+     */
+    struct MessageStamp {
+        qint64 sourceTime;  // 报文时间戳（微秒）
+        int changed;        // 产生变化的数据点个数
+    };
+
+    void record(Stage stage, qint64 sourceTime, qint64 now, qint64 count);
+
+    LatencyHistogram m_histograms[StageCount];
+
+    // 接收线程到界面线程的报文队列（单生产者/单消费者）
+    QVector<MessageStamp> m_stamps;
+    MessageStamp *m_slots;                          // 队列缓冲区首地址
+    quint32 m_mask;
+    // 读写位置之间隔一整条缓存行避免伪共享（不用alignas，原因见SampleRing）
+    char m_padMask[kCacheLineSize];
+    QAtomicInteger<quint32> m_head;                 // 接收线程写入位置
+    char m_padHead[kCacheLineSize];
+    QAtomicInteger<quint32> m_tail;                 // 界面线程读取位置
+    char m_padTail[kCacheLineSize];
+    QAtomicInteger<qint64> m_dropped;               // 队列满时丢弃的报文数
+
+    bool m_paintTracking;                           // 是否统计paint阶段
+    QVector<MessageStamp> m_unpainted;              // 已应用、等待绘制的报文（只在界面线程使用）
+    QAtomicInteger<qint64> m_skewed;                // 时间戳晚于接收时间的记录数（时钟偏差）
+    QAtomicInteger<qint64> m_invalid;               // 时间戳无法解析的报文数
+};
+
+#endif // LATENCYTRACKER_H
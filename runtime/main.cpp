@@ -1,31 +1,213 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QFileDialog>
 #include <QMessageBox>
 #include "runtimeviewer.h"
+#include "runtimeoptions.h"
+#include "scenefile.h"
+#include "trace.h"
+#include "asynclogger.h"
+#include "logcategories.h"
+#include <QLoggingCategory>
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QSysInfo>
+#include <cstring>
 
 int main(int argc, char *argv[])
 {
+    // 无窗口模式默认使用offscreen平台，须在创建QApplication之前设置
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0 && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
     QApplication a(argc, argv);
 
+    // 解析命令行参数
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("scene", QObject::tr("场景文件"));
+    QCommandLineOption hostOption("host",
+        QObject::tr("MQTT服务器地址"), "host", "mqtt.eclipseprojects.io");
+    parser.addOption(hostOption);
+    QCommandLineOption portOption("port",
+        QObject::tr("MQTT服务器端口"), "port", "1883");
+    parser.addOption(portOption);
+    QCommandLineOption clientIdOption("mqtt-client-id",
+        QObject::tr("MQTT客户端ID，指定后使用持久会话，重启后由服务器恢复订阅；默认由主机名、场景文件和进程号生成，使用新会话"), "id");
+    parser.addOption(clientIdOption);
+    QCommandLineOption cleanSessionOption("mqtt-clean-session",
+        QObject::tr("指定了客户端ID时也不使用持久会话，每次连接都重新订阅"));
+    parser.addOption(cleanSessionOption);
+    QCommandLineOption ingestThreadOption("ingest-thread",
+        QObject::tr("数据源的接收和解码在独立线程中运行"));
+    parser.addOption(ingestThreadOption);
+    QCommandLineOption wildcardOption("mqtt-wildcard-min",
+        QObject::tr("同一层级下的绑定主题达到该个数时改用通配符订阅，0表示不合并"), "topics", "16");
+    parser.addOption(wildcardOption);
+    QCommandLineOption modbusPollOption("modbus-poll-interval",
+        QObject::tr("Modbus轮询间隔（毫秒）"), "ms", "100");
+    parser.addOption(modbusPollOption);
+    QCommandLineOption modbusGapOption("modbus-max-gap",
+        QObject::tr("Modbus块读允许跨过的未绑定寄存器个数"), "registers", "0");
+    parser.addOption(modbusGapOption);
+    QCommandLineOption modbusPipelineOption("modbus-pipeline",
+        QObject::tr("每个Modbus连接上同时未返回的请求数上限"), "requests", "8");
+    parser.addOption(modbusPipelineOption);
+    QCommandLineOption maxFpsOption("max-fps",
+        QObject::tr("显示刷新的最高帧率"), "fps", "60");
+    parser.addOption(maxFpsOption);
+    QCommandLineOption fullUpdateOption("full-update",
+        QObject::tr("每帧重绘整个视图，不使用局部刷新"));
+    parser.addOption(fullUpdateOption);
+    QCommandLineOption compileOption("compile",
+        QObject::tr("将JSON场景编译为二进制场景后退出"), "output");
+    parser.addOption(compileOption);
+    QCommandLineOption headlessOption("headless",
+        QObject::tr("不显示窗口，只运行场景和MQTT数据处理"));
+    parser.addOption(headlessOption);
+    QCommandLineOption snapshotOption("snapshot",
+        QObject::tr("定时将场景渲染为PNG快照"), "file");
+    parser.addOption(snapshotOption);
+    QCommandLineOption snapshotIntervalOption("snapshot-interval",
+        QObject::tr("快照间隔（毫秒）"), "ms", "1000");
+    parser.addOption(snapshotIntervalOption);
+    QCommandLineOption snapshotSizeOption("snapshot-size",
+        QObject::tr("快照分辨率"), "WxH", "1920x1080");
+    parser.addOption(snapshotSizeOption);
+    QCommandLineOption traceOption("trace",
+        QObject::tr("启动时开始性能跟踪，F9停止/继续，停止和退出时写出Chrome跟踪文件"), "file");
+    parser.addOption(traceOption);
+    QCommandLineOption hudOption("hud",
+        QObject::tr("显示性能浮层（F10切换）"));
+    parser.addOption(hudOption);
+    QCommandLineOption latencyReportOption("latency-report",
+        QObject::tr("端到端延迟统计追加写入文件（F11、定时和退出时输出）"), "file");
+    parser.addOption(latencyReportOption);
+    QCommandLineOption latencyIntervalOption("latency-interval",
+        QObject::tr("定时输出延迟统计的间隔（秒）"), "seconds", "0");
+    parser.addOption(latencyIntervalOption);
+    QCommandLineOption latencyBudgetOption("latency-budget",
+        QObject::tr("显示延迟预算（毫秒）"), "ms", "250");
+    parser.addOption(latencyBudgetOption);
+    QCommandLineOption metricsFileOption("metrics-file",
+        QObject::tr("定时把运行指标写入文件（Prometheus文本格式）"), "file");
+    parser.addOption(metricsFileOption);
+    QCommandLineOption metricsIntervalOption("metrics-interval",
+        QObject::tr("指标文件的写入间隔（秒）"), "seconds", "10");
+    parser.addOption(metricsIntervalOption);
+    QCommandLineOption metricsPortOption("metrics-port",
+        QObject::tr("在本机的指定端口以HTTP导出运行指标（/metrics）"), "port");
+    parser.addOption(metricsPortOption);
+    QCommandLineOption logFileOption("log-file",
+        QObject::tr("日志写入文件（默认输出到标准错误）"), "file");
+    parser.addOption(logFileOption);
+    QCommandLineOption logRulesOption("log-rules",
+        QObject::tr("日志过滤规则，例如 \"scada.mqtt.debug=true\""), "rules");
+    parser.addOption(logRulesOption);
+    parser.process(a);
+
+    // 调试级别默认关闭，多条规则用分号分隔
+    if (parser.isSet(logRulesOption)) {
+        QLoggingCategory::setFilterRules(parser.value(logRulesOption).replace(';', '\n'));
+    }
+
+    RuntimeOptions options;
+    options.brokerHost = parser.value(hostOption);
+    options.brokerPort = quint16(parser.value(portOption).toUInt());
+    options.clientId = parser.value(clientIdOption);
+    // 持久会话只在客户端ID固定时有意义：每次启动都不同的默认ID会在服务器上留下无人认领的会话
+    options.cleanSession = parser.isSet(cleanSessionOption) || options.clientId.isEmpty();
+    options.ingestThread = parser.isSet(ingestThreadOption);
+    options.wildcardMinTopics = qMax(0, parser.value(wildcardOption).toInt());
+    options.modbusPollInterval = qMax(1, parser.value(modbusPollOption).toInt());
+    options.modbusMaxGap = qMax(0, parser.value(modbusGapOption).toInt());
+    options.modbusPipeline = qMax(1, parser.value(modbusPipelineOption).toInt());
+    options.maxFps = qMax(1, parser.value(maxFpsOption).toInt());
+    options.fullViewportUpdate = parser.isSet(fullUpdateOption);
+    options.headless = parser.isSet(headlessOption);
+    options.snapshotFile = parser.value(snapshotOption);
+    options.snapshotInterval = qMax(1, parser.value(snapshotIntervalOption).toInt());
+    options.traceFile = parser.value(traceOption);
+    options.showHud = parser.isSet(hudOption);
+    options.latencyReportFile = parser.value(latencyReportOption);
+    options.latencyReportInterval = qMax(0, parser.value(latencyIntervalOption).toInt());
+    options.latencyBudget = qMax(1, parser.value(latencyBudgetOption).toInt());
+    options.metricsFile = parser.value(metricsFileOption);
+    options.metricsInterval = qMax(1, parser.value(metricsIntervalOption).toInt());
+    options.metricsPort = quint16(parser.value(metricsPortOption).toUInt());
+    QStringList size = parser.value(snapshotSizeOption).split('x');
+    if (size.size() == 2 && size.at(0).toInt() > 0 && size.at(1).toInt() > 0) {
+        options.snapshotSize = QSize(size.at(0).toInt(), size.at(1).toInt());
+    } else {
+        qCWarning(lcRuntime) << "Invalid snapshot size:" << parser.value(snapshotSizeOption);
+        return 1;
+    }
+
     QString sceneFile;
-    if (argc > 1) {
+    if (!parser.positionalArguments().isEmpty()) {
         // 如果命令行提供了场景文件路径
-        sceneFile = argv[1];
+        sceneFile = parser.positionalArguments().first();
+    } else if (options.headless || parser.isSet(compileOption)) {
+        // 无窗口和编译模式必须在命令行指定场景文件
+        qCWarning(lcRuntime) << "No scene file specified";
+        return 1;
     } else {
         // 否则弹出文件选择对话框
         sceneFile = QFileDialog::getOpenFileName(nullptr,
             QObject::tr("打开场景文件"),
             "",
-            QObject::tr("JSON文件 (*.json);;所有文件 (*)"));
+            QObject::tr("场景文件 (*.json *.scnb);;所有文件 (*)"));
 
         if (sceneFile.isEmpty()) {
             return -1;
         }
     }
 
-    // 创建运行时视图并显示
-    RuntimeViewer viewer(sceneFile);
-    viewer.show();
+    // 编译模式：生成二进制场景，不启动运行时
+    if (parser.isSet(compileOption)) {
+        QString errorString;
+        if (!SceneFile::compile(sceneFile, parser.value(compileOption), &errorString)) {
+            qCWarning(lcRuntime) << "Compile scene failed:" << sceneFile << errorString;
+            return 1;
+        }
+        return 0;
+    }
+
+    // 默认的客户端ID由主机名、场景文件和进程号生成：同一场景开多个实例时ID不同，
+    // 不会互相踢下线。默认ID使用新会话，持久会话需用--mqtt-client-id指定固定ID
+    if (options.clientId.isEmpty()) {
+        QByteArray key = (QSysInfo::machineHostName() + '|'
+                          + QFileInfo(sceneFile).absoluteFilePath()).toUtf8();
+        options.clientId = QString("scada-rt-%1-%2")
+            .arg(QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex().left(12)))
+            .arg(QCoreApplication::applicationPid());
+    }
+
+    // 运行期间的日志由后台线程写出，不阻塞界面和采集线程
+    if (!AsyncLogger::install(parser.value(logFileOption))) {
+        AsyncLogger::install();
+        qCWarning(lcRuntime) << "Cannot open log file:" << parser.value(logFileOption);
+    }
+
+    // 在加载场景之前开始跟踪
+    if (!options.traceFile.isEmpty()) {
+        Trace::setThreadName("GUI");
+        Trace::setEnabled(true);
+    }
+
+    // 创建运行时视图并显示，视图析构时输出的日志也要在停止日志线程之前写出
+    int result;
+    {
+        RuntimeViewer viewer(sceneFile, options);
+        if (!options.headless) {
+            viewer.show();
+        }
+        result = a.exec();
+    }
 
-    return a.exec();
-} 
\ No newline at end of file
+    AsyncLogger::shutdown();
+    return result;
+}
@@ -0,0 +1,51 @@
+#include "metricsregistry.h"
+#include <QSaveFile>
+#include <cmath>
+
+void MetricsRegistry::add(Type type, const QString &name, const QString &help, std::function<double()> read)
+{
+    Metric metric;
+    metric.type = type;
+    metric.name = name.toLatin1();
+    metric.help = help.toUtf8();
+    metric.read = std::move(read);
+    m_metrics.append(metric);
+}
+
+QByteArray MetricsRegistry::prometheusText() const
+{
+    QByteArray text;
+    text.reserve(m_metrics.size() * 128);
+    for (const Metric &metric : m_metrics) {
+        text.append("# HELP ").append(metric.name).append(' ').append(metric.help).append('\n');
+        text.append("# TYPE ").append(metric.name)
+            .append(metric.type == Counter ? " counter\n" : " gauge\n");
+
+        double value = metric.read();
+        text.append(metric.name).append(' ');
+        // 整数值按整数输出，避免出现科学计数法
+        if (std::isnan(value)) {
+            text.append("NaN");
+        } else if (std::isinf(value)) {
+            text.append(value > 0 ? "+Inf" : "-Inf");
+        } else if (value == std::floor(value) && std::fabs(value) < 9e15) {
+            text.append(QByteArray::number(qint64(value)));
+        } else {
+            text.append(QByteArray::number(value, 'g', 17));
+        }
+        text.append('\n');
+    }
+    return text;
+}
+
+bool MetricsRegistry::writeTextFile(const QString &fileName, QString *errorString) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(prometheusText()) < 0 || !file.commit()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <functional>
+
+/**
+ * @brief 运行时指标登记表
+ * 计数和状态值由各模块自己的原子变量维护（只有写入线程更新，热路径上没有锁和额外的原子读-改-写），
+ * 登记表只保存读取函数，导出时逐个读取并生成Prometheus文本格式。
+ * 登记在启动时完成，导出在界面线程进行
+ */
+class MetricsRegistry
+{
+public:
+    enum Type {
+        Counter,    // 只增不减的累计值
+        Gauge       // 当前值
+    };
+
+    // 登记一个指标，name须符合Prometheus命名规则，read在导出时调用
+    void add(Type type, const QString &name, const QString &help, std::function<double()> read);
+
+    void addCounter(const QString &name, const QString &help, std::function<double()> read)
+    {
+        add(Counter, name, help, std::move(read));
+    }
+
+    void addGauge(const QString &name, const QString &help, std::function<double()> read)
+    {
+        add(Gauge, name, help, std::move(read));
+    }
+
+    int size() const { return m_metrics.size(); }
+
+    // 生成Prometheus文本格式（text/plain; version=0.0.4）
+    QByteArray prometheusText() const;
+
+    // 写入文件（先写临时文件再替换，供node_exporter的textfile收集器读取）
+    bool writeTextFile(const QString &fileName, QString *errorString = nullptr) const;
+
+private:
+    /**
+     * @brief 一个登记的指标
+     */
+    struct Metric {
+        Type type;
+        QByteArray name;
+        QByteArray help;
+        std::function<double()> read;
+    };
+
+    QVector<Metric> m_metrics;
+};
+
+#endif // METRICSREGISTRY_H
@@ -0,0 +1,84 @@
+#include "metricsserver.h"
+#include "metricsregistry.h"
+#include <QTcpSocket>
+
+namespace {
+const int kMaxRequestSize = 8192;   // 请求头的最大长度
+}
+
+MetricsServer::MetricsServer(const MetricsRegistry *registry, QObject *parent)
+    : QObject(parent)
+    , m_registry(registry)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::handleNewConnection);
+}
+
+bool MetricsServer::listen(quint16 port)
+{
+    return m_server->listen(QHostAddress::LocalHost, port);
+}
+
+void MetricsServer::handleNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, &MetricsServer::handleReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_requests.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void MetricsServer::handleReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket) {
+        return;
+    }
+
+    // 只需要请求行，等请求头读完再回应
+    QByteArray &request = m_requests[socket];
+    request.append(socket->readAll());
+    int headerEnd = request.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (request.size() > kMaxRequestSize) {
+            respond(socket, "431 Request Header Fields Too Large", "text/plain", QByteArray());
+        }
+        return;
+    }
+
+    QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    QByteArray method = requestLine.value(0);
+    QByteArray path = requestLine.value(1);
+    int query = path.indexOf('?');
+    if (query >= 0) {
+        path.truncate(query);
+    }
+
+    if (method != "GET") {
+        respond(socket, "405 Method Not Allowed", "text/plain", "Only GET is supported\n");
+    } else if (path == "/metrics") {
+        respond(socket, "200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                m_registry->prometheusText());
+    } else {
+        respond(socket, "404 Not Found", "text/plain", "Use /metrics\n");
+    }
+}
+
+void MetricsServer::respond(QTcpSocket *socket, const QByteArray &status,
+                            const QByteArray &contentType, const QByteArray &body)
+{
+    m_requests.remove(socket);
+    disconnect(socket, &QTcpSocket::readyRead, this, &MetricsServer::handleReadyRead);
+
+    QByteArray response;
+    response.reserve(body.size() + 128);
+    response.append("HTTP/1.1 ").append(status).append("\r\n");
+    response.append("Content-Type: ").append(contentType).append("\r\n");
+    response.append("Content-Length: ").append(QByteArray::number(body.size())).append("\r\n");
+    response.append("Connection: close\r\n\r\n");
+    response.append(body);
+    socket->write(response);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,41 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QHash>
+
+class QTcpSocket;
+class MetricsRegistry;
+
+/**
+ * @brief 指标的HTTP导出
+ * 只监听本机地址，GET /metrics 返回Prometheus文本格式，每个请求处理完即关闭连接。
+ * 运行在界面线程，只在被抓取时读取指标，不影响采集
+ */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MetricsServer(const MetricsRegistry *registry, QObject *parent = nullptr);
+
+    // 在127.0.0.1上监听，port为0时自动选择端口
+    bool listen(quint16 port);
+
+    quint16 serverPort() const { return m_server->serverPort(); }
+    QString errorString() const { return m_server->errorString(); }
+
+private slots:
+    void handleNewConnection();
+    void handleReadyRead();
+
+private:
+    void respond(QTcpSocket *socket, const QByteArray &status,
+                 const QByteArray &contentType, const QByteArray &body);
+
+    const MetricsRegistry *m_registry;
+    QTcpServer *m_server;
+    QHash<QTcpSocket *, QByteArray> m_requests;    // 尚未读完的请求头
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,466 @@
+#include "modbussource.h"
+#include <QUrl>
+#include <algorithm>
+#include <cstring>
+#include "logcategories.h"
+
+namespace {
+
+const int kReconnectMinDelay = 100;     // 首次重连的等待时间（毫秒）
+const int kReconnectMaxDelay = 5000;    // 重连等待时间的上限（毫秒）
+const int kResponseTimeout = 1000;      // 等待响应的超时（毫秒），超时后断开重连
+const int kHeaderSize = 7;              // MBAP报文头：事务号、协议号、长度、从站地址
+const int kMaxFrameLength = 254;        // 长度字段的上限：从站地址加最大253字节的PDU
+
+enum {
+    ReadHoldingRegisters = 3,
+    ReadInputRegisters = 4,
+    ExceptionFlag = 0x80
+};
+
+// 大端序寄存器
+inline quint32 readRegisters32(const uchar *data)
+{
+    return (quint32(data[0]) << 24) | (quint32(data[1]) << 16) | (quint32(data[2]) << 8) | data[3];
+}
+
+} // namespace
+
+const int ModbusSource::kMaxReadRegisters;
+
+ModbusSource::ModbusSource(TagTable *tags, const QString &host, quint16 port, QObject *parent)
+    : DataSource(tags, parent)
+    , m_host(host)
+    , m_port(port)
+    , m_socket(new QTcpSocket(this))
+    , m_pollTimer(new QTimer(this))
+    , m_timeoutTimer(new QTimer(this))
+    , m_reconnectTimer(new QTimer(this))
+    , m_reconnectDelay(kReconnectMinDelay)
+    , m_maxGap(0)
+    , m_pipelineDepth(8)
+    , m_nextTransaction(0)
+    , m_nextBlock(0)
+    , m_blockCount(0)
+    , m_requests(0)
+    , m_exceptions(0)
+    , m_overruns(0)
+{
+    m_pollTimer->setInterval(100);
+    m_timeoutTimer->setSingleShot(true);
+    m_timeoutTimer->setInterval(kResponseTimeout);
+    m_reconnectTimer->setSingleShot(true);
+
+    // 请求帧很小，关闭Nagle避免流水发出的请求被攒包延迟
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    connect(m_pollTimer, &QTimer::timeout, this, &ModbusSource::poll);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &ModbusSource::handleTimeout);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &ModbusSource::reconnect);
+    connect(m_socket, &QTcpSocket::stateChanged, this, &ModbusSource::handleStateChanged);
+    connect(m_socket, &QTcpSocket::readyRead, this, &ModbusSource::readResponses);
+}
+
+bool ModbusSource::parseUrl(const QString &url, QString *host, quint16 *port, quint8 *unit)
+{
+    QUrl parsed(url, QUrl::StrictMode);
+    if (!parsed.isValid() || parsed.scheme() != QLatin1String("modbus") || parsed.host().isEmpty()) {
+        return false;
+    }
+
+    int number = parsed.port(502);
+    if (number <= 0 || number > 65535) {
+        return false;
+    }
+
+    // 路径为从站地址，没有时默认为1
+    QString path = parsed.path();
+    int unitNumber = 1;
+    if (!path.isEmpty() && path != QLatin1String("/")) {
+        bool ok;
+        unitNumber = path.mid(1).toInt(&ok);
+        if (!ok || unitNumber < 0 || unitNumber > 255) {
+            return false;
+        }
+    }
+
+    *host = parsed.host();
+    *port = quint16(number);
+    *unit = quint8(unitNumber);
+    return true;
+}
+
+bool ModbusSource::parseAddress(const QString &address, TagType type, ModbusPoint *point)
+{
+    int separator = address.indexOf(QLatin1Char(':'));
+    QStringRef number = separator < 0 ? address.midRef(0) : address.midRef(0, separator);
+
+    // 5位地址为x0001~x9999，6位地址为x00001~x65536
+    if (number.size() != 5 && number.size() != 6) {
+        return false;
+    }
+    for (QChar c : number) {
+        if (c < QLatin1Char('0') || c > QLatin1Char('9')) {
+            return false;
+        }
+    }
+    if (number.at(0) == QLatin1Char('4')) {
+        point->function = ReadHoldingRegisters;
+    } else if (number.at(0) == QLatin1Char('3')) {
+        point->function = ReadInputRegisters;
+    } else {
+        return false;
+    }
+    bool ok;
+    int reg = number.mid(1).toInt(&ok);
+    if (!ok || reg < 1 || reg > 65536) {
+        return false;
+    }
+
+    if (separator < 0) {
+        point->format = type == TagDouble ? ModbusPoint::Float32 : ModbusPoint::Int16;
+    } else {
+        static const struct {
+            const char *name;
+            ModbusPoint::Format format;
+        } kFormats[] = {
+            {"int16", ModbusPoint::Int16}, {"uint16", ModbusPoint::UInt16},
+            {"int32", ModbusPoint::Int32}, {"uint32", ModbusPoint::UInt32},
+            {"float32", ModbusPoint::Float32}, {"float", ModbusPoint::Float32},
+            {"float64", ModbusPoint::Float64}, {"double", ModbusPoint::Float64}
+        };
+        QStringRef name = address.midRef(separator + 1);
+        bool found = false;
+        for (const auto &format : kFormats) {
+            if (name.compare(QLatin1String(format.name), Qt::CaseInsensitive) == 0) {
+                point->format = format.format;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+
+    // 多寄存器的值不能越过地址空间的末尾
+    if (reg - 1 + point->width() > 65536) {
+        return false;
+    }
+    point->offset = quint16(reg - 1);
+    return true;
+}
+
+QVector<ModbusBlock> ModbusSource::planBlocks(QVector<ModbusPoint> *points, int maxGap)
+{
+    std::sort(points->begin(), points->end(), [](const ModbusPoint &a, const ModbusPoint &b) {
+        if (a.unit != b.unit) {
+            return a.unit < b.unit;
+        }
+        if (a.function != b.function) {
+            return a.function < b.function;
+        }
+        return a.offset < b.offset;
+    });
+
+    // 按起始寄存器从小到大贪心延伸：能并入当前块就并入，否则另起一块。
+    // 每块从尚未覆盖的最小寄存器开始并尽量延伸，块数即为最少
+    QVector<ModbusBlock> blocks;
+    int end = 0;    // 当前块的结束寄存器（不含）
+    for (int i = 0; i < points->size(); ++i) {
+        const ModbusPoint &point = points->at(i);
+        int pointEnd = point.offset + point.width();
+        if (!blocks.isEmpty()) {
+            ModbusBlock &block = blocks.last();
+            int newEnd = qMax(end, pointEnd);
+            if (block.unit == point.unit && block.function == point.function
+                    && point.offset - end <= maxGap && newEnd - block.start <= kMaxReadRegisters) {
+                end = newEnd;
+                block.count = quint16(end - block.start);
+                ++block.pointCount;
+                continue;
+            }
+        }
+        blocks.append({point.unit, point.function, point.offset, quint16(point.width()), i, 1});
+        end = pointEnd;
+    }
+    return blocks;
+}
+
+bool ModbusSource::addTag(int tag, quint8 unit)
+{
+    ModbusPoint point;
+    if (!parseAddress(m_tags->address(tag), m_tags->type(tag), &point)) {
+        return false;
+    }
+    point.tag = tag;
+    point.unit = unit;
+    m_points.append(point);
+    return true;
+}
+
+void ModbusSource::setPollInterval(int interval)
+{
+    m_pollTimer->setInterval(qMax(1, interval));
+}
+
+void ModbusSource::setMaxGap(int registers)
+{
+    m_maxGap = qBound(0, registers, kMaxReadRegisters);
+}
+
+void ModbusSource::setPipelineDepth(int depth)
+{
+    m_pipelineDepth = qMax(1, depth);
+}
+
+void ModbusSource::start()
+{
+    m_blocks = planBlocks(&m_points, m_maxGap);
+    m_blockCount.store(m_blocks.size());
+    m_lastData = QVector<QByteArray>(m_blocks.size());
+    m_blockFailed = QVector<bool>(m_blocks.size(), false);
+    m_nextBlock = m_blocks.size();
+
+    // 请求帧只有事务号随每次发送变化
+    m_requestFrames.clear();
+    m_requestFrames.reserve(m_blocks.size());
+    for (const ModbusBlock &block : m_blocks) {
+        const char frame[12] = {
+            0, 0,                                       // 事务号
+            0, 0,                                       // 协议号
+            0, 6,                                       // 后续长度
+            char(block.unit), char(block.function),
+            char(block.start >> 8), char(block.start),
+            char(block.count >> 8), char(block.count)
+        };
+        m_requestFrames.append(QByteArray(frame, sizeof(frame)));
+    }
+
+    qCInfo(lcModbus) << m_points.size() << "registers merged into" << m_blocks.size()
+                     << "read requests on" << m_host << m_port;
+
+    m_pollTimer->start();
+    m_socket->connectToHost(m_host, m_port);
+}
+
+void ModbusSource::poll()
+{
+    if (m_socket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+
+    // 上一周期的请求还没有全部返回时跳过本周期，不让请求在连接上越积越多
+    if (m_nextBlock < m_blocks.size() || !m_pending.isEmpty()) {
+        m_overruns.store(m_overruns.load() + 1);
+        return;
+    }
+
+    m_nextBlock = 0;
+    sendRequests();
+}
+
+void ModbusSource::sendRequests()
+{
+    while (m_pending.size() < m_pipelineDepth && m_nextBlock < m_blocks.size()) {
+        int block = m_nextBlock++;
+        quint16 transaction = m_nextTransaction++;
+        QByteArray &frame = m_requestFrames[block];
+        frame[0] = char(transaction >> 8);
+        frame[1] = char(transaction);
+        m_pending.insert(transaction, {block, LatencyTracker::wallClockUs()});
+        m_socket->write(frame);
+        m_requests.store(m_requests.load() + 1);
+    }
+
+    if (!m_pending.isEmpty() && !m_timeoutTimer->isActive()) {
+        m_timeoutTimer->start();
+    }
+}
+
+void ModbusSource::readResponses()
+{
+    m_buffer.append(m_socket->readAll());
+    const uchar *data = reinterpret_cast<const uchar *>(m_buffer.constData());
+    int size = m_buffer.size();
+    int pos = 0;
+
+    while (size - pos >= kHeaderSize) {
+        const uchar *frame = data + pos;
+        int length = (frame[4] << 8) | frame[5];
+        if (frame[2] != 0 || frame[3] != 0 || length < 3 || length > kMaxFrameLength) {
+            qCWarning(lcModbus) << "Invalid Modbus TCP header from" << m_host << m_port;
+            m_socket->abort();
+            return;
+        }
+        int frameSize = 6 + length;
+        if (size - pos < frameSize) {
+            break;
+        }
+        if (!handleResponse(frame, frameSize)) {
+            m_socket->abort();
+            return;
+        }
+        pos += frameSize;
+    }
+    m_buffer.remove(0, pos);
+
+    // 有响应返回就重新计时，全部返回后停止
+    if (m_pending.isEmpty()) {
+        m_timeoutTimer->stop();
+    } else if (pos > 0) {
+        m_timeoutTimer->start();
+    }
+
+    // 一批响应处理完后补发请求，新请求合并在一次写入中发出
+    sendRequests();
+}
+
+bool ModbusSource::handleResponse(const uchar *frame, int size)
+{
+    quint16 transaction = quint16((frame[0] << 8) | frame[1]);
+    auto it = m_pending.find(transaction);
+    if (it == m_pending.end()) {
+        qCDebug(lcModbus) << "Response for unknown transaction" << transaction;
+        return true;
+    }
+    Pending pending = it.value();
+    m_pending.erase(it);
+
+    const ModbusBlock &block = m_blocks.at(pending.block);
+    uchar function = frame[7];
+    if (function == (block.function | ExceptionFlag)) {
+        m_exceptions.store(m_exceptions.load() + 1);
+        if (!m_blockFailed.at(pending.block)) {
+            m_blockFailed[pending.block] = true;
+            qCWarning(lcModbus) << "Modbus exception" << (size > 8 ? int(frame[8]) : 0)
+                                << "reading unit" << int(block.unit) << "function" << int(block.function)
+                                << "registers" << block.start << "count" << block.count;
+        }
+        return true;
+    }
+    if (function != block.function) {
+        qCWarning(lcModbus) << "Unexpected function code" << int(function) << "in response from" << m_host;
+        failMessage();
+        return false;
+    }
+
+    // 长度已由报文头确认，字节数不符只丢弃这一帧
+    int byteCount = size > 8 ? frame[8] : -1;
+    if (byteCount != block.count * 2 || size != 9 + byteCount) {
+        qCWarning(lcModbus) << "Response byte count" << byteCount << "does not match"
+                            << block.count << "requested registers";
+        failMessage();
+        return true;
+    }
+
+    if (m_blockFailed.at(pending.block)) {
+        m_blockFailed[pending.block] = false;
+        qCInfo(lcModbus) << "Reading unit" << int(block.unit) << "registers" << block.start << "recovered";
+    }
+    decodeBlock(pending.block, frame + 9, pending.sentTime);
+    return true;
+}
+
+void ModbusSource::decodeBlock(int blockIndex, const uchar *data, qint64 sentTime)
+{
+    const ModbusBlock &block = m_blocks.at(blockIndex);
+    qint64 receiveTime = m_latency ? LatencyTracker::wallClockUs() : 0;
+    beginMessage();
+
+    // 轮询每个周期都读回全部寄存器，与上次相同的变量不再写入，避免未变化的值占满队列
+    QByteArray &last = m_lastData[blockIndex];
+    bool first = last.isEmpty();
+    const uchar *previous = reinterpret_cast<const uchar *>(last.constData());
+
+    for (int i = block.firstPoint; i < block.firstPoint + block.pointCount; ++i) {
+        const ModbusPoint &point = m_points.at(i);
+        int offset = (point.offset - block.start) * 2;
+        const uchar *reg = data + offset;
+        if (!first && memcmp(reg, previous + offset, size_t(point.width()) * 2) == 0) {
+            continue;
+        }
+
+        TagValue value;
+        TagType type = TagInt;
+        switch (point.format) {
+        case ModbusPoint::Int16:
+            value = TagValue::fromInt(qint16((reg[0] << 8) | reg[1]));
+            break;
+        case ModbusPoint::UInt16:
+            value = TagValue::fromInt((reg[0] << 8) | reg[1]);
+            break;
+        case ModbusPoint::Int32:
+            value = TagValue::fromInt(qint32(readRegisters32(reg)));
+            break;
+        case ModbusPoint::UInt32:
+            value = TagValue::fromInt(readRegisters32(reg));
+            break;
+        case ModbusPoint::Float32: {
+            quint32 bits = readRegisters32(reg);
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            value = TagValue::fromDouble(f);
+            type = TagDouble;
+            break;
+        }
+        case ModbusPoint::Float64: {
+            quint64 bits = (quint64(readRegisters32(reg)) << 32) | readRegisters32(reg + 4);
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            value = TagValue::fromDouble(d);
+            type = TagDouble;
+            break;
+        }
+        }
+        applySample(point.tag, value, type);
+    }
+    last = QByteArray(reinterpret_cast<const char *>(data), block.count * 2);
+
+    // 以请求发出的时间作为数据的源时间
+    finishMessage(block.pointCount, sentTime, receiveTime);
+}
+
+void ModbusSource::handleTimeout()
+{
+    qCWarning(lcModbus) << m_pending.size() << "requests to" << m_host << m_port
+                        << "timed out, reconnecting";
+    m_socket->abort();
+}
+
+void ModbusSource::reconnect()
+{
+    if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+        qCDebug(lcModbus) << "Reconnecting to" << m_host << m_port;
+        m_socket->connectToHost(m_host, m_port);
+    }
+}
+
+void ModbusSource::handleStateChanged(QAbstractSocket::SocketState state)
+{
+    switch (state) {
+    case QAbstractSocket::ConnectedState:
+        qCInfo(lcModbus) << "Connected to Modbus server" << m_host << m_port;
+        setConnected(true);
+        m_reconnectDelay = kReconnectMinDelay;
+        // 连接后立即开始一个周期，不等轮询定时器
+        poll();
+        break;
+    case QAbstractSocket::UnconnectedState:
+        // 未返回的请求随连接作废，重连后从新的周期开始
+        setConnected(false);
+        m_pending.clear();
+        m_nextBlock = m_blocks.size();
+        m_buffer.clear();
+        m_timeoutTimer->stop();
+        if (!m_reconnectTimer->isActive()) {
+            qCInfo(lcModbus) << "Modbus server" << m_host << m_port << "unavailable:"
+                             << m_socket->errorString() << "- retrying in" << m_reconnectDelay << "ms";
+            m_reconnectTimer->start(m_reconnectDelay);
+            m_reconnectDelay = qMin(m_reconnectDelay * 2, kReconnectMaxDelay);
+        }
+        break;
+    default:
+        break;
+    }
+}
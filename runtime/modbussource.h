@@ -0,0 +1,140 @@
+#ifndef MODBUSSOURCE_H
+#define MODBUSSOURCE_H
+
+#include <QTcpSocket>
+#include <QHash>
+#include "datasource.h"
+
+/**
+ * @brief Modbus寄存器变量
+ * 地址为Modicon格式：4xxxx/4xxxxx为保持寄存器，3xxxx/3xxxxx为输入寄存器（从1开始编号），
+ * 可加":格式"指定寄存器中的数据格式，例如 "40001:float32"、"30010:int32"。
+ * 多寄存器的值高字在前（Modbus的大端约定）
+ */
+struct ModbusPoint {
+    // 寄存器中的数据格式
+    enum Format : quint8 {
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float32,
+        Float64
+    };
+
+    int tag;            // 变量ID
+    quint8 unit;        // 从站地址
+    quint8 function;    // 读功能码：3保持寄存器，4输入寄存器
+    quint16 offset;     // 寄存器偏移（从0开始）
+    Format format;      // 数据格式
+
+    // 占用的寄存器个数
+    int width() const { return format >= Float64 ? 4 : format >= Int32 ? 2 : 1; }
+};
+
+/**
+ * @brief 一次读请求覆盖的连续寄存器块
+ */
+struct ModbusBlock {
+    quint8 unit;        // 从站地址
+    quint8 function;    // 读功能码
+    quint16 start;      // 起始寄存器
+    quint16 count;      // 寄存器个数
+    int firstPoint;     // 块内第一个变量在变量数组中的下标
+    int pointCount;     // 块内的变量个数
+};
+
+/**
+ * @brief Modbus TCP轮询数据源
+ * 按固定间隔读取登记的寄存器：同一从站、同一功能码下的寄存器合并为尽量少的连续块读，
+ * 每块不超过协议允许的125个寄存器；一个轮询周期的请求在同一连接上流水发出，
+ * 以事务号匹配响应，不等上一个响应返回
+ */
+class ModbusSource : public DataSource
+{
+    Q_OBJECT
+public:
+    static const int kMaxReadRegisters = 125;   // 读保持/输入寄存器一次最多的寄存器个数（PDU限制）
+
+    ModbusSource(TagTable *tags, const QString &host, quint16 port, QObject *parent = nullptr);
+
+    // 解析数据源地址 modbus://主机[:端口][/从站地址]，端口默认502，从站地址默认1
+    static bool parseUrl(const QString &url, QString *host, quint16 *port, quint8 *unit);
+
+    // 解析变量地址，未指定格式时按变量类型取默认格式（开关量和整数为int16，其余为float32）
+    static bool parseAddress(const QString &address, TagType type, ModbusPoint *point);
+
+    // 把变量按从站、功能码和寄存器排序后贪心合并为最少的块：
+    // 相邻变量之间的空隙不超过maxGap个寄存器且块长不超过kMaxReadRegisters时并入同一块
+    static QVector<ModbusBlock> planBlocks(QVector<ModbusPoint> *points, int maxGap);
+
+    // 登记变量（start之前调用），地址无效时返回false
+    bool addTag(int tag, quint8 unit);
+
+    // 轮询间隔（毫秒）、允许合并的空隙（寄存器个数）和同时未返回的请求数上限，start之前调用
+    void setPollInterval(int interval);
+    void setMaxGap(int registers);
+    void setPipelineDepth(int depth);
+
+    // 规划寄存器块并连接从站
+    void start() override;
+
+    // 地址和块数
+    QString host() const { return m_host; }
+    quint16 port() const { return m_port; }
+    int blockCount() const { return m_blockCount.load(); }
+
+    // 累计发出的请求数、异常响应数和因上一周期未完成而跳过的轮询次数（可在其他线程读取）
+    qint64 requests() const { return m_requests.load(); }
+    qint64 exceptions() const { return m_exceptions.load(); }
+    qint64 overruns() const { return m_overruns.load(); }
+
+private slots:
+    void poll();
+    void handleStateChanged(QAbstractSocket::SocketState state);
+    void readResponses();
+    void handleTimeout();
+    void reconnect();
+
+private:
+    // 请求未返回的块
+    struct Pending {
+        int block;          // 块下标
+        qint64 sentTime;    // 发出时间（系统时间，微秒）
+    };
+
+    // 在流水线深度内继续发出本周期剩余的请求
+    void sendRequests();
+
+    // 处理一个完整的响应帧，协议错误时返回false
+    bool handleResponse(const uchar *frame, int size);
+
+    // 按块内变量的格式解出数值，寄存器与上次响应相同的变量跳过
+    void decodeBlock(int block, const uchar *data, qint64 sentTime);
+
+    QString m_host;                             // 从站主机
+    quint16 m_port;                             // 从站端口
+    QTcpSocket *m_socket;                       // 唯一的连接
+    QTimer *m_pollTimer;                        // 轮询定时器
+    QTimer *m_timeoutTimer;                     // 响应超时定时器
+    QTimer *m_reconnectTimer;                   // 断开后的重连定时器
+    int m_reconnectDelay;                       // 下次重连的等待时间（毫秒），逐次加倍
+    int m_maxGap;                               // 允许合并的空隙
+    int m_pipelineDepth;                        // 同时未返回的请求数上限
+    QVector<ModbusPoint> m_points;              // 变量，规划后按块排列
+    QVector<ModbusBlock> m_blocks;              // 寄存器块
+    QVector<QByteArray> m_requestFrames;        // 每块的请求帧（事务号发送时填写）
+    QHash<quint16, Pending> m_pending;          // 事务号到未返回的请求
+    quint16 m_nextTransaction;                  // 下一个事务号
+    int m_nextBlock;                            // 本周期下一个要发出的块
+    QByteArray m_buffer;                        // 未处理的接收数据
+    QVector<QByteArray> m_lastData;             // 每块上次响应的寄存器数据
+    QVector<bool> m_blockFailed;                // 每块上次是否为异常响应（状态变化时才告警）
+
+    QAtomicInt m_blockCount;                    // 块数
+    QAtomicInteger<qint64> m_requests;          // 累计请求数（只由采集线程写）
+    QAtomicInteger<qint64> m_exceptions;        // 累计异常响应数（只由采集线程写）
+    QAtomicInteger<qint64> m_overruns;          // 累计跳过的轮询次数（只由采集线程写）
+};
+
+#endif // MODBUSSOURCE_H
@@ -1,10 +1,104 @@
 #include "mqttcomm.h"
-#include <QDebug>
+#include <QDateTime>
+#include "trace.h"
+#include "logcategories.h"
 
-MqttComm::MqttComm(QObject *parent)
-    : QObject(parent)
+namespace {
+
+const int kReconnectMinDelay = 100;     // 首次重连的等待时间（毫秒）
+const int kReconnectMaxDelay = 5000;    // 重连等待时间的上限（毫秒）
+const int kRebirthInterval = 5000;      // 同一边缘节点两次Rebirth请求的最小间隔（毫秒）
+const quint64 kMaxDirectAlias = 1 << 16;   // 别名直接索引表的上限
+const int kDirectAddressDensity = 4;       // 数字地址直接索引表的长度上限：路由变量个数的倍数
+const int kDirectAddressSlack = 1024;      // 加上这个余量
+
+// Sparkplug B的绑定主题：消息类型一级换成"+"，同一节点或设备的BIRTH、DATA和DEATH共用一个路由。
+// 其他主题原样返回
+QString routeTopic(const QString &topic)
+{
+    if (!topic.startsWith(QLatin1String(SparkplugDecoder::kNamespace))) {
+        return topic;
+    }
+    QStringList levels = topic.split(QLatin1Char('/'));
+    if (levels.size() != 4 && levels.size() != 5) {
+        return topic;
+    }
+    levels[2] = QStringLiteral("+");
+    return levels.join(QLatin1Char('/'));
+}
+
+// Sparkplug B的绑定主题必须确定组、边缘节点和可选的设备，别名表只对单个节点或设备有效。
+// 消息类型一级不限，路由时统一换成"+"
+bool isValidSparkplugTopic(const QString &topic)
+{
+    QStringList levels = topic.split(QLatin1Char('/'));
+    if (levels.size() != 4 && levels.size() != 5) {
+        return false;
+    }
+    levels[2].clear();
+    return !TopicTrie::isWildcard(levels.join(QLatin1Char('/')));
+}
+
+// 由绑定主题生成订阅主题：已被通配符主题覆盖的不再订阅，
+// 同一父层级下足够多的兄弟主题合并为"父层级/+"，多收到的主题在路由时丢弃
+QStringList subscriptionFilters(const QStringList &topics, int wildcardMinTopics)
+{
+    TopicTrie wildcards;
+    QStringList filters;
+    for (const QString &topic : topics) {
+        if (TopicTrie::isWildcard(topic)) {
+            wildcards.insert(topic);
+            filters.append(topic);
+        }
+    }
+
+    QMap<QString, QStringList> siblings;    // 父层级到其下的主题
+    for (const QString &topic : topics) {
+        if (TopicTrie::isWildcard(topic) || wildcards.match(topic) >= 0) {
+            continue;
+        }
+        int slash = topic.lastIndexOf(QLatin1Char('/'));
+        if (slash < 0) {
+            filters.append(topic);
+        } else {
+            siblings[topic.left(slash)].append(topic);
+        }
+    }
+
+    for (auto it = siblings.constBegin(); it != siblings.constEnd(); ++it) {
+        if (wildcardMinTopics > 0 && it.value().size() >= wildcardMinTopics) {
+            filters.append(it.key() + QLatin1String("/+"));
+        } else {
+            filters.append(it.value());
+        }
+    }
+    return filters;
+}
+
+}
+
+MqttComm::MqttComm(TagTable *tags, QObject *parent)
+    : DataSource(tags, parent)
     , m_client(new QMqttClient(this))
+    , m_subscriptions(new SubscriptionManager(m_client, this))
+    , m_reconnectTimer(new QTimer(this))
+    , m_reconnectDelay(kReconnectMinDelay)
+    , m_route(-1)
+    , m_sparkplugBirth(false)
+    , m_sparkplugStale(false)
+    , m_sourceTime(-1)
+    , m_reconnects(0)
+    , m_unroutedMessages(0)
+    , m_rebirthRequests(0)
+    , m_subscriptionCount(0)
+    , m_everConnected(false)
 {
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &MqttComm::reconnectToBroker);
+    connect(m_subscriptions, &SubscriptionManager::activeCountChanged, this, [this](int count) {
+        m_subscriptionCount.store(count);
+    });
+
     // 连接信号槽
     connect(m_client, &QMqttClient::messageReceived,
             this, &MqttComm::handleMessage);
@@ -16,46 +110,60 @@ MqttComm::MqttComm(QObject *parent)
 
 MqttComm::~MqttComm()
 {
-    // 断开所有订阅
-    for (auto sub : m_subscriptions.values()) {
-        delete sub;
-    }
-    m_subscriptions.clear();
-
-    // 断开连接
+    // 先断开客户端的信号，析构过程中不再重连；持久会话的订阅由服务器保留
+    m_reconnectTimer->stop();
+    m_client->disconnect();
     if (m_client->state() == QMqttClient::Connected) {
-        m_client->disconnect();
+        m_client->disconnectFromHost();
     }
 }
 
-void MqttComm::connectToBroker(const QString &host, quint16 port)
+void MqttComm::setSession(const QString &clientId, bool cleanSession)
+{
+    m_client->setClientId(clientId);
+    m_client->setCleanSession(cleanSession);
+}
+
+void MqttComm::setBroker(const QString &host, quint16 port)
 {
     m_client->setHostname(host);
     m_client->setPort(port);
+}
+
+void MqttComm::start()
+{
     m_client->connectToHost();
 }
 
-void MqttComm::subscribe(const QString &topic)
+void MqttComm::connectToBroker(const QString &host, quint16 port)
 {
-    if (m_client->state() != QMqttClient::Connected) {
-        qWarning() << "MQTT client not connected, cannot subscribe to" << topic;
-        return;
-    }
+    setBroker(host, port);
+    start();
+}
 
-    // 创建订阅
-    auto subscription = m_client->subscribe(topic);
-    if (subscription) {
-        m_subscriptions[topic] = subscription;
-        qDebug() << "Subscribed to topic:" << topic;
-    } else {
-        qWarning() << "Failed to subscribe to topic:" << topic;
+void MqttComm::reconnectToBroker()
+{
+    if (m_client->state() == QMqttClient::Disconnected) {
+        qCDebug(lcMqtt) << "Reconnecting to" << m_client->hostname() << m_client->port();
+        m_client->connectToHost();
     }
 }
 
+void MqttComm::subscribe(const QString &topic)
+{
+    // 未连接时先登记，连接后统一订阅
+    m_subscriptions->acquire(topic);
+}
+
+void MqttComm::unsubscribe(const QString &topic)
+{
+    m_subscriptions->release(topic);
+}
+
 void MqttComm::publish(const QString &topic, const QJsonObject &data)
 {
     if (m_client->state() != QMqttClient::Connected) {
-        qWarning() << "MQTT client not connected, cannot publish to" << topic;
+        qCWarning(lcMqtt) << "MQTT client not connected, cannot publish to" << topic;
         return;
     }
 
@@ -66,114 +174,419 @@ void MqttComm::publish(const QString &topic, const QJsonObject &data)
     // 发布消息
     auto result = m_client->publish(topic, payload);
     if (result == -1) {
-        qWarning() << "Failed to publish message to topic:" << topic;
+        qCWarning(lcMqtt) << "Failed to publish message to topic:" << topic;
     } else {
-        qDebug() << "Published message to topic:" << topic;
+        qCDebug(lcMqtt) << "Published message to topic:" << topic;
     }
 }
 
-void MqttComm::setAddressTopicMap(const QMap<QString, QString> &addressTopicMap)
+void MqttComm::setTags(const QVector<int> &tags, int wildcardMinTopics)
 {
-    // 取消旧的订阅
-    for (auto sub : m_subscriptions.values()) {
-        delete sub;
+    // 每个主题对应一个路由，报文中的地址只在所属路由的变量中查找，
+    // 不同主题下的相同地址是不同的变量
+    m_routes.clear();
+    m_routeTags.clear();
+    m_nextTag.fill(-1, m_tags->size());
+    QVector<int> tagRoutes;         // 按tags的顺序，变量所属的路由
+    QVector<int> boundCounts;       // 按路由的变量个数
+    tagRoutes.reserve(tags.size());
+    for (int tag : tags) {
+        // 无效的Sparkplug B绑定既不路由也不订阅，否则收到的报文会被当作JSON等格式解码
+        const QString &topic = m_tags->topic(tag);
+        if (topic.startsWith(QLatin1String(SparkplugDecoder::kNamespace)) && !isValidSparkplugTopic(topic)) {
+            qCWarning(lcMqtt) << "Sparkplug B topic must name a group, edge node and optional device:" << topic;
+            tagRoutes.append(-1);
+            continue;
+        }
+        int route = m_routes.insert(routeTopic(topic));
+        if (route == m_routeTags.size()) {
+            m_routeTags.append(RouteTags());
+            boundCounts.append(0);
+        }
+        tagRoutes.append(route);
+        ++boundCounts[route];
     }
-    m_subscriptions.clear();
 
-    // 设置新的映射
-    m_addressTopicMap = addressTopicMap;
+    for (int i = 0; i < tags.size(); ++i) {
+        int tag = tags.at(i);
+        int route = tagRoutes.at(i);
+        if (route < 0) {
+            continue;
+        }
+        RouteTags &routeTags = m_routeTags[route];
+        const QString &address = m_tags->address(tag);
 
-    // 订阅新的主题
-    for (const QString &topic : addressTopicMap.values()) {
-        subscribe(topic);
+        // Sparkplug B同一节点或设备的各消息类型共用一个路由，绑定到其中不同主题的同名变量一起更新
+        auto name = routeTags.names.constFind(address);
+        if (name != routeTags.names.constEnd()) {
+            int last = name.value();
+            while (m_nextTag.at(last) >= 0) {
+                last = m_nextTag.at(last);
+            }
+            m_nextTag[last] = tag;
+            continue;
+        }
+        routeTags.names.insert(address, tag);
+
+        // 报文中的地址是整数，只有规范写法的数字地址才可能被匹配到
+        bool ok = false;
+        int addr = address.toInt(&ok);
+        if (ok && QString::number(addr) == address) {
+            // 直接索引表的长度按路由的变量个数限制，个别很大的地址放入稀疏表，不按地址分配整张表
+            if (addr >= 0 && addr < kDirectAddressDensity * boundCounts.at(route) + kDirectAddressSlack) {
+                if (addr >= routeTags.directIds.size()) {
+                    routeTags.directIds.insert(routeTags.directIds.size(),
+                                               addr + 1 - routeTags.directIds.size(), -1);
+                }
+                routeTags.directIds[addr] = tag;
+            } else {
+                routeTags.sparseIds.insert(addr, tag);
+            }
+        }
     }
+
+    // 只绑定了设备主题时也要收到所属边缘节点的NBIRTH/NDEATH：节点重新上线或下线后设备的别名全部失效。
+    // 为这样的节点补一个没有变量的路由，只订阅这两种消息
+    int boundRoutes = m_routes.routeCount();
+    QStringList lifecycleTopics;
+    for (int route = 0; route < boundRoutes; ++route) {
+        const QString &topic = m_routes.route(route);
+        if (!topic.startsWith(QLatin1String(SparkplugDecoder::kNamespace))) {
+            continue;
+        }
+        QStringList levels = topic.split(QLatin1Char('/'));
+        if (levels.size() != 5) {
+            continue;
+        }
+        levels.removeLast();
+        int node = m_routes.insert(levels.join(QLatin1Char('/')));
+        if (node == m_routeTags.size()) {
+            m_routeTags.append(RouteTags());
+            levels[2] = QStringLiteral("NBIRTH");
+            lifecycleTopics.append(levels.join(QLatin1Char('/')));
+            levels[2] = QStringLiteral("NDEATH");
+            lifecycleTopics.append(levels.join(QLatin1Char('/')));
+        }
+    }
+
+    // Sparkplug B路由按边缘节点分组，别名表在收到BIRTH后建立
+    m_sparkplugRoutes.fill(SparkplugRoute(), m_routes.routeCount());
+    m_sparkplugNodes.clear();
+    QHash<QString, int> nodes;
+    for (int route = 0; route < m_routes.routeCount(); ++route) {
+        const QString &topic = m_routes.route(route);
+        if (!topic.startsWith(QLatin1String(SparkplugDecoder::kNamespace))) {
+            continue;
+        }
+        // 无效的主题已在登记路由时剔除，组、节点和设备都是确定的
+        QStringList levels = topic.split(QLatin1Char('/'));
+        QString nodeKey = levels.at(1) + QLatin1Char('/') + levels.at(3);
+        auto node = nodes.find(nodeKey);
+        if (node == nodes.end()) {
+            node = nodes.insert(nodeKey, m_sparkplugNodes.size());
+            SparkplugNode entry;
+            entry.commandTopic = levels.at(0) + QLatin1Char('/') + levels.at(1)
+                                 + QLatin1String("/NCMD/") + levels.at(3);
+            m_sparkplugNodes.append(entry);
+        }
+        m_sparkplugRoutes[route].node = node.value();
+        m_sparkplugRoutes[route].lifecycleOnly = route >= boundRoutes;
+    }
+
+    QStringList topics;
+    for (int route = 0; route < boundRoutes; ++route) {
+        topics.append(m_routes.route(route));
+    }
+    topics.append(lifecycleTopics);
+    QStringList filters = subscriptionFilters(topics, wildcardMinTopics);
+    qCInfo(lcMqtt) << tags.size() << "tags on" << topics.size()
+                   << "topics," << filters.size() << "subscriptions";
+
+    // 先订阅新的主题再取消旧的，两次映射共有的主题不会被取消后重新订阅
+    for (const QString &filter : filters) {
+        subscribe(filter);
+    }
+    for (const QString &filter : m_filters) {
+        unsubscribe(filter);
+    }
+    m_filters = filters;
 }
 
-double MqttComm::getValue(const QString &address)
+double MqttComm::getValue(const QString &topic, const QString &address)
 {
-    return m_addressValueMap.value(address, 0.0);
+    int tag = m_tags->tagId(topic, address);
+    return tag < 0 ? 0.0 : m_tags->toDouble(tag);
 }
 
 void MqttComm::handleMessage(const QByteArray &message, const QMqttTopicName &topic)
 {
-    qDebug() << "Received message from topic:" << topic.name();
-    
-    // 将消息转换为UTF-8编码的QString
-    QString messageString = QString::fromUtf8(message);
-    qDebug() << "Message:" << messageString;
-
-    // 解析JSON消息
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(messageString.toUtf8(), &error);
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << "Failed to parse JSON message:" << error.errorString();
+    TRACE_SCOPE("MqttComm::handleMessage");
+    beginMessage();
+    qint64 receiveTime = m_latency ? LatencyTracker::wallClockUs() : 0;
+
+    qCDebug(lcMqtt) << "Received message from topic:" << topic.name()
+                    << "size:" << message.size();
+
+    // 按主题路由，通配符订阅带来的无关主题不解码
+    m_route = m_routes.match(topic.name());
+    if (m_route < 0) {
+        m_unroutedMessages.store(m_unroutedMessages.load() + 1);
+        qCDebug(lcMqtt) << "No route for topic:" << topic.name();
         return;
     }
 
-    // 处理JSON对象
-    if (doc.isObject()) {
-        QJsonObject obj = doc.object();
-        
-        // 获取时间戳
-        QString timestamp = obj["timestamp"].toString();
-        
-        // 获取数值数组
-        QJsonArray values = obj["body"].toArray();
-        if (values.isEmpty()) {
-            qWarning() << "Message does not contain body array";
-            return;
-        }
-
-        // 处理每个数值
-        for (const QJsonValue &val : values) {
-            QJsonObject valueObj = val.toObject();
-            
-            // 获取地址和值
-            int addr = valueObj["addr"].toInt();
-            double value = valueObj["val"].toDouble();
-            
-            // 转换地址格式为字符串
-            QString address = QString::number(addr);
-            
-            qDebug() << "Processing address:" << address 
-                     << "mapped topics:" << m_addressTopicMap.keys();
-            
-            // 检查是否是我们关注的地址
-            if (m_addressTopicMap.contains(address)) {
-                qDebug() << "Received value" << value << "for address" << address 
-                        << "at time" << timestamp;
-                
-                // 更新值
-                m_addressValueMap[address] = value;
-                // 发出信号
-                emit valueChanged(address, value);
+    // 直接在原始字节上流式解码，数据点通过onSample回调
+    m_timestamp = QLatin1String();
+    m_sourceTime = -1;
+    int samples = 0;
+    bool decoded;
+    if (m_sparkplugRoutes.at(m_route).node >= 0) {
+        decoded = handleSparkplug(message, topic, &samples);
+    } else {
+        // 按报文开头的字节选择解码格式，JSON、CBOR和定长记录可以在同一主题上混用
+        ValueDecoder *decoder;
+        switch (ValueDecoder::sniff(message)) {
+        case ValueDecoder::Cbor:
+            decoder = &m_cborDecoder;
+            break;
+        case ValueDecoder::Packed:
+            decoder = &m_packedDecoder;
+            break;
+        default:
+            decoder = &m_jsonDecoder;
+            break;
+        }
+        decoded = decoder->decode(message, this);
+        if (!decoded) {
+            qCWarning(lcMqtt) << "Failed to decode message:" << decoder->errorString()
+                              << "at offset" << decoder->errorOffset();
+        } else if (decoder->sampleCount() == 0) {
+            qCWarning(lcMqtt) << "Message does not contain body array";
+        }
+        samples = decoder->sampleCount();
+    }
+
+    if (decoded) {
+        finishMessage(samples, m_sourceTime, receiveTime);
+    } else {
+        failMessage();
+    }
+}
+
+void MqttComm::onTimestamp(const char *data, int size)
+{
+    m_timestamp = QLatin1String(data, size);
+    if (m_latency) {
+        m_sourceTime = LatencyTracker::parseTimestamp(data, size);
+    }
+}
+
+void MqttComm::onSample(int addr, TagValue decoded, TagType decodedType)
+{
+    // 检查是否是本主题下绑定的地址
+    int tag = routeTag(addr);
+    if (tag >= 0) {
+        qCDebug(lcMqtt) << "Received value" << decoded.toDouble(decodedType) << "for address" << addr
+                        << "at time" << m_timestamp;
+        applyRouted(tag, decoded, decodedType);
+    } else {
+        countUnknownAddress();
+        qCDebug(lcMqtt) << "Address" << addr << "not found in mapping";
+    }
+}
+
+bool MqttComm::handleSparkplug(const QByteArray &message, const QMqttTopicName &topic, int *samples)
+{
+    SparkplugRoute &route = m_sparkplugRoutes[m_route];
+    SparkplugDecoder::MessageType type = SparkplugDecoder::messageType(topic.name());
+    if (route.lifecycleOnly) {
+        // 只为设备补的节点路由：节点上线或下线时清除设备的别名表，节点的指标没有绑定，不必解码
+        if (type == SparkplugDecoder::NBirth || type == SparkplugDecoder::NDeath) {
+            qCInfo(lcMqtt) << "Sparkplug B node" << (type == SparkplugDecoder::NBirth ? "online:" : "offline:")
+                           << topic.name();
+            resetSparkplugNode(route.node);
+        }
+        return true;
+    }
+
+    switch (type) {
+    case SparkplugDecoder::NDeath:
+        qCInfo(lcMqtt) << "Sparkplug B node offline:" << topic.name();
+        resetSparkplugNode(route.node);
+        return true;
+    case SparkplugDecoder::DDeath:
+        qCInfo(lcMqtt) << "Sparkplug B device offline:" << topic.name();
+        route.born = false;
+        route.aliases.clear();
+        route.sparseAliases.clear();
+        return true;
+    case SparkplugDecoder::NBirth:
+        // 节点重新上线后设备也会重新发送DBIRTH
+        resetSparkplugNode(route.node);
+        m_sparkplugBirth = true;
+        break;
+    case SparkplugDecoder::DBirth:
+        route.aliases.clear();
+        route.sparseAliases.clear();
+        m_sparkplugBirth = true;
+        break;
+    case SparkplugDecoder::NData:
+    case SparkplugDecoder::DData:
+        // 错过了BIRTH（例如运行时晚于边缘节点启动）时别名无从解释，请求节点重新BIRTH
+        if (!route.born) {
+            requestRebirth(route.node);
+            return true;
+        }
+        m_sparkplugBirth = false;
+        break;
+    default:
+        // 命令和主机状态消息与本机无关
+        return true;
+    }
+
+    m_sparkplugStale = false;
+    if (!m_sparkplugDecoder.decode(message, this)) {
+        qCWarning(lcMqtt) << "Failed to decode Sparkplug B message:" << m_sparkplugDecoder.errorString()
+                          << "at offset" << m_sparkplugDecoder.errorOffset();
+        // 不完整的别名表不能使用
+        if (m_sparkplugBirth) {
+            route.born = false;
+        }
+        return false;
+    }
+
+    *samples = m_sparkplugDecoder.metricCount();
+    if (m_sparkplugBirth) {
+        route.born = true;
+        qCInfo(lcMqtt) << "Sparkplug B birth on" << topic.name() << "with" << *samples << "metrics";
+    }
+    if (m_sparkplugStale) {
+        requestRebirth(route.node);
+    }
+    return true;
+}
+
+void MqttComm::onSparkplugTimestamp(quint64 timestamp)
+{
+    if (m_latency) {
+        m_sourceTime = qint64(timestamp) * 1000;
+    }
+}
+
+void MqttComm::onSparkplugMetric(const SparkplugMetric &metric)
+{
+    SparkplugRoute &route = m_sparkplugRoutes[m_route];
+    TagValue value;
+    TagType type;
+
+    if (m_sparkplugBirth) {
+        // BIRTH：按名称查出变量并记入别名表，只有这里做字符串处理
+        int tag = -1;
+        if (metric.nameSize > 0) {
+            tag = m_routeTags.at(m_route).names.value(QString::fromUtf8(metric.name, metric.nameSize), -1);
+        }
+        if (metric.hasAlias) {
+            SparkplugAlias alias;
+            alias.tag = tag;
+            alias.datatype = metric.datatype;
+            if (metric.alias < kMaxDirectAlias) {
+                if (metric.alias >= quint64(route.aliases.size())) {
+                    route.aliases.resize(int(metric.alias) + 1);
+                }
+                route.aliases[int(metric.alias)] = alias;
             } else {
-                qDebug() << "Address" << address << "not found in mapping";
+                route.sparseAliases.insert(metric.alias, alias);
             }
         }
+        // BIRTH中带有当前值
+        if (tag >= 0 && SparkplugDecoder::toTagValue(metric, metric.datatype, &value, &type)) {
+            applyRouted(tag, value, type);
+        }
+        return;
+    }
+
+    if (!metric.hasAlias) {
+        // 边缘节点不使用别名时只能按名称查找
+        int tag = m_routeTags.at(m_route).names.value(QString::fromUtf8(metric.name, metric.nameSize), -1);
+        if (tag >= 0 && SparkplugDecoder::toTagValue(metric, metric.datatype, &value, &type)) {
+            applyRouted(tag, value, type);
+        } else {
+            countUnknownAddress();
+        }
+        return;
+    }
+
+    // DATA：只按别名查表，数据类型以BIRTH中声明的为准
+    SparkplugAlias alias = metric.alias < quint64(route.aliases.size())
+                           ? route.aliases.at(int(metric.alias))
+                           : route.sparseAliases.value(metric.alias);
+    if (alias.tag < 0) {
+        if (alias.tag == kUnknownAlias) {
+            m_sparkplugStale = true;
+        }
+        countUnknownAddress();
+        return;
+    }
+    quint32 datatype = metric.datatype != 0 ? metric.datatype : alias.datatype;
+    if (SparkplugDecoder::toTagValue(metric, datatype, &value, &type)) {
+        applyRouted(alias.tag, value, type);
+    }
+}
+
+void MqttComm::resetSparkplugNode(int node)
+{
+    for (SparkplugRoute &route : m_sparkplugRoutes) {
+        if (route.node == node) {
+            route.born = false;
+            route.aliases.clear();
+            route.sparseAliases.clear();
+        }
+    }
+}
+
+void MqttComm::requestRebirth(int node)
+{
+    SparkplugNode &entry = m_sparkplugNodes[node];
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (m_client->state() != QMqttClient::Connected || now - entry.lastRebirth < kRebirthInterval) {
+        return;
+    }
+    entry.lastRebirth = now;
+
+    qCInfo(lcMqtt) << "Requesting Sparkplug B rebirth on" << entry.commandTopic;
+    if (m_client->publish(QMqttTopicName(entry.commandTopic), SparkplugDecoder::rebirthRequest(quint64(now))) == -1) {
+        qCWarning(lcMqtt) << "Failed to publish rebirth request to" << entry.commandTopic;
+        return;
     }
+    m_rebirthRequests.store(m_rebirthRequests.load() + 1);
 }
 
 void MqttComm::handleStateChanged(QMqttClient::ClientState state)
 {
     switch (state) {
         case QMqttClient::Connected:
-            qDebug() << "MQTT client connected";
-            // 重新订阅所有主题
-            for (const QString &topic : m_addressTopicMap.values()) {
-                subscribe(topic);
+            qCInfo(lcMqtt) << "MQTT client connected";
+            if (m_everConnected) {
+                m_reconnects.store(m_reconnects.load() + 1);
             }
+            m_everConnected = true;
+            setConnected(true);
+            // 订阅由SubscriptionManager在连接后核对和补发
+            m_reconnectDelay = kReconnectMinDelay;
             break;
         case QMqttClient::Disconnected:
-            qDebug() << "MQTT client disconnected";
+            qCInfo(lcMqtt) << "MQTT client disconnected, retrying in" << m_reconnectDelay << "ms";
+            setConnected(false);
+            m_reconnectTimer->start(m_reconnectDelay);
+            m_reconnectDelay = qMin(m_reconnectDelay * 2, kReconnectMaxDelay);
             break;
         case QMqttClient::Connecting:
-            qDebug() << "MQTT client connecting...";
+            qCDebug(lcMqtt) << "MQTT client connecting...";
             break;
     }
 }
 
 void MqttComm::handleError(QMqttClient::ClientError error)
 {
-    qWarning() << "MQTT client error:" << error;
+    qCWarning(lcMqtt) << "MQTT client error:" << error;
 } 
@@ -1,54 +1,182 @@
 #ifndef MQTTCOMM_H
 #define MQTTCOMM_H
 
-#include <QObject>
 #include <QtMqtt/qmqttclient.h>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QMap>
+#include <QHash>
+#include "datasource.h"
+#include "jsonvaluedecoder.h"
+#include "cborvaluedecoder.h"
+#include "packedvaluedecoder.h"
+#include "sparkplugdecoder.h"
+#include "topictrie.h"
+#include "subscriptionmanager.h"
 
-class MqttComm : public QObject
+class MqttComm : public DataSource, private ValueSink, private SparkplugSink
 {
     Q_OBJECT
 public:
-    explicit MqttComm(QObject *parent = nullptr);
+    explicit MqttComm(TagTable *tags, QObject *parent = nullptr);
     ~MqttComm();
 
-    // 连接MQTT服务器
+    // 设置客户端ID和会话类型，必须在connectToBroker之前调用。
+    // 持久会话（cleanSession为false）需要固定的客户端ID，重连时服务器保留订阅
+    void setSession(const QString &clientId, bool cleanSession);
+
+    // 设置MQTT服务器地址，start时连接
+    void setBroker(const QString &host, quint16 port);
+
+    // 连接MQTT服务器，断开后自动重连
+    void start() override;
     void connectToBroker(const QString &host, quint16 port);
     
-    // 订阅主题
+    // 订阅和取消订阅主题（按主题计引用）
     void subscribe(const QString &topic);
+    void unsubscribe(const QString &topic);
     
     // 发布消息
     void publish(const QString &topic, const QJsonObject &data);
     
-    // 设置变量地址到主题的映射
-    void setAddressTopicMap(const QMap<QString, QString> &addressTopicMap);
+    // 设置由MQTT接收的变量（变量ID，主题和地址取自变量表），只订阅这些变量的主题，
+    // 报文中的地址只匹配同一主题下的变量。
+    // 同一层级下的兄弟主题不少于wildcardMinTopics个时合并为"父层级/+"订阅，0表示不合并。
+    // Sparkplug B的主题 spBv1.0/<组>/<消息类型>/<边缘节点>[/<设备>] 中消息类型一级按"+"处理，
+    // 地址为指标名称；只绑定了设备主题时也订阅所属边缘节点的NBIRTH和NDEATH
+    void setTags(const QVector<int> &tags, int wildcardMinTopics = 0);
+
+    // 当前的订阅主题（可能含通配符）
+    QStringList subscriptionFilters() const { return m_filters; }
     
-    // 获取变量值
-    double getValue(const QString &address);
+    // 获取主题下地址的变量值（按double返回）
+    double getValue(const QString &topic, const QString &address);
 
-signals:
-    // 当收到新数据时发出信号
-    void valueChanged(const QString &address, double value);
+    // 按变量ID获取值
+    double getValue(int tagId) const { return m_tags->toDouble(tagId); }
 
-private slots:
-    // 处理MQTT消息
+    // 主题下地址对应的变量ID，未登记时返回-1
+    int tagId(const QString &topic, const QString &address) const { return m_tags->tagId(topic, address); }
+
+    // 累计重连次数（可在其他线程读取）
+    qint64 reconnects() const { return m_reconnects.load(); }
+
+    // 累计因主题没有路由而未解码的报文数（可在其他线程读取）
+    qint64 unroutedMessages() const { return m_unroutedMessages.load(); }
+
+    // 累计向Sparkplug B边缘节点请求重新BIRTH的次数（可在其他线程读取）
+    qint64 rebirthRequests() const { return m_rebirthRequests.load(); }
+
+    // 有效的订阅个数（可在其他线程读取）
+    int subscriptionCount() const { return m_subscriptionCount.load(); }
+
+public slots:
+    // 处理一条MQTT消息：按主题路由并解码，也可用于注入或回放录制的报文
     void handleMessage(const QByteArray &message, const QMqttTopicName &topic);
-    
+
+private slots:
     // 处理连接状态变化
     void handleStateChanged(QMqttClient::ClientState state);
     
     // 处理错误
     void handleError(QMqttClient::ClientError error);
 
+    // 断开后重新连接服务器
+    void reconnectToBroker();
+
 private:
+    // ValueSink接口：由解码器逐个回调
+    void onTimestamp(const char *data, int size) override;
+    void onSample(int addr, TagValue value, TagType type) override;
+
+    // SparkplugSink接口
+    void onSparkplugTimestamp(quint64 timestamp) override;
+    void onSparkplugMetric(const SparkplugMetric &metric) override;
+
+    // 当前路由下报文中数字地址对应的变量ID，未绑定时返回-1
+    inline int routeTag(int addr) const
+    {
+        const RouteTags &routeTags = m_routeTags.at(m_route);
+        if (addr >= 0 && addr < routeTags.directIds.size()) {
+            return routeTags.directIds.at(addr);
+        }
+        return routeTags.sparseIds.value(addr, -1);
+    }
+
+    // 写入路由查到的变量以及同一路由下相同地址的其他变量
+    inline void applyRouted(int tag, TagValue value, TagType type)
+    {
+        do {
+            applySample(tag, value, type);
+            tag = m_nextTag.at(tag);
+        } while (tag >= 0);
+    }
+
+    // 解码Sparkplug B报文，BIRTH时重建别名表，DATA时只按别名查表
+    bool handleSparkplug(const QByteArray &message, const QMqttTopicName &topic, int *samples);
+
+    // 清除边缘节点及其设备的别名表（NBIRTH/NDEATH时设备也须重新BIRTH）
+    void resetSparkplugNode(int node);
+
+    // 向边缘节点发送Rebirth命令，同一节点有间隔限制
+    void requestRebirth(int node);
+
+    static const int kUnknownAlias = -2;            // 别名不在BIRTH中
+
+    // 一个路由（绑定主题）下的变量，报文中的地址只在所属路由内查找
+    struct RouteTags {
+        QVector<int> directIds;                         // 数字地址直接索引表（-1表示未绑定）
+        QHash<int, int> sparseIds;                      // 超出直接索引范围的数字地址
+        QHash<QString, int> names;                      // 地址字符串（Sparkplug B的指标名称）
+    };
+
+    // Sparkplug B别名对应的变量
+    struct SparkplugAlias {
+        int tag = kUnknownAlias;    // 变量ID，-1表示BIRTH中有但没有绑定
+        quint32 datatype = 0;       // BIRTH中声明的数据类型
+    };
+
+    // 一个边缘节点或设备（对应一个路由）的别名表，BIRTH时重建
+    struct SparkplugRoute {
+        int node = -1;                                  // 所属的边缘节点，-1表示不是Sparkplug路由
+        bool lifecycleOnly = false;                     // 只为设备接收节点的NBIRTH/NDEATH，没有绑定的变量
+        bool born = false;                              // 已收到BIRTH，别名表有效
+        QVector<SparkplugAlias> aliases;                // 较小的别名直接索引
+        QHash<quint64, SparkplugAlias> sparseAliases;   // 其余的别名
+    };
+
+    // Sparkplug B边缘节点
+    struct SparkplugNode {
+        QString commandTopic;       // NCMD主题
+        qint64 lastRebirth = 0;     // 上次请求重新BIRTH的时间（毫秒）
+    };
+
     QMqttClient *m_client;                          // MQTT客户端
-    QMap<QString, QString> m_addressTopicMap;       // 地址到主题的映射
-    QMap<QString, double> m_addressValueMap;        // 地址到值的映射
-    QMap<QString, QMqttSubscription*> m_subscriptions;  // 主题订阅对象
+    SubscriptionManager *m_subscriptions;           // 主题订阅（计引用，重连时补发）
+    QTimer *m_reconnectTimer;                       // 断开后的重连定时器
+    int m_reconnectDelay;                           // 下次重连的等待时间（毫秒），逐次加倍
+    TopicTrie m_routes;                             // 绑定主题的前缀树，报文主题按此路由
+    QVector<RouteTags> m_routeTags;                 // 按路由的变量
+    QVector<int> m_nextTag;                         // 同一路由下相同地址的下一个变量（-1表示没有），按变量ID
+    QStringList m_filters;                          // 订阅主题（绑定主题合并通配符后）
+    int m_route;                                    // 当前报文的路由
+    JsonValueDecoder m_jsonDecoder;                 // 流式报文解码器：JSON
+    CborValueDecoder m_cborDecoder;                 // CBOR
+    PackedValueDecoder m_packedDecoder;             // 定长记录
+    SparkplugDecoder m_sparkplugDecoder;            // Sparkplug B
+    QVector<SparkplugRoute> m_sparkplugRoutes;      // 按路由的别名表
+    QVector<SparkplugNode> m_sparkplugNodes;        // 边缘节点
+    bool m_sparkplugBirth;                          // 当前报文是BIRTH
+    bool m_sparkplugStale;                          // 当前报文中有BIRTH里没有的别名
+    QLatin1String m_timestamp;                      // 当前报文的时间戳（仅解码期间有效）
+    qint64 m_sourceTime;                            // 当前报文的时间戳（系统时间，微秒），-1表示没有
+
+    QAtomicInteger<qint64> m_reconnects;            // 累计重连次数（只由接收线程写）
+    QAtomicInteger<qint64> m_unroutedMessages;      // 累计没有路由的报文数（只由接收线程写）
+    QAtomicInteger<qint64> m_rebirthRequests;       // 累计请求重新BIRTH的次数（只由接收线程写）
+    QAtomicInt m_subscriptionCount;                 // 服务器已确认的订阅个数
+    bool m_everConnected;                           // 是否连接过，之后的连接计为重连
 };
 
 #endif // MQTTCOMM_H 
@@ -0,0 +1,53 @@
+#include "packedvaluedecoder.h"
+#include <QtEndian>
+#include <climits>
+
+bool PackedValueDecoder::decode(const QByteArray &payload, ValueSink *sink)
+{
+    reset();
+
+    const uchar *data = reinterpret_cast<const uchar *>(payload.constData());
+    if (payload.size() < kHeaderSize) {
+        return fail("truncated header", 0);
+    }
+    if (memcmp(data, "SCPK", 4) != 0) {
+        return fail("bad magic", 0);
+    }
+    if (data[4] != kVersion) {
+        return fail("unsupported version", 4);
+    }
+
+    // 记录个数必须与报文长度一致，之后逐条读取不再检查边界
+    quint32 count = qFromLittleEndian<quint32>(data + 8);
+    if (quint64(payload.size() - kHeaderSize) != quint64(count) * kRecordSize) {
+        return fail("record count does not match payload size", 8);
+    }
+    m_hasBody = true;
+
+    qint64 timestamp = qFromLittleEndian<qint64>(data + 12);
+    if (timestamp > 0) {
+        char digits[24];
+        sink->onTimestamp(digits, formatUnsigned(quint64(timestamp), digits));
+    }
+
+    const uchar *record = data + kHeaderSize;
+    for (quint32 i = 0; i < count; ++i) {
+        quint32 addr = qFromLittleEndian<quint32>(record);
+        quint64 bits = qFromLittleEndian<quint64>(record + 4);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+
+        // 与JSON解码器一致：超出int范围的地址取0
+        sink->onSample(addr <= quint32(INT_MAX) ? int(addr) : 0, TagValue::fromDouble(value), TagDouble);
+        record += kRecordSize;
+    }
+    m_sampleCount = int(count);
+    return true;
+}
+
+bool PackedValueDecoder::fail(const char *error, int offset)
+{
+    m_error = error;
+    m_errorOffset = offset;
+    return false;
+}
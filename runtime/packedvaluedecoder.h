@@ -0,0 +1,34 @@
+#ifndef PACKEDVALUEDECODER_H
+#define PACKEDVALUEDECODER_H
+
+#include "valuedecoder.h"
+
+/**
+ * @brief 定长记录数据报文的解码器
+ * 面向高频数据源，所有字段为小端序，记录之间没有分隔：
+ *
+ *   偏移  类型      内容
+ *   0     char[4]   "SCPK"
+ *   4     quint8    版本，当前为1
+ *   5     quint8    保留，填0
+ *   6     quint16   保留，填0
+ *   8     quint32   记录个数
+ *   12    qint64    时间戳（Unix毫秒），0表示没有
+ *   20    记录数组，每条12字节：quint32 地址 + float64 数值
+ *
+ * 数值一律为TagDouble，按变量的类型转换
+ */
+class PackedValueDecoder : public ValueDecoder
+{
+public:
+    static const int kHeaderSize = 20;  // 报文头大小
+    static const int kRecordSize = 12;  // 每条记录的大小
+    static const quint8 kVersion = 1;   // 格式版本
+
+    bool decode(const QByteArray &payload, ValueSink *sink) override;
+
+private:
+    bool fail(const char *error, int offset);
+};
+
+#endif // PACKEDVALUEDECODER_H
@@ -0,0 +1,117 @@
+#include "perfhud.h"
+#include <QPainter>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QStringList>
+
+namespace {
+const int kMargin = 8;      // 浮层与视口边缘的距离
+const int kPadding = 6;     // 文字与浮层边缘的距离
+}
+
+PerfHud::PerfHud()
+    : m_hasLast(false)
+{
+    resetInterval();
+}
+
+void PerfHud::addFrame(qint64 paintNs, qint64 latencyNs)
+{
+    ++m_frames;
+    m_paintTotal += paintNs;
+    m_paintMax = qMax(m_paintMax, paintNs);
+    if (latencyNs >= 0) {
+        ++m_latencyCount;
+        m_latencyTotal += latencyNs;
+        m_latencyMax = qMax(m_latencyMax, latencyNs);
+    }
+}
+
+void PerfHud::update(const PerfCounters &counters, qreal devicePixelRatio)
+{
+    double seconds = m_interval.isValid() ? m_interval.nsecsElapsed() / 1e9 : 0.0;
+    if (seconds <= 0.0) {
+        seconds = 1.0;
+    }
+
+    // 第一个周期没有基准计数，速率显示为0
+    PerfCounters last = m_hasLast ? m_last : counters;
+    double messageRate = (counters.messages - last.messages) / seconds;
+    double sampleRate = (counters.samples - last.samples) / seconds;
+    qint64 updates = counters.updates - last.updates;
+
+    QStringList lines;
+    lines << QString::asprintf("FPS        %7.1f", m_frames / seconds);
+    lines << QString::asprintf("Msgs/s     %7.0f", messageRate);
+    lines << QString::asprintf("Samples/s  %7.0f", sampleRate);
+    // 合并比：收到的数据点数与实际刷新到组件的次数之比
+    if (updates > 0) {
+        lines << QString::asprintf("Conflation %7.1f:1", (counters.samples - last.samples) / double(updates));
+    } else {
+        lines << QStringLiteral("Conflation       -");
+    }
+    if (counters.queueCapacity > 0) {
+        lines << QString::asprintf("Queue      %7d peak %d/%d",
+                                   counters.queueDepth, counters.queuePeak, counters.queueCapacity);
+    } else {
+        lines << QStringLiteral("Queue            -");
+    }
+    if (m_frames > 0) {
+        lines << QString::asprintf("Paint      %7.2f ms max %.2f",
+                                   m_paintTotal / 1e6 / m_frames, m_paintMax / 1e6);
+    } else {
+        lines << QStringLiteral("Paint            -");
+    }
+    if (m_latencyCount > 0) {
+        lines << QString::asprintf("Latency    %7.1f ms max %.1f",
+                                   m_latencyTotal / 1e6 / m_latencyCount, m_latencyMax / 1e6);
+    } else {
+        lines << QStringLiteral("Latency          -");
+    }
+
+    // 文字渲染到缓存图片，绘制时只需贴图
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    QFontMetrics metrics(font);
+    int width = 0;
+    for (const QString &line : lines) {
+        width = qMax(width, metrics.horizontalAdvance(line));
+    }
+    QSize size(width + 2 * kPadding, metrics.lineSpacing() * lines.size() + 2 * kPadding);
+
+    m_pixmap = QPixmap(size * devicePixelRatio);
+    m_pixmap.setDevicePixelRatio(devicePixelRatio);
+    m_pixmap.fill(QColor(0, 0, 0, 160));
+    {
+        QPainter painter(&m_pixmap);
+        painter.setFont(font);
+        painter.setPen(Qt::white);
+        int y = kPadding + metrics.ascent();
+        for (const QString &line : lines) {
+            painter.drawText(kPadding, y, line);
+            y += metrics.lineSpacing();
+        }
+    }
+    m_rect = QRect(QPoint(kMargin, kMargin), size);
+
+    m_last = counters;
+    m_hasLast = true;
+    resetInterval();
+}
+
+void PerfHud::draw(QPainter *painter) const
+{
+    if (!m_pixmap.isNull()) {
+        painter->drawPixmap(m_rect.topLeft(), m_pixmap);
+    }
+}
+
+void PerfHud::resetInterval()
+{
+    m_interval.start();
+    m_frames = 0;
+    m_paintTotal = 0;
+    m_paintMax = 0;
+    m_latencyCount = 0;
+    m_latencyTotal = 0;
+    m_latencyMax = 0;
+}
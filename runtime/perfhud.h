@@ -0,0 +1,62 @@
+#ifndef PERFHUD_H
+#define PERFHUD_H
+
+#include <QPixmap>
+#include <QRect>
+#include <QElapsedTimer>
+
+class QPainter;
+
+/**
+ * @brief 性能浮层的累计计数
+ * 由RuntimeViewer每秒采集一次，计数为累计值，速率由相邻两次的差值计算
+ */
+struct PerfCounters {
+    qint64 messages = 0;    // 累计收到的报文数
+    qint64 samples = 0;     // 累计收到的数据点数
+    qint64 updates = 0;     // 累计刷新到组件的变量次数（合并之后）
+    int queueDepth = 0;     // 采集队列当前长度
+    int queuePeak = 0;      // 本周期内采集队列的最大长度
+    int queueCapacity = 0;  // 采集队列容量，0表示未使用采集线程
+};
+
+/**
+ * @brief 运行时性能浮层
+ * 统计帧率、报文和数据点速率、合并比、采集队列深度、绘制耗时和接收到显示的延迟。
+ * 文字每秒只渲染一次到缓存图片，每帧只贴一次图，打开浮层不会明显改变被测数据
+ */
+class PerfHud
+{
+public:
+    PerfHud();
+
+    // 记录一帧绘制，latencyNs小于0表示本帧没有新数据
+    void addFrame(qint64 paintNs, qint64 latencyNs);
+
+    // 计算本周期的统计值并重新渲染文字（每秒调用一次）
+    void update(const PerfCounters &counters, qreal devicePixelRatio);
+
+    // 浮层在视口中的位置
+    const QRect &rect() const { return m_rect; }
+
+    // 在视口坐标系中绘制
+    void draw(QPainter *painter) const;
+
+private:
+    void resetInterval();
+
+    QPixmap m_pixmap;           // 渲染好的文字
+    QRect m_rect;               // 浮层在视口中的位置
+    QElapsedTimer m_interval;   // 本统计周期的起点
+    PerfCounters m_last;        // 上一周期结束时的计数
+    bool m_hasLast;             // 是否已有上一周期
+
+    int m_frames;               // 本周期绘制的帧数
+    qint64 m_paintTotal;        // 本周期绘制耗时合计（纳秒）
+    qint64 m_paintMax;          // 本周期最长绘制耗时
+    int m_latencyCount;         // 本周期带新数据的帧数
+    qint64 m_latencyTotal;      // 本周期接收到显示的延迟合计
+    qint64 m_latencyMax;        // 本周期最大延迟
+};
+
+#endif // PERFHUD_H
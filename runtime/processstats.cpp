@@ -0,0 +1,73 @@
+#include "processstats.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+namespace ProcessStats {
+
+qint64 cpuTimeUs()
+{
+#if defined(Q_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    // FILETIME单位为100纳秒
+    auto toUs = [](const FILETIME &time) {
+        return ((qint64(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10;
+    };
+    return toUs(kernel) + toUs(user);
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return qint64(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+            + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#else
+    return 0;
+#endif
+}
+
+qint64 residentBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return qint64(counters.WorkingSetSize);
+#elif defined(Q_OS_LINUX)
+    // /proc/self/statm的第二项为常驻页数
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    long size = 0;
+    long resident = 0;
+    int count = fscanf(file, "%ld %ld", &size, &resident);
+    fclose(file);
+    return count == 2 ? qint64(resident) * sysconf(_SC_PAGESIZE) : 0;
+#elif defined(Q_OS_UNIX)
+    // 其他Unix只能取得峰值
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(Q_OS_MACOS)
+    return qint64(usage.ru_maxrss);
+#else
+    return qint64(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+}
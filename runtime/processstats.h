@@ -0,0 +1,19 @@
+#ifndef PROCESSSTATS_H
+#define PROCESSSTATS_H
+
+#include <QtGlobal>
+
+/**
+ * @brief 当前进程的资源占用
+ */
+namespace ProcessStats {
+
+// 进程累计占用的CPU时间（用户态+内核态，微秒）
+qint64 cpuTimeUs();
+
+// 常驻内存（字节），无法获取时返回0
+qint64 residentBytes();
+
+}
+
+#endif // PROCESSSTATS_H
@@ -1,4 +1,4 @@
-QT       += core gui widgets xml mqtt
+QT       += core gui widgets xml mqtt network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -23,11 +23,72 @@ LIBS += -L$$QTDIR/lib
 SOURCES += \
     main.cpp \
     runtimeviewer.cpp \
-    mqttcomm.cpp
+    datasource.cpp \
+    mqttcomm.cpp \
+    modbussource.cpp \
+    jsonvaluedecoder.cpp \
+    cborvaluedecoder.cpp \
+    packedvaluedecoder.cpp \
+    sparkplugdecoder.cpp \
+    sparkplugencoder.cpp \
+    tagtable.cpp \
+    tagvalue.cpp \
+    topictrie.cpp \
+    subscriptionmanager.cpp \
+    bindingtable.cpp \
+    valuedisplayitem.cpp \
+    scenefile.cpp \
+    runtimeview.cpp \
+    perfhud.cpp \
+    latencyhistogram.cpp \
+    latencytracker.cpp \
+    metricsregistry.cpp \
+    metricsserver.cpp \
+    processstats.cpp \
+    ../common/trace.cpp \
+    ../common/logcategories.cpp \
+    ../common/asynclogger.cpp
 
 HEADERS += \
     runtimeviewer.h \
-    mqttcomm.h
+    datasource.h \
+    mqttcomm.h \
+    modbussource.h \
+    valuesink.h \
+    valuedecoder.h \
+    jsonvaluedecoder.h \
+    cborvaluedecoder.h \
+    packedvaluedecoder.h \
+    sparkplugdecoder.h \
+    sparkplugencoder.h \
+    tagtable.h \
+    tagvalue.h \
+    topictrie.h \
+    subscriptionmanager.h \
+    bindingtable.h \
+    valuedisplayitem.h \
+    samplering.h \
+    runtimeoptions.h \
+    scenefile.h \
+    runtimeview.h \
+    perfhud.h \
+    latencyhistogram.h \
+    latencytracker.h \
+    metricsregistry.h \
+    metricsserver.h \
+    processstats.h \
+    ../common/trace.h \
+    ../common/logcategories.h \
+    ../common/asynclogger.h
+
+INCLUDEPATH += $$PWD/../common
+
+win32 {
+    LIBS += -lpsapi
+}
+
+# 定义SCADA_NO_TRACE可在编译期去掉所有性能跟踪点
+#DEFINES += SCADA_NO_TRACE
 
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated
@@ -0,0 +1,37 @@
+#ifndef RUNTIMEOPTIONS_H
+#define RUNTIMEOPTIONS_H
+
+#include <QString>
+#include <QSize>
+
+/**
+ * @brief 运行时启动选项
+ * 由命令行解析得到，传给RuntimeViewer
+ */
+struct RuntimeOptions {
+    QString brokerHost = "mqtt.eclipseprojects.io";  // MQTT服务器地址
+    quint16 brokerPort = 1883;      // MQTT服务器端口
+    QString clientId;               // MQTT客户端ID，持久会话靠它找回订阅
+    bool cleanSession = true;       // 每次连接使用新会话，只有指定了固定客户端ID时才使用持久会话
+    bool ingestThread = false;      // 数据源的接收和解码运行在独立的采集线程
+    int wildcardMinTopics = 16;     // 同一层级下的绑定主题达到该个数时改用"+"通配符订阅，0表示不合并
+    int modbusPollInterval = 100;   // Modbus轮询间隔（毫秒）
+    int modbusMaxGap = 0;           // Modbus块读允许跨过的未绑定寄存器个数，0表示只合并相邻寄存器
+    int modbusPipeline = 8;         // 每个Modbus连接上同时未返回的请求数上限
+    int maxFps = 60;                // 显示刷新的最高帧率
+    bool fullViewportUpdate = false;    // 每帧重绘整个视图（默认只重绘变化区域）
+    bool headless = false;          // 无窗口运行，错误只输出到日志
+    QString snapshotFile;           // 快照输出的PNG文件，为空时不生成快照
+    int snapshotInterval = 1000;    // 快照间隔（毫秒）
+    QSize snapshotSize = QSize(1920, 1080);    // 快照分辨率
+    QString traceFile;              // 性能跟踪输出文件，为空时不跟踪
+    bool showHud = false;           // 启动时显示性能浮层（F10切换）
+    QString latencyReportFile;      // 端到端延迟统计的输出文件，为空时只写日志
+    int latencyReportInterval = 0;  // 定时输出延迟统计的间隔（秒），0表示只在F11和退出时输出
+    int latencyBudget = 250;        // 显示延迟预算（毫秒）
+    QString metricsFile;            // 指标定时写入的文件（Prometheus文本格式），为空时不写
+    int metricsInterval = 10;       // 指标文件的写入间隔（秒）
+    quint16 metricsPort = 0;        // 指标HTTP导出端口（只监听本机），0表示不开启
+};
+
+#endif // RUNTIMEOPTIONS_H
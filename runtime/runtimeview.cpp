@@ -0,0 +1,66 @@
+#include "runtimeview.h"
+#include "perfhud.h"
+#include "latencytracker.h"
+#include "trace.h"
+#include <QPaintEvent>
+
+RuntimeView::RuntimeView(QGraphicsScene *scene, QWidget *parent)
+    : QGraphicsView(scene, parent)
+    , m_hud(nullptr)
+    , m_receiveTime(0)
+    , m_latency(nullptr)
+{
+}
+
+void RuntimeView::setHud(PerfHud *hud)
+{
+    m_hud = hud;
+    m_receiveTime = 0;
+    viewport()->update();
+}
+
+void RuntimeView::setReceiveTime(qint64 receiveTime)
+{
+    // 上一次的数据还没有显示时保留更早的时间
+    if (m_receiveTime == 0) {
+        m_receiveTime = receiveTime;
+    }
+}
+
+void RuntimeView::paintEvent(QPaintEvent *event)
+{
+    TRACE_SCOPE("RuntimeView::paint");
+    if (!m_hud) {
+        QGraphicsView::paintEvent(event);
+        if (m_latency && m_latency->hasUnpainted()) {
+            m_latency->painted();
+        }
+        return;
+    }
+
+    qint64 start = Trace::now();
+    QGraphicsView::paintEvent(event);
+    qint64 end = Trace::now();
+
+    // 只重绘浮层本身的刷新不计入帧数，也不代表数据已经显示
+    if (m_hud->rect().contains(event->rect())) {
+        return;
+    }
+    if (m_latency && m_latency->hasUnpainted()) {
+        m_latency->painted();
+    }
+    m_hud->addFrame(end - start, m_receiveTime ? end - m_receiveTime : -1);
+    m_receiveTime = 0;
+}
+
+void RuntimeView::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsView::drawForeground(painter, rect);
+    if (m_hud) {
+        // 浮层固定在视口左上角，不随场景缩放
+        painter->save();
+        painter->resetTransform();
+        m_hud->draw(painter);
+        painter->restore();
+    }
+}
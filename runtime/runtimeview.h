@@ -0,0 +1,40 @@
+#ifndef RUNTIMEVIEW_H
+#define RUNTIMEVIEW_H
+
+#include <QGraphicsView>
+
+class PerfHud;
+class LatencyTracker;
+
+/**
+ * @brief 运行时视图
+ * 在QGraphicsView的基础上为每次绘制记录跟踪点，
+ * 打开性能浮层时统计绘制耗时和接收到显示的延迟，并在前景绘制浮层；
+ * 每次绘制完成后为已应用的数据记录paint阶段的端到端延迟
+ */
+class RuntimeView : public QGraphicsView
+{
+    Q_OBJECT
+public:
+    explicit RuntimeView(QGraphicsScene *scene, QWidget *parent = nullptr);
+
+    // 设置性能浮层，nullptr表示关闭
+    void setHud(PerfHud *hud);
+
+    // 本帧数据中最早一条报文的接收时间（Trace::now），下一次绘制时计算延迟
+    void setReceiveTime(qint64 receiveTime);
+
+    // 设置端到端延迟统计
+    void setLatencyTracker(LatencyTracker *latency) { m_latency = latency; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
+
+private:
+    PerfHud *m_hud;         // 性能浮层
+    qint64 m_receiveTime;   // 尚未显示的最早接收时间，0表示没有
+    LatencyTracker *m_latency;  // 端到端延迟统计
+};
+
+#endif // RUNTIMEVIEW_H
@@ -5,36 +5,109 @@
 #include <QJsonArray>
 #include <QTimer>
 #include <QMessageBox>
+#include <QImage>
+#include <QPainter>
+#include <QSaveFile>
 #include <QGraphicsScene>
 #include <QGraphicsRectItem>
 #include <QGraphicsEllipseItem>
-#include <QGraphicsTextItem>
+#include "valuedisplayitem.h"
+#include "scenefile.h"
+#include "trace.h"
+#include "logcategories.h"
+#include <QShortcut>
 #include <QDateTime>
 #include <QMap>
+#include <QHash>
 #include "mqttcomm.h"
+#include "metricsserver.h"
+#include "processstats.h"
 
-RuntimeViewer::RuntimeViewer(const QString &sceneFile, QWidget *parent)
+namespace {
+const qreal kStaticLayer = 0;      // 静态组件所在层
+const qreal kValueLayer = 1;       // 数值显示组件单独一层，位于静态组件之上
+const int kRingCapacity = 65536;   // 采集队列容量（数据点个数）
+const int kDrainBatch = 256;       // 每次从队列取出的数据点个数
+const char kModbusScheme[] = "modbus://";      // Modbus数据源的主题前缀
+}
+
+RuntimeViewer::RuntimeViewer(const QString &sceneFile, const RuntimeOptions &options, QWidget *parent)
     : QMainWindow(parent)
+    , m_mqtt(nullptr)
+    , m_options(options)
+    , m_ring(nullptr)
+    , m_ingestThread(nullptr)
+    , m_frameInterval(1000 / qMax(1, options.maxFps))
+    , m_snapshotTimer(nullptr)
+    , m_hud(nullptr)
+    , m_hudTimer(nullptr)
+    , m_appliedUpdates(0)
+    , m_frames(0)
+    , m_queuePeak(0)
+    , m_latencyTimer(nullptr)
+    , m_metricsTimer(nullptr)
+    , m_sceneItems(0)
+    , m_boundTags(0)
 {
     // 创建场景和视图
     m_scene = new QGraphicsScene(this);
-    m_view = new QGraphicsView(m_scene);
+    m_view = new RuntimeView(m_scene);
     m_view->setRenderHint(QPainter::Antialiasing);
-    m_view->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    // 默认只重绘变化区域；静态组件使用设备坐标缓存，数值变化时只需少量贴图
+    m_view->setViewportUpdateMode(options.fullViewportUpdate
+                                  ? QGraphicsView::FullViewportUpdate
+                                  : QGraphicsView::MinimalViewportUpdate);
+    m_view->setOptimizationFlag(QGraphicsView::DontSavePainterState);
     m_view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     m_view->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setCentralWidget(m_view);
 
-    // 创建定时器
-    m_updateTimer = new QTimer(this);
-    connect(m_updateTimer, &QTimer::timeout, this, &RuntimeViewer::updateValues);
-    m_updateTimer->start(1000);  // 每秒更新一次
+    // 无窗口运行时不绘制，只统计到dispatch阶段
+    m_latency.setPaintTracking(!options.headless);
+    m_view->setLatencyTracker(&m_latency);
+
+    // 显示刷新定时器：由数据变化触发，不做周期轮询，空闲时不唤醒
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setSingleShot(true);
+    connect(m_frameTimer, &QTimer::timeout, this, &RuntimeViewer::applyPendingChanges);
 
     // 加载场景
     loadScene(sceneFile);
 
-    // 设置MQTT连接
-    setupMqtt();
+    // F9开始或停止性能跟踪
+    if (!options.traceFile.isEmpty()) {
+        QShortcut *traceShortcut = new QShortcut(QKeySequence(Qt::Key_F9), this);
+        connect(traceShortcut, &QShortcut::activated, this, &RuntimeViewer::toggleTrace);
+    }
+
+    // F10显示或隐藏性能浮层
+    QShortcut *hudShortcut = new QShortcut(QKeySequence(Qt::Key_F10), this);
+    connect(hudShortcut, &QShortcut::activated, this, &RuntimeViewer::toggleHud);
+    if (options.showHud) {
+        toggleHud();
+    }
+
+    // F11输出端到端延迟统计，也可以按间隔定时输出
+    QShortcut *latencyShortcut = new QShortcut(QKeySequence(Qt::Key_F11), this);
+    connect(latencyShortcut, &QShortcut::activated, this, &RuntimeViewer::reportLatency);
+    if (options.latencyReportInterval > 0) {
+        m_latencyTimer = new QTimer(this);
+        connect(m_latencyTimer, &QTimer::timeout, this, &RuntimeViewer::reportLatency);
+        m_latencyTimer->start(options.latencyReportInterval * 1000);
+    }
+
+    // 定时渲染快照，不依赖窗口是否显示
+    if (!options.snapshotFile.isEmpty()) {
+        m_snapshotTimer = new QTimer(this);
+        connect(m_snapshotTimer, &QTimer::timeout, this, &RuntimeViewer::renderSnapshot);
+        m_snapshotTimer->start(qMax(1, options.snapshotInterval));
+    }
+
+    // 创建数据源并开始采集
+    setupSources();
+
+    // 运行时指标导出
+    setupMetrics();
 
     // 设置窗口属性
     setWindowTitle(tr("运行时查看器"));
@@ -43,19 +116,42 @@ RuntimeViewer::RuntimeViewer(const QString &sceneFile, QWidget *parent)
 
 RuntimeViewer::~RuntimeViewer()
 {
-    if (m_updateTimer) {
-        m_updateTimer->stop();
+    m_frameTimer->stop();
+
+    // 退出时写出仍在记录的跟踪
+    if (Trace::isEnabled()) {
+        toggleTrace();
+    }
+
+    // 停止采集线程，数据源随线程结束删除
+    if (m_ingestThread) {
+        m_ingestThread->quit();
+        m_ingestThread->wait();
     }
+
+    // 指定了输出文件时在退出时写出最终的延迟统计
+    if (!m_options.latencyReportFile.isEmpty()) {
+        reportLatency();
+    }
+    delete m_ring;
+    delete m_hud;
 }
 
 void RuntimeViewer::loadScene(const QString &fileName)
 {
+    TRACE_SCOPE("RuntimeViewer::loadScene");
+
+    // 编译场景直接映射加载，无需解析JSON
+    if (SceneFile::isCompiled(fileName)) {
+        loadCompiledScene(fileName);
+        return;
+    }
+
     QFile file(fileName);
     if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::critical(this, tr("错误"),
-                            tr("无法打开场景文件：%1\n%2")
-                            .arg(fileName)
-                            .arg(file.errorString()));
+        reportError(tr("无法打开场景文件：%1\n%2")
+                    .arg(fileName)
+                    .arg(file.errorString()));
         return;
     }
 
@@ -63,16 +159,14 @@ void RuntimeViewer::loadScene(const QString &fileName)
     QJsonParseError jsonError;
     QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &jsonError);
     if (doc.isNull()) {
-        QMessageBox::critical(this, tr("错误"),
-                            tr("解析场景文件失败：%1\n%2")
-                            .arg(fileName)
-                            .arg(jsonError.errorString()));
+        reportError(tr("解析场景文件失败：%1\n%2")
+                    .arg(fileName)
+                    .arg(jsonError.errorString()));
         return;
     }
 
-    // 清除现有场景
-    m_scene->clear();
-    m_valueAddresses.clear();
+    // 清除现有场景（变量ID随场景重新分配，须在启动采集之前完成）
+    clearScene();
 
     // 重建场景
     QJsonObject sceneObject = doc.object();
@@ -80,54 +174,121 @@ void RuntimeViewer::loadScene(const QString &fileName)
 
     for (const QJsonValue &value : itemsArray) {
         QJsonObject itemObject = value.toObject();
-        QString itemType = itemObject["itemType"].toString();
-        qreal x = itemObject["x"].toDouble();
-        qreal y = itemObject["y"].toDouble();
-        qreal width = itemObject["width"].toDouble();
-        qreal height = itemObject["height"].toDouble();
-
-        QGraphicsItem *item = nullptr;
-
-        if (itemType == "ValueDisplay") {
-            // 创建数值显示组件
-            QGraphicsRectItem *rectItem = new QGraphicsRectItem(0, 0, width, height);
-            rectItem->setPos(x, y);
-            
-            // 添加文本显示
-            QGraphicsTextItem *textItem = new QGraphicsTextItem(rectItem);
-            textItem->setPlainText("0.0");
-            textItem->setDefaultTextColor(Qt::black);
-            textItem->setPos(10, 10);
-            
-            m_scene->addItem(rectItem);
-            item = rectItem;
-
-            // 保存地址映射
-            if (itemObject.contains("binding")) {
-                QJsonObject bindingObject = itemObject["binding"].toObject();
-                QString address = bindingObject["address"].toString();
-                if (!address.isEmpty()) {
-                    m_valueAddresses[rectItem] = address;
-                }
+        SceneItemType type = SceneFile::itemType(itemObject["itemType"].toString());
+
+        // (主题, 地址)在加载时即转换为变量ID
+        int tag = -1;
+        if (type == SceneItemValueDisplay && itemObject.contains("binding")) {
+            QJsonObject bindingObject = itemObject["binding"].toObject();
+            QString address = bindingObject["address"].toString();
+            if (!address.isEmpty()) {
+                tag = m_tags.intern(SceneFile::bindingTopic(bindingObject), address,
+                                    tagTypeFromName(bindingObject["dataType"].toString()));
             }
         }
-        else if (itemType == "Rectangle") {
-            QGraphicsRectItem *rectItem = new QGraphicsRectItem(0, 0, width, height);
-            rectItem->setPos(x, y);
-            m_scene->addItem(rectItem);
-            item = rectItem;
-        }
-        else if (itemType == "Ellipse") {
-            QGraphicsEllipseItem *ellipseItem = new QGraphicsEllipseItem(0, 0, width, height);
-            ellipseItem->setPos(x, y);
-            m_scene->addItem(ellipseItem);
-            item = ellipseItem;
+
+        addSceneItem(type,
+                     itemObject["x"].toDouble(),
+                     itemObject["y"].toDouble(),
+                     itemObject["width"].toDouble(),
+                     itemObject["height"].toDouble(),
+                     tag);
+    }
+
+    finishScene();
+}
+
+void RuntimeViewer::loadCompiledScene(const QString &fileName)
+{
+    SceneFile sceneFile;
+    if (!sceneFile.open(fileName)) {
+        reportError(tr("无法打开场景文件：%1\n%2")
+                    .arg(fileName)
+                    .arg(sceneFile.errorString()));
+        return;
+    }
+
+    // open已校验文件，之后才清除现有场景
+    clearScene();
+
+    // 按文件中的顺序登记(主题, 地址)，open保证没有重复，变量ID与编译时分配的一致
+    for (int tag = 0; tag < sceneFile.tagCount(); ++tag) {
+        m_tags.intern(sceneFile.tagTopic(tag), sceneFile.tagAddress(tag), sceneFile.tagType(tag));
+    }
+
+    // 组件记录为定长结构，直接从映射内存读取
+    for (int i = 0; i < sceneFile.itemCount(); ++i) {
+        const SceneItemRecord &record = sceneFile.item(i);
+        addSceneItem(SceneItemType(record.type),
+                     record.x, record.y, record.width, record.height,
+                     record.tag);
+    }
+
+    finishScene();
+}
+
+void RuntimeViewer::clearScene()
+{
+    m_scene->clear();
+    m_tags.clear();
+    m_bindings.clear();
+}
+
+void RuntimeViewer::addSceneItem(SceneItemType type, qreal x, qreal y, qreal width, qreal height, int tag)
+{
+    QGraphicsItem *item = nullptr;
+
+    if (type == SceneItemValueDisplay) {
+        // 创建数值显示组件
+        ValueDisplayItem *displayItem = new ValueDisplayItem(width, height);
+        displayItem->setPos(x, y);
+        displayItem->setZValue(kValueLayer);
+
+        m_scene->addItem(displayItem);
+        item = displayItem;
+
+        // 登记绑定
+        if (tag >= 0) {
+            ValueBinding binding;
+            binding.display = displayItem;
+            m_bindings.add(tag, binding);
         }
+    }
+    else if (type == SceneItemRectangle) {
+        QGraphicsRectItem *rectItem = new QGraphicsRectItem(0, 0, width, height);
+        rectItem->setPos(x, y);
+        rectItem->setZValue(kStaticLayer);
+        rectItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+        m_scene->addItem(rectItem);
+        item = rectItem;
+    }
+    else if (type == SceneItemEllipse) {
+        QGraphicsEllipseItem *ellipseItem = new QGraphicsEllipseItem(0, 0, width, height);
+        ellipseItem->setPos(x, y);
+        ellipseItem->setZValue(kStaticLayer);
+        ellipseItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+        m_scene->addItem(ellipseItem);
+        item = ellipseItem;
+    }
+
+    if (item) {
+        // 运行时组件不可移动和选择
+        item->setFlag(QGraphicsItem::ItemIsMovable, false);
+        item->setFlag(QGraphicsItem::ItemIsSelectable, false);
+    }
+}
+
+void RuntimeViewer::finishScene()
+{
+    // 按变量ID整理绑定表
+    m_bindings.compile(m_tags.size());
 
-        if (item) {
-            // 运行时组件不可移动和选择
-            item->setFlag(QGraphicsItem::ItemIsMovable, false);
-            item->setFlag(QGraphicsItem::ItemIsSelectable, false);
+    // 场景规模只在加载时统计，指标导出时不遍历场景
+    m_sceneItems = m_scene->items().size();
+    m_boundTags = 0;
+    for (int tag = 0; tag < m_bindings.tagCount(); ++tag) {
+        if (m_bindings.begin(tag) != m_bindings.end(tag)) {
+            ++m_boundTags;
         }
     }
 
@@ -136,63 +297,418 @@ void RuntimeViewer::loadScene(const QString &fileName)
     m_view->fitInView(m_scene->sceneRect(), Qt::KeepAspectRatio);
 }
 
-void RuntimeViewer::setupMqtt()
+void RuntimeViewer::setupSources()
+{
+    // 采集线程模式下数据源没有父对象，随线程结束删除
+    QObject *owner = m_options.ingestThread ? nullptr : this;
+
+    // 主题为modbus://的绑定由对应服务器的Modbus数据源轮询，其余的绑定由MQTT接收
+    QVector<int> mqttTags;
+    QHash<QString, ModbusSource *> modbusServers;
+    for (int tag = 0; tag < m_tags.size(); ++tag) {
+        const QString &address = m_tags.address(tag);
+        const QString &topic = m_tags.topic(tag);
+        if (topic.startsWith(QLatin1String(kModbusScheme))) {
+            QString host;
+            quint16 port;
+            quint8 unit;
+            if (!ModbusSource::parseUrl(topic, &host, &port, &unit)) {
+                qCWarning(lcRuntime) << "Invalid Modbus source:" << topic;
+                continue;
+            }
+            ModbusSource *&source = modbusServers[host + ':' + QString::number(port)];
+            if (!source) {
+                source = new ModbusSource(&m_tags, host, port, owner);
+                source->setPollInterval(m_options.modbusPollInterval);
+                source->setMaxGap(m_options.modbusMaxGap);
+                source->setPipelineDepth(m_options.modbusPipeline);
+                m_modbus.append(source);
+            }
+            if (!source->addTag(tag, unit)) {
+                qCWarning(lcRuntime) << "Invalid Modbus register address:" << address << "on" << topic;
+            }
+            qCDebug(lcRuntime) << "Mapping address:" << address << "to Modbus source:" << topic;
+            continue;
+        }
+
+        mqttTags.append(tag);
+        qCDebug(lcRuntime) << "Mapping address:" << address << "to topic:" << topic;
+    }
+
+    // 只有Modbus变量时不连接MQTT服务器
+    if (!mqttTags.isEmpty() || m_modbus.isEmpty()) {
+        m_mqtt = new MqttComm(&m_tags, owner);
+        // 登记变量并只订阅场景用到的主题
+        m_mqtt->setTags(mqttTags, m_options.wildcardMinTopics);
+        m_mqtt->setSession(m_options.clientId, m_options.cleanSession);
+        m_mqtt->setBroker(m_options.brokerHost, m_options.brokerPort);
+        m_sources.append(m_mqtt);
+    }
+    for (ModbusSource *source : m_modbus) {
+        m_sources.append(source);
+    }
+    for (DataSource *source : m_sources) {
+        source->setLatencyTracker(&m_latency);
+    }
+
+    if (m_options.ingestThread) {
+        // 变量登记完成后再把数据源移到采集线程。
+        // 队列只允许一个生产者，所有数据源共用同一个采集线程
+        m_ring = new SampleRing(kRingCapacity);
+        m_ingestThread = new QThread(this);
+        m_ingestThread->setObjectName("Ingest");
+        connect(m_ingestThread, &QThread::started, []() {
+            Trace::setThreadName("Ingest");
+        });
+        for (DataSource *source : m_sources) {
+            source->setSampleRing(m_ring);
+            source->moveToThread(m_ingestThread);
+            connect(m_ingestThread, &QThread::finished, source, &QObject::deleteLater);
+            // 队列由空变为非空时唤醒界面线程
+            connect(source, &DataSource::samplesReady,
+                    this, &RuntimeViewer::scheduleFrame, Qt::QueuedConnection);
+        }
+        m_ingestThread->start();
+
+        // 在采集线程中开始采集
+        for (DataSource *source : m_sources) {
+            QMetaObject::invokeMethod(source, [source]() {
+                source->start();
+            }, Qt::QueuedConnection);
+        }
+        return;
+    }
+
+    for (DataSource *source : m_sources) {
+        source->start();
+        // 有变化时安排下一帧刷新
+        connect(source, &DataSource::valuesChanged,
+                this, &RuntimeViewer::scheduleFrame);
+    }
+}
+
+void RuntimeViewer::handleValueChanged(int tag, TagValue value)
+{
+    if (tag >= m_bindings.tagCount()) {
+        return;
+    }
+
+    TagType type = m_tags.type(tag);
+    // 只访问绑定到该变量的组件
+    for (const ValueBinding *binding = m_bindings.begin(tag); binding != m_bindings.end(tag); ++binding) {
+        binding->display->setValue(value, type, binding->format);
+    }
+}
+
+void RuntimeViewer::reportError(const QString &text)
+{
+    if (m_options.headless) {
+        qCWarning(lcRuntime).noquote() << text;
+        return;
+    }
+    QMessageBox::critical(this, tr("错误"), text);
+}
+
+void RuntimeViewer::renderSnapshot()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 场景按比例缩放到快照分辨率，与窗口大小无关
+    QImage image(m_options.snapshotSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        m_scene->render(&painter, QRectF(image.rect()), m_scene->sceneRect(), Qt::KeepAspectRatio);
+    }
+    qint64 renderTime = timer.nsecsElapsed();
+
+    // 先写临时文件再替换，读取快照的一方不会看到写了一半的图片
+    QSaveFile file(m_options.snapshotFile);
+    if (!file.open(QIODevice::WriteOnly) || !image.save(&file, "PNG") || !file.commit()) {
+        qCWarning(lcRuntime) << "Failed to write snapshot:" << m_options.snapshotFile << file.errorString();
+        return;
+    }
+    qint64 totalTime = timer.nsecsElapsed();
+
+    qCInfo(lcRuntime, "Snapshot %dx%d rendered in %.2f ms, saved in %.2f ms",
+           image.width(), image.height(),
+           renderTime / 1e6, (totalTime - renderTime) / 1e6);
+}
+
+void RuntimeViewer::toggleTrace()
 {
-    m_mqtt = new MqttComm(this);
-    
-    // 连接到MQTT服务器
-    m_mqtt->connectToBroker("mqtt.eclipseprojects.io", 1883);
+    if (!Trace::isEnabled()) {
+        Trace::setEnabled(true);
+        qCInfo(lcRuntime) << "Tracing started";
+        return;
+    }
+
+    Trace::setEnabled(false);
+    QString errorString;
+    if (Trace::writeChromeTrace(m_options.traceFile, &errorString)) {
+        qCInfo(lcRuntime) << "Trace written to" << m_options.traceFile;
+    } else {
+        qCWarning(lcRuntime) << "Failed to write trace:" << m_options.traceFile << errorString;
+    }
+}
 
-    // 创建地址到主题的映射
-    QMap<QString, QString> addressTopicMap;
-    for (auto it = m_valueAddresses.begin(); it != m_valueAddresses.end(); ++it) {
-        QString address = it.value();
-        // 所有变量使用同一个主题
-        QString topic = "scada/values";
-        addressTopicMap[address] = topic;
-        qDebug() << "Mapping address:" << address << "to topic:" << topic;
+void RuntimeViewer::toggleHud()
+{
+    if (m_hud) {
+        m_view->setHud(nullptr);
+        m_hudTimer->stop();
+        delete m_hud;
+        m_hud = nullptr;
+        return;
+    }
+
+    m_hud = new PerfHud;
+    if (!m_hudTimer) {
+        m_hudTimer = new QTimer(this);
+        connect(m_hudTimer, &QTimer::timeout, this, &RuntimeViewer::updateHud);
+    }
+    m_hudTimer->start(1000);
+    m_queuePeak = 0;
+    // 丢弃浮层打开之前留下的接收时间
+    for (DataSource *source : m_sources) {
+        source->takeReceiveTime();
     }
+    updateHud();
+    m_view->setHud(m_hud);
+}
 
-    // 设置映射并订阅主题
-    m_mqtt->setAddressTopicMap(addressTopicMap);
+qint64 RuntimeViewer::receivedMessages() const
+{
+    qint64 total = 0;
+    for (const DataSource *source : m_sources) {
+        total += source->receivedMessages();
+    }
+    return total;
+}
 
-    // 连接值变化信号
-    connect(m_mqtt, &MqttComm::valueChanged,
-            this, &RuntimeViewer::handleValueChanged);
+qint64 RuntimeViewer::receivedSamples() const
+{
+    qint64 total = 0;
+    for (const DataSource *source : m_sources) {
+        total += source->receivedSamples();
+    }
+    return total;
 }
 
-void RuntimeViewer::handleValueChanged(const QString &address, double value)
+void RuntimeViewer::updateHud()
 {
-    // 查找使用此地址的所有组件
-    for (auto it = m_valueAddresses.begin(); it != m_valueAddresses.end(); ++it) {
-        if (it.value() == address) {
-            QGraphicsItem *item = it.key();
-            // 更新显示值
-            foreach (QGraphicsItem *child, item->childItems()) {
-                if (QGraphicsTextItem *textItem = qgraphicsitem_cast<QGraphicsTextItem*>(child)) {
-                    textItem->setPlainText(QString::number(value, 'f', 1));
-                    break;
-                }
+    PerfCounters counters;
+    counters.messages = receivedMessages();
+    counters.samples = receivedSamples();
+    counters.updates = m_appliedUpdates;
+    if (m_ring) {
+        counters.queueDepth = m_ring->size();
+        counters.queuePeak = qMax(m_queuePeak, counters.queueDepth);
+        counters.queueCapacity = m_ring->capacity();
+    }
+    m_queuePeak = 0;
+
+    // 只重绘浮层所在区域（更新前后的区域都要刷新）
+    QRect oldRect = m_hud->rect();
+    m_hud->update(counters, m_view->viewport()->devicePixelRatioF());
+    m_view->viewport()->update(oldRect | m_hud->rect());
+}
+
+void RuntimeViewer::reportLatency()
+{
+    qint64 budget = qint64(m_options.latencyBudget) * 1000;
+    qCInfo(lcRuntime).noquote() << m_latency.report(budget);
+    if (!m_options.latencyReportFile.isEmpty()) {
+        QString errorString;
+        if (!m_latency.writeReport(m_options.latencyReportFile, budget, &errorString)) {
+            qCWarning(lcRuntime) << "Failed to write latency report:" << m_options.latencyReportFile << errorString;
+        }
+    }
+}
+
+void RuntimeViewer::setupMetrics()
+{
+    // 读取函数都只读原子计数或界面线程自己的成员，导出时不加锁
+    MqttComm *mqtt = m_mqtt;
+    if (mqtt) {
+        m_metrics.addCounter("scada_mqtt_messages_received_total", "MQTT messages decoded",
+                             [mqtt]() { return double(mqtt->receivedMessages()); });
+        m_metrics.addCounter("scada_mqtt_samples_received_total", "Samples decoded from MQTT messages",
+                             [mqtt]() { return double(mqtt->receivedSamples()); });
+        m_metrics.addCounter("scada_mqtt_decode_errors_total", "MQTT messages that failed to decode",
+                             [mqtt]() { return double(mqtt->decodeErrors()); });
+        m_metrics.addCounter("scada_mqtt_unknown_address_samples_total", "Samples whose address is not bound in the scene",
+                             [mqtt]() { return double(mqtt->unknownAddresses()); });
+        m_metrics.addCounter("scada_mqtt_unrouted_messages_total", "MQTT messages on topics no binding uses, dropped before decoding",
+                             [mqtt]() { return double(mqtt->unroutedMessages()); });
+        m_metrics.addCounter("scada_mqtt_sparkplug_rebirths_total", "Rebirth commands sent to Sparkplug B edge nodes",
+                             [mqtt]() { return double(mqtt->rebirthRequests()); });
+        m_metrics.addCounter("scada_mqtt_reconnects_total", "Reconnections to the MQTT broker",
+                             [mqtt]() { return double(mqtt->reconnects()); });
+        m_metrics.addGauge("scada_mqtt_connected", "Whether the MQTT client is connected",
+                           [mqtt]() { return mqtt->isConnected() ? 1.0 : 0.0; });
+        m_metrics.addGauge("scada_mqtt_subscriptions", "Active MQTT subscriptions",
+                           [mqtt]() { return double(mqtt->subscriptionCount()); });
+    }
+
+    // Modbus各连接的计数合计导出（基类的计数函数也可以转换为ModbusSource的成员指针）
+    if (!m_modbus.isEmpty()) {
+        auto sum = [this](qint64 (ModbusSource::*counter)() const) {
+            qint64 total = 0;
+            for (const ModbusSource *source : m_modbus) {
+                total += (source->*counter)();
             }
+            return double(total);
+        };
+        m_metrics.addCounter("scada_modbus_responses_total", "Modbus read responses decoded",
+                             [sum]() { return sum(&DataSource::receivedMessages); });
+        m_metrics.addCounter("scada_modbus_samples_received_total", "Samples decoded from Modbus responses",
+                             [sum]() { return sum(&DataSource::receivedSamples); });
+        m_metrics.addCounter("scada_modbus_decode_errors_total", "Modbus responses that failed to decode",
+                             [sum]() { return sum(&DataSource::decodeErrors); });
+        m_metrics.addCounter("scada_modbus_requests_total", "Modbus read requests sent",
+                             [sum]() { return sum(&ModbusSource::requests); });
+        m_metrics.addCounter("scada_modbus_exceptions_total", "Modbus exception responses",
+                             [sum]() { return sum(&ModbusSource::exceptions); });
+        m_metrics.addCounter("scada_modbus_poll_overruns_total", "Modbus polls skipped because the previous cycle was still in flight",
+                             [sum]() { return sum(&ModbusSource::overruns); });
+        m_metrics.addGauge("scada_modbus_connected", "Modbus servers currently connected",
+                           [this]() {
+                               int connected = 0;
+                               for (const ModbusSource *source : m_modbus) {
+                                   connected += source->isConnected() ? 1 : 0;
+                               }
+                               return double(connected);
+                           });
+        m_metrics.addGauge("scada_modbus_blocks", "Contiguous register blocks read per poll cycle",
+                           [this]() {
+                               int blocks = 0;
+                               for (const ModbusSource *source : m_modbus) {
+                                   blocks += source->blockCount();
+                               }
+                               return double(blocks);
+                           });
+    }
+
+    m_metrics.addGauge("scada_ingest_queue_depth", "Samples waiting in the ingest queue",
+                       [this]() { return m_ring ? double(m_ring->size()) : 0.0; });
+    m_metrics.addCounter("scada_frames_total", "Display frames applied",
+                         [this]() { return double(m_frames); });
+    m_metrics.addCounter("scada_component_updates_total", "Tag updates applied to components after conflation",
+                         [this]() { return double(m_appliedUpdates); });
+    m_metrics.addGauge("scada_scene_items", "Items in the loaded scene",
+                       [this]() { return double(m_sceneItems); });
+    m_metrics.addGauge("scada_tags", "Tags referenced by the loaded scene",
+                       [this]() { return double(m_tags.size()); });
+    m_metrics.addGauge("scada_bound_tags", "Tags bound to at least one component",
+                       [this]() { return double(m_boundTags); });
+    m_metrics.addGauge("scada_bindings", "Component bindings in the loaded scene",
+                       [this]() { return double(m_bindings.size()); });
+    m_metrics.addGauge("process_resident_memory_bytes", "Resident memory size in bytes",
+                       []() { return double(ProcessStats::residentBytes()); });
+    m_metrics.addCounter("process_cpu_seconds_total", "User and system CPU time in seconds",
+                         []() { return ProcessStats::cpuTimeUs() / 1e6; });
+
+    if (!m_options.metricsFile.isEmpty()) {
+        m_metricsTimer = new QTimer(this);
+        connect(m_metricsTimer, &QTimer::timeout, this, &RuntimeViewer::writeMetrics);
+        m_metricsTimer->start(qMax(1, m_options.metricsInterval) * 1000);
+        writeMetrics();
+    }
+
+    if (m_options.metricsPort != 0) {
+        MetricsServer *server = new MetricsServer(&m_metrics, this);
+        if (server->listen(m_options.metricsPort)) {
+            qCInfo(lcRuntime) << "Metrics available at http://127.0.0.1:" << server->serverPort() << "/metrics";
+        } else {
+            qCWarning(lcRuntime) << "Failed to listen for metrics on port" << m_options.metricsPort
+                                 << server->errorString();
         }
     }
 }
 
-void RuntimeViewer::updateValues()
+void RuntimeViewer::writeMetrics()
+{
+    QString errorString;
+    if (!m_metrics.writeTextFile(m_options.metricsFile, &errorString)) {
+        qCWarning(lcRuntime) << "Failed to write metrics:" << m_options.metricsFile << errorString;
+    }
+}
+
+void RuntimeViewer::scheduleFrame()
 {
-    // 遍历所有数值显示组件
-    for (auto it = m_valueAddresses.begin(); it != m_valueAddresses.end(); ++it) {
-        QGraphicsItem *item = it.key();
-        QString address = it.value();
-        
-        // 从MQTT获取值
-        double value = m_mqtt->getValue(address);
-        // 更新显示值
-        foreach (QGraphicsItem *child, item->childItems()) {
-            if (QGraphicsTextItem *textItem = qgraphicsitem_cast<QGraphicsTextItem*>(child)) {
-                textItem->setPlainText(QString::number(value, 'f', 1));
+    if (m_frameTimer->isActive()) {
+        return;
+    }
+
+    // 距上一帧不足最小间隔时推迟到间隔结束，保证帧率不超过上限
+    int delay = 0;
+    if (m_lastFrame.isValid()) {
+        delay = qMax(0, m_frameInterval - int(m_lastFrame.elapsed()));
+    }
+    m_frameTimer->start(delay);
+}
+
+void RuntimeViewer::applyPendingChanges()
+{
+    TRACE_SCOPE("RuntimeViewer::applyPendingChanges");
+    m_lastFrame.start();
+
+    if (m_ring) {
+        // 先清除唤醒标记再取数据，之后到达的数据会重新唤醒
+        m_ring->clearWake();
+        if (m_hud) {
+            m_queuePeak = qMax(m_queuePeak, m_ring->size());
+        }
+
+        // 每次最多取出一个队列容量的数据点，避免持续高负载时界面线程无法返回
+        TagSample batch[kDrainBatch];
+        int remaining = m_ring->capacity();
+        while (remaining > 0) {
+            int count = m_ring->pop(batch, qMin(remaining, kDrainBatch));
+            if (count == 0) {
                 break;
             }
+            remaining -= count;
+
+            // 同一变量的多次变化在变量表中合并
+            for (int i = 0; i < count; ++i) {
+                m_tags.update(batch[i].tag, batch[i].value);
+            }
         }
     }
+
+    // 每个变化过的变量只刷新一次
+    m_tags.takeChanged(&m_changedTags);
+    {
+        TRACE_SCOPE("RuntimeViewer::handleValueChanged");
+        for (int tag : m_changedTags) {
+            handleValueChanged(tag, m_tags.value(tag));
+        }
+    }
+    m_latency.dispatched();
+    ++m_frames;
+    m_appliedUpdates += m_changedTags.size();
+
+    // 浮层统计：本帧数据的接收时间
+    if (m_hud) {
+        // 多个数据源时取最早的接收时间
+        qint64 receiveTime = 0;
+        for (DataSource *source : m_sources) {
+            qint64 sourceTime = source->takeReceiveTime();
+            if (sourceTime && (!receiveTime || sourceTime < receiveTime)) {
+                receiveTime = sourceTime;
+            }
+        }
+        if (receiveTime) {
+            m_view->setReceiveTime(receiveTime);
+        }
+    }
+
+    // 本帧未取完的数据留到下一帧
+    if (m_ring && m_ring->size() > 0) {
+        scheduleFrame();
+    }
 }
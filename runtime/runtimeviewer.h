@@ -6,28 +6,87 @@
 #include <QGraphicsView>
 #include <QTimer>
 #include <QMap>
+#include <QThread>
+#include <QElapsedTimer>
 #include "mqttcomm.h"
+#include "modbussource.h"
+#include "tagtable.h"
+#include "bindingtable.h"
+#include "samplering.h"
+#include "runtimeoptions.h"
+#include "scenefile.h"
+#include "runtimeview.h"
+#include "perfhud.h"
+#include "latencytracker.h"
+#include "metricsregistry.h"
 
 class RuntimeViewer : public QMainWindow
 {
     Q_OBJECT
 public:
-    explicit RuntimeViewer(const QString &sceneFile, QWidget *parent = nullptr);
+    explicit RuntimeViewer(const QString &sceneFile,
+                           const RuntimeOptions &options = RuntimeOptions(),
+                           QWidget *parent = nullptr);
     ~RuntimeViewer();
 
+    void handleValueChanged(int tag, TagValue value);  // 刷新绑定到该变量的组件
+
+    RuntimeView *view() const { return m_view; }  // 视图
+    const TagTable &tags() const { return m_tags; }  // 变量值表
+    int sceneItemCount() const { return m_scene->items().size(); }  // 场景中的图元个数
+
+    // 全部数据源累计接收的报文数和数据点数
+    qint64 receivedMessages() const;
+    qint64 receivedSamples() const;
+
 private slots:
-    void updateValues();  // 更新数值显示组件的值
-    void handleValueChanged(const QString &address, double value);  // 处理MQTT值变化
+    void scheduleFrame();  // 有新的变化时安排一次显示刷新
+    void applyPendingChanges();  // 每个显示周期批量应用变化
+    void renderSnapshot();  // 将场景渲染为快照图片
+    void toggleTrace();  // 开始或停止性能跟踪，停止时写出跟踪文件
+    void toggleHud();  // 显示或隐藏性能浮层
+    void updateHud();  // 每秒更新一次性能浮层
+    void reportLatency();  // 输出端到端延迟统计
+    void writeMetrics();  // 把指标写入文件
 
 private:
-    void loadScene(const QString &fileName);  // 加载场景文件
-    void setupMqtt();  // 设置MQTT连接
+    // 加载场景文件，只在构造时、创建数据源之前调用：数据源按此时的变量表订阅和路由
+    void loadScene(const QString &fileName);
+    void loadCompiledScene(const QString &fileName);  // 映射加载编译场景
+    void clearScene();  // 清除场景、变量表和绑定表
+    void addSceneItem(SceneItemType type, qreal x, qreal y,
+                      qreal width, qreal height, int tag);  // 创建一个组件，tag为绑定的变量ID
+    void finishScene();  // 整理绑定表并调整视图
+    void setupSources();  // 按绑定的主题创建数据源并开始采集
+    void reportError(const QString &text);  // 报告错误（无窗口模式下只写日志）
+    void setupMetrics();  // 登记运行时指标并按选项开启导出
 
     QGraphicsScene *m_scene;  // 场景
-    QGraphicsView *m_view;    // 视图
-    QTimer *m_updateTimer;    // 定时器
-    QMap<QGraphicsItem*, QString> m_valueAddresses;  // 组件和地址的映射
-    MqttComm *m_mqtt;  // MQTT通信对象
+    RuntimeView *m_view;      // 视图
+    BindingTable m_bindings;  // 变量ID到绑定组件的编译表
+    MqttComm *m_mqtt;  // MQTT通信对象，场景只绑定Modbus变量时为nullptr
+    QVector<ModbusSource *> m_modbus;  // Modbus数据源（每个服务器一个连接）
+    QVector<DataSource *> m_sources;  // 全部数据源
+    RuntimeOptions m_options;  // 启动选项
+    TagTable m_tags;  // 变量表（按变量ID的主题、地址和值）
+    SampleRing *m_ring;  // 采集线程到界面线程的数据点队列
+    QThread *m_ingestThread;  // 采集线程
+    QTimer *m_frameTimer;  // 显示刷新定时器（只在有变化时启动）
+    QElapsedTimer m_lastFrame;  // 上一帧的时间，用于限制帧率
+    int m_frameInterval;  // 最小帧间隔（毫秒）
+    QVector<int> m_changedTags;  // 本帧要刷新的变量ID
+    QTimer *m_snapshotTimer;  // 快照定时器
+    PerfHud *m_hud;  // 性能浮层，隐藏时为nullptr
+    QTimer *m_hudTimer;  // 性能浮层更新定时器
+    qint64 m_appliedUpdates;  // 累计刷新到组件的变量次数
+    qint64 m_frames;  // 累计显示刷新次数
+    int m_queuePeak;  // 本周期内采集队列的最大长度
+    LatencyTracker m_latency;  // 端到端延迟统计
+    QTimer *m_latencyTimer;  // 延迟统计的定时输出
+    MetricsRegistry m_metrics;  // 运行时指标
+    QTimer *m_metricsTimer;  // 指标文件的定时写入
+    int m_sceneItems;  // 场景中的组件个数
+    int m_boundTags;  // 绑定了组件的变量个数
 };
 
 #endif // RUNTIMEVIEWER_H
@@ -0,0 +1,92 @@
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include <QAtomicInteger>
+#include <QVector>
+#include "tagvalue.h"
+
+/**
+ * @brief 已解码的数据点
+ */
+struct TagSample {
+    int tag;        // 变量ID
+    TagValue value; // 数值（已转换为变量的类型）
+};
+
+/**
+ * @brief 单生产者/单消费者的有界无锁环形队列
+ * 采集线程写入，界面线程批量取出，两端都不加锁
+ */
+class SampleRing
+{
+public:
+    // 容量向上取整为2的幂
+    explicit SampleRing(int capacity)
+        : m_head(0)
+        , m_tail(0)
+    {
+        int size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_buffer.resize(size);
+        m_slots = m_buffer.data();
+        m_mask = quint32(size - 1);
+    }
+
+    // 生产者：写入一个数据点，队列满时返回false
+    inline bool push(const TagSample &sample)
+    {
+        quint32 head = m_head.load();
+        if (head - m_tail.loadAcquire() > m_mask) {
+            return false;
+        }
+        m_slots[head & m_mask] = sample;
+        m_head.storeRelease(head + 1);
+        return true;
+    }
+
+    // 消费者：最多取出max个数据点，返回实际个数
+    inline int pop(TagSample *out, int max)
+    {
+        quint32 tail = m_tail.load();
+        quint32 available = m_head.loadAcquire() - tail;
+        int count = int(available) < max ? int(available) : max;
+        for (int i = 0; i < count; ++i) {
+            out[i] = m_slots[(tail + quint32(i)) & m_mask];
+        }
+        m_tail.storeRelease(tail + quint32(count));
+        return count;
+    }
+
+    // 当前排队数量（近似值，任一端都可调用）
+    int size() const { return int(m_head.loadAcquire() - m_tail.loadAcquire()); }
+
+    int capacity() const { return int(m_mask) + 1; }
+
+    // 生产者：写入后调用，返回true表示需要唤醒消费者（每次取出之间只返回一次）
+    inline bool requestWake() { return m_wakePending.testAndSetOrdered(0, 1); }
+
+    // 消费者：取出之前调用，之后写入的数据会再次触发唤醒
+    inline void clearWake() { m_wakePending.storeRelease(0); }
+
+private:
+    Q_DISABLE_COPY(SampleRing)
+
+    static const int kCacheLineSize = 64;
+
+    QVector<TagSample> m_buffer;    // 环形缓冲区
+    TagSample *m_slots;             // 缓冲区首地址
+    quint32 m_mask;                 // 容量掩码
+
+    // 读写位置之间各隔一整条缓存行，不论对象地址如何都不会落在同一缓存行，避免伪共享。
+    // 不用alignas(64)：C++17之前new出来的对象不保证超出默认值的对齐
+    char m_padMask[kCacheLineSize];
+    QAtomicInteger<quint32> m_head;     // 生产者写入位置
+    char m_padHead[kCacheLineSize];
+    QAtomicInteger<quint32> m_tail;     // 消费者读取位置
+    char m_padTail[kCacheLineSize];
+    QAtomicInt m_wakePending;           // 是否已通知消费者
+};
+
+#endif // SAMPLERING_H
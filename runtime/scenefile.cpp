@@ -0,0 +1,268 @@
+#include "scenefile.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QVector>
+#include <cstring>
+
+namespace {
+const char kMagic[4] = { 'S', 'C', 'N', 'B' };
+const quint32 kByteOrder = 0x01020304;
+const quint32 kVersion = 1;
+
+// 各区按8字节对齐，映射后可直接按结构体访问
+quint32 align8(quint32 offset)
+{
+    return (offset + 7) & ~quint32(7);
+}
+}
+
+const char SceneFile::kDefaultTopic[] = "scada/values";
+
+SceneFile::SceneFile()
+    : m_data(nullptr)
+    , m_header(nullptr)
+    , m_items(nullptr)
+    , m_tags(nullptr)
+    , m_strings(nullptr)
+{
+}
+
+SceneFile::~SceneFile()
+{
+    close();
+}
+
+bool SceneFile::compile(const QString &jsonFile, const QString &binaryFile, QString *errorString)
+{
+    QFile input(jsonFile);
+    if (!input.open(QIODevice::ReadOnly)) {
+        *errorString = input.errorString();
+        return false;
+    }
+
+    QJsonParseError jsonError;
+    QJsonDocument doc = QJsonDocument::fromJson(input.readAll(), &jsonError);
+    if (doc.isNull()) {
+        *errorString = jsonError.errorString();
+        return false;
+    }
+
+    // 与RuntimeViewer::loadScene相同的解释规则，(主题, 地址)按首次出现的顺序编号
+    QVector<SceneItemRecord> items;
+    QHash<QPair<QString, QString>, int> tagIds;
+    QHash<QString, quint32> topicOffsets;   // 相同的主题只保存一次
+    QByteArray strings;
+    QVector<SceneTagRecord> tags;
+
+    QJsonArray itemsArray = doc.object()["items"].toArray();
+    items.reserve(itemsArray.size());
+    for (const QJsonValue &value : itemsArray) {
+        QJsonObject itemObject = value.toObject();
+        SceneItemType type = itemType(itemObject["itemType"].toString());
+        if (type == SceneItemUnknown) {
+            continue;
+        }
+
+        SceneItemRecord record;
+        memset(&record, 0, sizeof(record));
+        record.type = type;
+        record.tag = -1;
+        record.x = itemObject["x"].toDouble();
+        record.y = itemObject["y"].toDouble();
+        record.width = itemObject["width"].toDouble();
+        record.height = itemObject["height"].toDouble();
+
+        if (type == SceneItemValueDisplay && itemObject.contains("binding")) {
+            QJsonObject bindingObject = itemObject["binding"].toObject();
+            QString address = bindingObject["address"].toString();
+            if (!address.isEmpty()) {
+                QString topic = bindingTopic(bindingObject);
+                QPair<QString, QString> key(topic, address);
+                auto it = tagIds.constFind(key);
+                if (it == tagIds.constEnd()) {
+                    QByteArray utf8 = address.toUtf8();
+                    SceneTagRecord tag = {};
+                    tag.offset = quint32(strings.size());
+                    tag.length = quint32(utf8.size());
+                    tag.type = tagTypeFromName(bindingObject["dataType"].toString());
+                    strings.append(utf8);
+
+                    QByteArray topicUtf8 = topic.toUtf8();
+                    auto topicIt = topicOffsets.constFind(topic);
+                    if (topicIt == topicOffsets.constEnd()) {
+                        topicIt = topicOffsets.insert(topic, quint32(strings.size()));
+                        strings.append(topicUtf8);
+                    }
+                    tag.topicOffset = topicIt.value();
+                    tag.topicLength = quint32(topicUtf8.size());
+                    it = tagIds.insert(key, tags.size());
+                    tags.append(tag);
+                }
+                record.tag = it.value();
+            }
+        }
+        items.append(record);
+    }
+
+    SceneFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byteOrder = kByteOrder;
+    header.version = kVersion;
+    header.itemCount = quint32(items.size());
+    header.tagCount = quint32(tags.size());
+    header.itemsOffset = align8(sizeof(SceneFileHeader));
+    header.tagsOffset = align8(header.itemsOffset + quint32(items.size()) * sizeof(SceneItemRecord));
+    header.stringsOffset = align8(header.tagsOffset + quint32(tags.size()) * sizeof(SceneTagRecord));
+    header.stringsSize = quint32(strings.size());
+
+    QByteArray data(int(header.stringsOffset + header.stringsSize), '\0');
+    memcpy(data.data(), &header, sizeof(header));
+    memcpy(data.data() + header.itemsOffset, items.constData(), size_t(items.size()) * sizeof(SceneItemRecord));
+    memcpy(data.data() + header.tagsOffset, tags.constData(), size_t(tags.size()) * sizeof(SceneTagRecord));
+    memcpy(data.data() + header.stringsOffset, strings.constData(), size_t(strings.size()));
+
+    QFile output(binaryFile);
+    if (!output.open(QIODevice::WriteOnly) || output.write(data) != data.size()) {
+        *errorString = output.errorString();
+        return false;
+    }
+    return true;
+}
+
+QString SceneFile::bindingTopic(const QJsonObject &binding)
+{
+    QString topic = binding["topic"].toString();
+    return topic.isEmpty() ? QString::fromLatin1(kDefaultTopic) : topic;
+}
+
+bool SceneFile::isCompiled(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return file.peek(sizeof(kMagic)) == QByteArray::fromRawData(kMagic, sizeof(kMagic));
+}
+
+SceneItemType SceneFile::itemType(const QString &name)
+{
+    if (name == QLatin1String("ValueDisplay")) {
+        return SceneItemValueDisplay;
+    }
+    if (name == QLatin1String("Rectangle")) {
+        return SceneItemRectangle;
+    }
+    if (name == QLatin1String("Ellipse")) {
+        return SceneItemEllipse;
+    }
+    return SceneItemUnknown;
+}
+
+bool SceneFile::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    qint64 size = m_file.size();
+    if (size < qint64(sizeof(SceneFileHeader))) {
+        m_error = QObject::tr("文件过短");
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, size);
+    if (!m_data) {
+        m_error = m_file.errorString();
+        close();
+        return false;
+    }
+
+    // 校验文件头和各区边界，避免越界访问映射内存
+    const SceneFileHeader *header = reinterpret_cast<const SceneFileHeader *>(m_data);
+    if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0
+            || header->byteOrder != kByteOrder
+            || header->version != kVersion) {
+        m_error = QObject::tr("不支持的场景格式或字节序");
+        close();
+        return false;
+    }
+    quint64 itemsEnd = quint64(header->itemsOffset) + quint64(header->itemCount) * sizeof(SceneItemRecord);
+    quint64 tagsEnd = quint64(header->tagsOffset) + quint64(header->tagCount) * sizeof(SceneTagRecord);
+    quint64 stringsEnd = quint64(header->stringsOffset) + header->stringsSize;
+    if (header->itemsOffset % 8 != 0 || header->tagsOffset % 8 != 0
+            || itemsEnd > quint64(size) || tagsEnd > quint64(size) || stringsEnd > quint64(size)) {
+        m_error = QObject::tr("场景文件已损坏");
+        close();
+        return false;
+    }
+
+    m_header = header;
+    m_items = reinterpret_cast<const SceneItemRecord *>(m_data + header->itemsOffset);
+    m_tags = reinterpret_cast<const SceneTagRecord *>(m_data + header->tagsOffset);
+    m_strings = reinterpret_cast<const char *>(m_data + header->stringsOffset);
+
+    for (quint32 i = 0; i < header->tagCount; ++i) {
+        if (quint64(m_tags[i].offset) + m_tags[i].length > header->stringsSize
+                || quint64(m_tags[i].topicOffset) + m_tags[i].topicLength > header->stringsSize
+                || m_tags[i].type > TagBool) {
+            m_error = QObject::tr("场景文件已损坏");
+            close();
+            return false;
+        }
+    }
+    // 变量ID由加载顺序决定，(主题, 地址)重复会使组件绑定错位
+    QSet<QPair<QString, QString>> seen;
+    seen.reserve(int(header->tagCount));
+    for (quint32 i = 0; i < header->tagCount; ++i) {
+        QPair<QString, QString> key(tagTopic(int(i)), tagAddress(int(i)));
+        if (seen.contains(key)) {
+            m_error = QObject::tr("场景文件已损坏：变量重复：%1 %2").arg(key.first).arg(key.second);
+            close();
+            return false;
+        }
+        seen.insert(key);
+    }
+    for (quint32 i = 0; i < header->itemCount; ++i) {
+        if (m_items[i].tag >= qint32(header->tagCount)) {
+            m_error = QObject::tr("场景文件已损坏");
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void SceneFile::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+    }
+    m_file.close();
+    m_data = nullptr;
+    m_header = nullptr;
+    m_items = nullptr;
+    m_tags = nullptr;
+    m_strings = nullptr;
+}
+
+QString SceneFile::tagAddress(int tag) const
+{
+    const SceneTagRecord &record = m_tags[tag];
+    return QString::fromUtf8(m_strings + record.offset, int(record.length));
+}
+
+QString SceneFile::tagTopic(int tag) const
+{
+    const SceneTagRecord &record = m_tags[tag];
+    return QString::fromUtf8(m_strings + record.topicOffset, int(record.topicLength));
+}
@@ -0,0 +1,112 @@
+#ifndef SCENEFILE_H
+#define SCENEFILE_H
+
+#include <QFile>
+#include <QString>
+#include <QJsonObject>
+#include "tagvalue.h"
+
+/**
+ * @brief 编译场景中的组件类型
+ */
+enum SceneItemType : quint8 {
+    SceneItemUnknown = 0,
+    SceneItemRectangle = 1,
+    SceneItemEllipse = 2,
+    SceneItemValueDisplay = 3
+};
+
+/**
+ * @brief 编译场景文件头
+ * 文件布局：文件头 | 组件记录数组 | 变量记录数组 | 地址和主题字符串（UTF-8）
+ */
+struct SceneFileHeader {
+    char magic[4];              // "SCNB"
+    quint32 byteOrder;          // 0x01020304，用于检查字节序
+    quint32 version;            // 格式版本
+    quint32 itemCount;          // 组件个数
+    quint32 tagCount;           // 变量个数（变量ID即地址在表中的序号）
+    quint32 itemsOffset;        // 组件记录数组的偏移
+    quint32 tagsOffset;         // 地址索引数组的偏移
+    quint32 stringsOffset;      // 地址字符串区的偏移
+    quint32 stringsSize;        // 地址字符串区的大小
+    quint32 reserved;
+};
+
+/**
+ * @brief 定长组件记录
+ */
+struct SceneItemRecord {
+    quint8 type;                // SceneItemType
+    quint8 reserved[3];
+    qint32 tag;                 // 绑定的变量ID，-1表示未绑定
+    double x;
+    double y;
+    double width;
+    double height;
+};
+
+/**
+ * @brief 变量记录：地址和主题字符串在字符串区中的位置，以及变量类型。
+ * 每个(主题, 地址)一条记录，不同主题下的相同地址是不同的变量
+ */
+struct SceneTagRecord {
+    quint32 offset;
+    quint32 length;
+    quint32 topicOffset;        // 主题，未指定主题的绑定存为公共主题
+    quint32 topicLength;
+    quint8 type;                // TagType，由绑定的dataType决定
+    quint8 reserved[3];
+};
+
+/**
+ * @brief 编译场景文件
+ * compile把设计器保存的JSON场景转换为紧凑的二进制格式，
+ * open通过内存映射直接访问其中的定长记录
+ */
+class SceneFile
+{
+public:
+    static const char kDefaultTopic[];  // 绑定未指定主题时使用的公共主题
+
+    SceneFile();
+    ~SceneFile();
+
+    // 绑定所在的主题，未指定时为公共主题
+    static QString bindingTopic(const QJsonObject &binding);
+
+    // 将JSON场景编译为二进制场景
+    static bool compile(const QString &jsonFile, const QString &binaryFile, QString *errorString);
+
+    // 判断文件是否为编译场景
+    static bool isCompiled(const QString &fileName);
+
+    // 设计器中的组件类型名对应的编译类型
+    static SceneItemType itemType(const QString &name);
+
+    // 映射并校验编译场景
+    bool open(const QString &fileName);
+    void close();
+    QString errorString() const { return m_error; }
+
+    int itemCount() const { return m_header ? int(m_header->itemCount) : 0; }
+    const SceneItemRecord &item(int index) const { return m_items[index]; }
+
+    int tagCount() const { return m_header ? int(m_header->tagCount) : 0; }
+    QString tagAddress(int tag) const;
+    TagType tagType(int tag) const { return TagType(m_tags[tag].type); }
+    QString tagTopic(int tag) const;
+
+private:
+    Q_DISABLE_COPY(SceneFile)
+
+    QFile m_file;                       // 映射的文件
+    const uchar *m_data;                // 映射的数据
+    const SceneFileHeader *m_header;
+    const SceneItemRecord *m_items;
+    const SceneTagRecord *m_tags;
+    const char *m_strings;
+    QString m_error;
+};
+
+#endif // SCENEFILE_H
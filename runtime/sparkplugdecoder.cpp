@@ -0,0 +1,382 @@
+#include "sparkplugdecoder.h"
+#include <cstring>
+#include <limits>
+#include "sparkplugencoder.h"
+
+namespace {
+
+// protobuf线格式
+enum {
+    WireVarint = 0,
+    WireFixed64 = 1,
+    WireLength = 2,
+    WireFixed32 = 5
+};
+
+// Payload的字段
+enum {
+    PayloadTimestamp = 1,
+    PayloadMetrics = 2,
+    PayloadSeq = 3
+};
+
+// Metric的字段
+enum {
+    MetricName = 1,
+    MetricAlias = 2,
+    MetricDatatype = 4,
+    MetricIsNull = 7,
+    MetricIntValue = 10,
+    MetricLongValue = 11,
+    MetricFloatValue = 12,
+    MetricDoubleValue = 13,
+    MetricBooleanValue = 14
+};
+
+const char kRebirthMetric[] = "Node Control/Rebirth";
+
+constexpr quint64 fieldKey(int field, int wireType)
+{
+    return (quint64(field) << 3) | quint64(wireType);
+}
+
+// 小端序定长整数
+quint64 readFixed(const uchar *data, int size)
+{
+    quint64 value = 0;
+    for (int i = size - 1; i >= 0; --i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+} // namespace
+
+const char SparkplugDecoder::kNamespace[] = "spBv1.0/";
+
+SparkplugDecoder::SparkplugDecoder()
+    : m_begin(nullptr)
+    , m_pos(nullptr)
+    , m_metricCount(0)
+    , m_sequence(-1)
+    , m_error(nullptr)
+    , m_errorOffset(-1)
+{
+}
+
+bool SparkplugDecoder::decode(const QByteArray &payload, SparkplugSink *sink)
+{
+    m_begin = reinterpret_cast<const uchar *>(payload.constData());
+    m_pos = m_begin;
+    const uchar *end = m_begin + payload.size();
+    m_metricCount = 0;
+    m_sequence = -1;
+    m_error = nullptr;
+    m_errorOffset = -1;
+
+    while (m_pos < end) {
+        quint64 key;
+        if (!readVarint(end, &key)) {
+            return false;
+        }
+
+        if (key == fieldKey(PayloadTimestamp, WireVarint)) {
+            quint64 timestamp;
+            if (!readVarint(end, &timestamp)) {
+                return false;
+            }
+            sink->onSparkplugTimestamp(timestamp);
+        } else if (key == fieldKey(PayloadMetrics, WireLength)) {
+            const uchar *metricEnd;
+            if (!readLength(end, &metricEnd)) {
+                return false;
+            }
+            SparkplugMetric metric;
+            if (!parseMetric(metricEnd, &metric)) {
+                return false;
+            }
+            ++m_metricCount;
+            sink->onSparkplugMetric(metric);
+        } else if (key == fieldKey(PayloadSeq, WireVarint)) {
+            quint64 sequence;
+            if (!readVarint(end, &sequence)) {
+                return false;
+            }
+            if (sequence > 255) {
+                return fail("Sequence number out of range");
+            }
+            m_sequence = int(sequence);
+        } else if (!skipField(end, int(key & 0x7))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SparkplugDecoder::parseMetric(const uchar *end, SparkplugMetric *metric)
+{
+    metric->name = nullptr;
+    metric->nameSize = 0;
+    metric->alias = 0;
+    metric->hasAlias = false;
+    metric->datatype = 0;
+    metric->valueField = 0;
+    metric->raw = 0;
+    metric->isNull = false;
+
+    while (m_pos < end) {
+        quint64 key;
+        if (!readVarint(end, &key)) {
+            return false;
+        }
+
+        quint64 value;
+        switch (key) {
+        case fieldKey(MetricName, WireLength): {
+            const uchar *nameEnd;
+            if (!readLength(end, &nameEnd)) {
+                return false;
+            }
+            metric->name = reinterpret_cast<const char *>(m_pos);
+            metric->nameSize = int(nameEnd - m_pos);
+            m_pos = nameEnd;
+            break;
+        }
+        case fieldKey(MetricAlias, WireVarint):
+            if (!readVarint(end, &metric->alias)) {
+                return false;
+            }
+            metric->hasAlias = true;
+            break;
+        case fieldKey(MetricDatatype, WireVarint):
+            if (!readVarint(end, &value)) {
+                return false;
+            }
+            metric->datatype = quint32(value);
+            break;
+        case fieldKey(MetricIsNull, WireVarint):
+            if (!readVarint(end, &value)) {
+                return false;
+            }
+            metric->isNull = value != 0;
+            break;
+        case fieldKey(MetricIntValue, WireVarint):
+            // uint32字段，有的实现按int32写出10字节的负数，只取低32位
+            if (!readVarint(end, &value)) {
+                return false;
+            }
+            metric->valueField = MetricIntValue;
+            metric->raw = value & 0xffffffffu;
+            break;
+        case fieldKey(MetricLongValue, WireVarint):
+        case fieldKey(MetricBooleanValue, WireVarint):
+            if (!readVarint(end, &metric->raw)) {
+                return false;
+            }
+            metric->valueField = int(key >> 3);
+            break;
+        case fieldKey(MetricFloatValue, WireFixed32):
+        case fieldKey(MetricDoubleValue, WireFixed64): {
+            int size = (key & 0x7) == WireFixed32 ? 4 : 8;
+            if (end - m_pos < size) {
+                return fail("Truncated fixed-width value");
+            }
+            metric->raw = readFixed(m_pos, size);
+            metric->valueField = int(key >> 3);
+            m_pos += size;
+            break;
+        }
+        default:
+            // 时间戳、属性以及字符串、数据集等非标量的值
+            if (!skipField(end, int(key & 0x7))) {
+                return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+bool SparkplugDecoder::readVarint(const uchar *end, quint64 *value)
+{
+    quint64 result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (m_pos >= end) {
+            return fail("Truncated varint");
+        }
+        uchar byte = *m_pos++;
+        result |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return fail("Varint too long");
+}
+
+bool SparkplugDecoder::readLength(const uchar *end, const uchar **fieldEnd)
+{
+    quint64 length;
+    if (!readVarint(end, &length)) {
+        return false;
+    }
+    if (length > quint64(end - m_pos)) {
+        return fail("Field length exceeds message");
+    }
+    *fieldEnd = m_pos + length;
+    return true;
+}
+
+bool SparkplugDecoder::skipField(const uchar *end, int wireType)
+{
+    switch (wireType) {
+    case WireVarint: {
+        quint64 value;
+        return readVarint(end, &value);
+    }
+    case WireFixed64:
+    case WireFixed32: {
+        int size = wireType == WireFixed64 ? 8 : 4;
+        if (end - m_pos < size) {
+            return fail("Truncated fixed-width field");
+        }
+        m_pos += size;
+        return true;
+    }
+    case WireLength: {
+        const uchar *fieldEnd;
+        if (!readLength(end, &fieldEnd)) {
+            return false;
+        }
+        m_pos = fieldEnd;
+        return true;
+    }
+    default:
+        return fail("Unsupported wire type");
+    }
+}
+
+bool SparkplugDecoder::fail(const char *error)
+{
+    m_error = error;
+    m_errorOffset = int(m_pos - m_begin);
+    return false;
+}
+
+SparkplugDecoder::MessageType SparkplugDecoder::messageType(const QString &topic)
+{
+    static const int kNamespaceSize = int(sizeof(kNamespace)) - 1;
+    if (!topic.startsWith(QLatin1String(kNamespace, kNamespaceSize))) {
+        return Unknown;
+    }
+
+    // 第二级是组，STATE消息没有组（spBv1.0/STATE/<主机>）
+    int groupEnd = topic.indexOf(QLatin1Char('/'), kNamespaceSize);
+    if (groupEnd < 0) {
+        return Unknown;
+    }
+    if (topic.midRef(kNamespaceSize, groupEnd - kNamespaceSize) == QLatin1String("STATE")) {
+        return State;
+    }
+    int typeEnd = topic.indexOf(QLatin1Char('/'), groupEnd + 1);
+    if (typeEnd < 0) {
+        return Unknown;
+    }
+
+    static const struct {
+        const char *name;
+        MessageType type;
+    } kTypes[] = {
+        {"NBIRTH", NBirth}, {"NDEATH", NDeath}, {"DBIRTH", DBirth}, {"DDEATH", DDeath},
+        {"NDATA", NData}, {"DDATA", DData}, {"NCMD", NCmd}, {"DCMD", DCmd}
+    };
+    QStringRef name = topic.midRef(groupEnd + 1, typeEnd - groupEnd - 1);
+    for (const auto &type : kTypes) {
+        if (name == QLatin1String(type.name)) {
+            return type.type;
+        }
+    }
+    return Unknown;
+}
+
+bool SparkplugDecoder::toTagValue(const SparkplugMetric &metric, quint32 datatype,
+                                  TagValue *value, TagType *type)
+{
+    if (metric.isNull) {
+        return false;
+    }
+
+    switch (metric.valueField) {
+    case MetricFloatValue: {
+        quint32 bits = quint32(metric.raw);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        *value = TagValue::fromDouble(f);
+        *type = TagDouble;
+        return true;
+    }
+    case MetricDoubleValue: {
+        double d;
+        memcpy(&d, &metric.raw, sizeof(d));
+        *value = TagValue::fromDouble(d);
+        *type = TagDouble;
+        return true;
+    }
+    case MetricBooleanValue:
+        *value = TagValue::fromBool(metric.raw != 0);
+        *type = TagBool;
+        return true;
+    case MetricIntValue:
+    case MetricLongValue:
+        break;
+    default:
+        return false;
+    }
+
+    // 有符号类型按位宽做符号扩展，无符号的int_value已是0~2^32-1
+    *type = TagInt;
+    switch (datatype) {
+    case Int8:
+        *value = TagValue::fromInt(qint8(metric.raw));
+        return true;
+    case Int16:
+        *value = TagValue::fromInt(qint16(metric.raw));
+        return true;
+    case Int32:
+        *value = TagValue::fromInt(qint32(metric.raw));
+        return true;
+    case UInt64:
+        if (metric.raw > quint64(std::numeric_limits<qint64>::max())) {
+            *value = TagValue::fromDouble(double(metric.raw));
+            *type = TagDouble;
+            return true;
+        }
+        *value = TagValue::fromInt(qint64(metric.raw));
+        return true;
+    case Boolean:
+        *value = TagValue::fromBool(metric.raw != 0);
+        *type = TagBool;
+        return true;
+    case Float:
+    case Double:
+        *value = TagValue::fromDouble(double(qint64(metric.raw)));
+        *type = TagDouble;
+        return true;
+    case String:
+    case Text:
+        return false;
+    default:
+        // Int64、UInt8~UInt32、DateTime，以及类型未知时
+        *value = TagValue::fromInt(qint64(metric.raw));
+        return true;
+    }
+}
+
+QByteArray SparkplugDecoder::rebirthRequest(quint64 timestamp)
+{
+    QByteArray payload;
+    SparkplugEncoder encoder(&payload);
+    encoder.addTimestamp(timestamp);
+    encoder.addBooleanMetric(QByteArray::fromRawData(kRebirthMetric, int(sizeof(kRebirthMetric)) - 1), true);
+    return payload;
+}
@@ -0,0 +1,118 @@
+#ifndef SPARKPLUGDECODER_H
+#define SPARKPLUGDECODER_H
+
+#include <QByteArray>
+#include <QString>
+#include "tagvalue.h"
+
+/**
+ * @brief Sparkplug B报文中的一个指标
+ * 名称指向原始报文内部，仅在回调期间有效；DATA报文通常只带别名，name为nullptr
+ */
+struct SparkplugMetric {
+    const char *name;       // 指标名称（UTF-8，不以0结尾）
+    int nameSize;           // 名称长度
+    quint64 alias;          // 别名
+    bool hasAlias;          // 是否带别名
+    quint32 datatype;       // 数据类型（SparkplugDecoder::DataType），0表示报文中没有
+    int valueField;         // 值所在的字段号（10~14），0表示没有标量值
+    quint64 raw;            // 值的原始位：整数为varint的值，float/double为IEEE位
+    bool isNull;            // 显式的空值
+};
+
+/**
+ * @brief Sparkplug B解码结果接收接口
+ */
+class SparkplugSink
+{
+public:
+    virtual ~SparkplugSink() {}
+
+    // 报文时间戳（Unix毫秒）
+    virtual void onSparkplugTimestamp(quint64 timestamp) = 0;
+
+    // 一个指标，按报文中的顺序回调
+    virtual void onSparkplugMetric(const SparkplugMetric &metric) = 0;
+};
+
+/**
+ * @brief Sparkplug B报文解码器
+ * 直接在原始字节上按protobuf线格式单遍扫描Payload和Metric，不依赖protobuf库，
+ * 只取时间戳、序号和标量指标（整数、浮点、布尔），数据集、模板等复杂类型跳过
+ */
+class SparkplugDecoder
+{
+public:
+    // 主题命名空间 spBv1.0/<组>/<消息类型>/<边缘节点>[/<设备>]
+    static const char kNamespace[];
+
+    // 消息类型（主题的第三级）
+    enum MessageType {
+        Unknown,
+        NBirth,
+        NDeath,
+        DBirth,
+        DDeath,
+        NData,
+        DData,
+        NCmd,
+        DCmd,
+        State
+    };
+
+    // 指标数据类型（Sparkplug B规范中的DataType）
+    enum DataType {
+        Int8 = 1,
+        Int16 = 2,
+        Int32 = 3,
+        Int64 = 4,
+        UInt8 = 5,
+        UInt16 = 6,
+        UInt32 = 7,
+        UInt64 = 8,
+        Float = 9,
+        Double = 10,
+        Boolean = 11,
+        String = 12,
+        DateTime = 13,
+        Text = 14
+    };
+
+    SparkplugDecoder();
+
+    // 解码报文，逐个指标回调sink；格式错误时返回false
+    bool decode(const QByteArray &payload, SparkplugSink *sink);
+
+    // 最近一次解码的结果
+    int metricCount() const { return m_metricCount; }
+    int sequence() const { return m_sequence; }
+    const char *errorString() const { return m_error; }
+    int errorOffset() const { return m_errorOffset; }
+
+    // 主题中的消息类型，不在Sparkplug B命名空间内时返回Unknown
+    static MessageType messageType(const QString &topic);
+
+    // 按数据类型把指标的值转换为变量值；没有标量值或类型不支持时返回false。
+    // datatype为0时按值所在的字段推断
+    static bool toTagValue(const SparkplugMetric &metric, quint32 datatype,
+                           TagValue *value, TagType *type);
+
+    // 请求边缘节点重新发送NBIRTH的NCMD报文（Node Control/Rebirth = true）
+    static QByteArray rebirthRequest(quint64 timestamp);
+
+private:
+    bool parseMetric(const uchar *end, SparkplugMetric *metric);
+    bool readVarint(const uchar *end, quint64 *value);
+    bool readLength(const uchar *end, const uchar **fieldEnd);
+    bool skipField(const uchar *end, int wireType);
+    bool fail(const char *error);
+
+    const uchar *m_begin;   // 报文起始
+    const uchar *m_pos;     // 当前扫描位置
+    int m_metricCount;      // 已解码的指标数
+    int m_sequence;         // 报文序号（0~255），-1表示没有
+    const char *m_error;    // 错误描述
+    int m_errorOffset;      // 出错位置
+};
+
+#endif // SPARKPLUGDECODER_H
@@ -0,0 +1,116 @@
+#include "sparkplugencoder.h"
+#include <QtEndian>
+#include <cstring>
+#include "sparkplugdecoder.h"
+
+namespace {
+
+// protobuf线格式
+enum {
+    WireVarint = 0,
+    WireFixed64 = 1,
+    WireLength = 2
+};
+
+// Payload的字段
+enum {
+    PayloadTimestamp = 1,
+    PayloadMetrics = 2,
+    PayloadSeq = 3
+};
+
+// Metric的字段
+enum {
+    MetricName = 1,
+    MetricAlias = 2,
+    MetricDatatype = 4,
+    MetricDoubleValue = 13,
+    MetricBooleanValue = 14
+};
+
+}
+
+SparkplugEncoder::SparkplugEncoder(QByteArray *out)
+    : m_out(out)
+{
+}
+
+void SparkplugEncoder::addTimestamp(quint64 timestamp)
+{
+    appendKey(m_out, PayloadTimestamp, WireVarint);
+    appendVarint(m_out, timestamp);
+}
+
+void SparkplugEncoder::addSequence(quint64 sequence)
+{
+    appendKey(m_out, PayloadSeq, WireVarint);
+    appendVarint(m_out, sequence);
+}
+
+void SparkplugEncoder::addDoubleMetric(const QByteArray &name, quint64 alias, double value)
+{
+    // 字段头都只占1字节：名称、别名、数据类型各自的长度加上8字节的double_value
+    int size = 1 + varintSize(alias) + 1 + 8;
+    if (!name.isEmpty()) {
+        size += 1 + varintSize(quint64(name.size())) + name.size() + 2;
+    }
+    appendKey(m_out, PayloadMetrics, WireLength);
+    appendVarint(m_out, quint64(size));
+
+    if (!name.isEmpty()) {
+        appendKey(m_out, MetricName, WireLength);
+        appendVarint(m_out, quint64(name.size()));
+        m_out->append(name);
+    }
+    appendKey(m_out, MetricAlias, WireVarint);
+    appendVarint(m_out, alias);
+    if (!name.isEmpty()) {
+        appendKey(m_out, MetricDatatype, WireVarint);
+        appendVarint(m_out, SparkplugDecoder::Double);
+    }
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uchar data[8];
+    qToLittleEndian<quint64>(bits, data);
+    appendKey(m_out, MetricDoubleValue, WireFixed64);
+    m_out->append(reinterpret_cast<const char *>(data), sizeof(data));
+}
+
+void SparkplugEncoder::addBooleanMetric(const QByteArray &name, bool value)
+{
+    int size = 1 + varintSize(quint64(name.size())) + name.size() + 2 + 2;
+    appendKey(m_out, PayloadMetrics, WireLength);
+    appendVarint(m_out, quint64(size));
+
+    appendKey(m_out, MetricName, WireLength);
+    appendVarint(m_out, quint64(name.size()));
+    m_out->append(name);
+    appendKey(m_out, MetricDatatype, WireVarint);
+    appendVarint(m_out, SparkplugDecoder::Boolean);
+    appendKey(m_out, MetricBooleanValue, WireVarint);
+    appendVarint(m_out, value ? 1 : 0);
+}
+
+void SparkplugEncoder::appendVarint(QByteArray *out, quint64 value)
+{
+    while (value >= 0x80) {
+        out->append(char(value | 0x80));
+        value >>= 7;
+    }
+    out->append(char(value));
+}
+
+void SparkplugEncoder::appendKey(QByteArray *out, int field, int wireType)
+{
+    appendVarint(out, (quint64(field) << 3) | quint64(wireType));
+}
+
+int SparkplugEncoder::varintSize(quint64 value)
+{
+    int size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
@@ -0,0 +1,37 @@
+#ifndef SPARKPLUGENCODER_H
+#define SPARKPLUGENCODER_H
+
+#include <QByteArray>
+
+/**
+ * @brief Sparkplug B报文编码
+ * 按protobuf线格式直接在缓冲区末尾写出Payload的时间戳、指标和序号，
+ * 指标长度预先算出，不经过临时缓冲区。
+ * 运行时用它生成Rebirth命令，负载生成器、基准测试和测试用它生成BIRTH和DATA报文
+ */
+class SparkplugEncoder
+{
+public:
+    // 编码追加到out末尾，out原有内容保留（可以是复用的缓冲区）
+    explicit SparkplugEncoder(QByteArray *out);
+
+    // Payload的时间戳（毫秒）和序号
+    void addTimestamp(quint64 timestamp);
+    void addSequence(quint64 sequence);
+
+    // Double指标：name非空时（BIRTH中）同时写出名称和数据类型，为空时（DATA中）只带别名
+    void addDoubleMetric(const QByteArray &name, quint64 alias, double value);
+
+    // 不带别名的布尔指标（命令报文）
+    void addBooleanMetric(const QByteArray &name, bool value);
+
+    // protobuf的varint和字段头
+    static void appendVarint(QByteArray *out, quint64 value);
+    static void appendKey(QByteArray *out, int field, int wireType);
+    static int varintSize(quint64 value);
+
+private:
+    QByteArray *m_out;
+};
+
+#endif // SPARKPLUGENCODER_H
@@ -0,0 +1,175 @@
+#include "subscriptionmanager.h"
+#include <QtMqtt/qmqttsubscription.h>
+#include "logcategories.h"
+
+namespace {
+// 只关心最新值，QoS 0时服务器不会为离线期间缓存报文
+const quint8 kQos = 0;
+}
+
+SubscriptionManager::SubscriptionManager(QMqttClient *client, QObject *parent)
+    : QObject(parent)
+    , m_client(client)
+    , m_flushTimer(new QTimer(this))
+    , m_connected(false)
+    , m_sessionRestored(false)
+    , m_active(0)
+{
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(0);
+    connect(m_flushTimer, &QTimer::timeout, this, &SubscriptionManager::flush);
+
+    connect(m_client, &QMqttClient::stateChanged,
+            this, &SubscriptionManager::handleStateChanged);
+    connect(m_client, &QMqttClient::brokerSessionRestored,
+            this, &SubscriptionManager::handleSessionRestored);
+}
+
+void SubscriptionManager::acquire(const QString &filter)
+{
+    Topic &topic = m_topics[filter];
+    if (++topic.refs == 1) {
+        m_unsubscribes.removeAll(filter);
+        schedule();
+    }
+}
+
+void SubscriptionManager::release(const QString &filter)
+{
+    auto it = m_topics.find(filter);
+    if (it == m_topics.end() || --it->refs > 0) {
+        return;
+    }
+
+    // 服务器上可能存在的订阅在连接时取消（持久会话下断开期间订阅仍然保留）
+    bool onBroker = it->confirmed || it->subscription;
+    setConfirmed(&it.value(), false);
+    if (it->subscription) {
+        disconnect(it->subscription, nullptr, this, nullptr);
+    }
+    m_topics.erase(it);
+    if (onBroker) {
+        m_unsubscribes.append(filter);
+        schedule();
+    }
+}
+
+void SubscriptionManager::schedule()
+{
+    // 未连接时先登记，连接后统一处理
+    if (m_connected && !m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void SubscriptionManager::setConfirmed(Topic *topic, bool confirmed)
+{
+    if (topic->confirmed == confirmed) {
+        return;
+    }
+    topic->confirmed = confirmed;
+    m_active += confirmed ? 1 : -1;
+    if (m_connected) {
+        emit activeCountChanged(m_active);
+    }
+}
+
+void SubscriptionManager::handleStateChanged(QMqttClient::ClientState state)
+{
+    switch (state) {
+    case QMqttClient::Connected:
+        // brokerSessionRestored在收到CONNACK时、Connected之前发出，这里不能清除该标记；
+        // 等本轮事件处理完再核对订阅
+        m_flushTimer->start();
+        break;
+    case QMqttClient::Disconnected:
+        // 本次连接的订阅对象作废；已确认的标记保留，会话恢复时仍然有效
+        m_connected = false;
+        m_sessionRestored = false;
+        m_flushTimer->stop();
+        for (Topic &topic : m_topics) {
+            if (topic.subscription) {
+                disconnect(topic.subscription, nullptr, this, nullptr);
+                topic.subscription = nullptr;
+            }
+        }
+        emit activeCountChanged(0);
+        break;
+    case QMqttClient::Connecting:
+        // 新的连接是否恢复了会话由本次CONNACK决定
+        m_sessionRestored = false;
+        break;
+    }
+}
+
+void SubscriptionManager::handleSessionRestored()
+{
+    m_sessionRestored = true;
+}
+
+void SubscriptionManager::flush()
+{
+    if (m_client->state() != QMqttClient::Connected) {
+        return;
+    }
+
+    if (!m_connected) {
+        // 连接后的第一次核对：服务器没有恢复会话时之前的订阅都已失效
+        if (!m_sessionRestored) {
+            for (Topic &topic : m_topics) {
+                setConfirmed(&topic, false);
+            }
+            m_unsubscribes.clear();
+        }
+        m_connected = true;
+        emit activeCountChanged(m_active);
+    }
+
+    int unsubscribed = m_unsubscribes.size();
+    for (const QString &filter : m_unsubscribes) {
+        m_client->unsubscribe(filter);
+    }
+    m_unsubscribes.clear();
+
+    // 一次发出所有缺少的订阅，不等待逐个确认
+    int subscribed = 0;
+    for (auto it = m_topics.begin(); it != m_topics.end(); ++it) {
+        Topic &topic = it.value();
+        if (topic.confirmed || topic.subscription) {
+            continue;
+        }
+
+        QString filter = it.key();
+        QMqttSubscription *subscription = m_client->subscribe(filter, kQos);
+        if (!subscription) {
+            qCWarning(lcMqtt) << "Failed to subscribe to topic:" << filter;
+            continue;
+        }
+        topic.subscription = subscription;
+        ++subscribed;
+
+        connect(subscription, &QMqttSubscription::stateChanged, this,
+                [this, filter, subscription](QMqttSubscription::SubscriptionState state) {
+            auto it = m_topics.find(filter);
+            if (it == m_topics.end() || it->subscription != subscription) {
+                return;
+            }
+            if (state == QMqttSubscription::Subscribed) {
+                setConfirmed(&it.value(), true);
+            } else if (state == QMqttSubscription::Error) {
+                // 下次核对时重试
+                qCWarning(lcMqtt) << "Subscription rejected for topic:" << filter;
+                disconnect(subscription, nullptr, this, nullptr);
+                it->subscription = nullptr;
+                setConfirmed(&it.value(), false);
+            }
+        });
+        if (subscription->state() == QMqttSubscription::Subscribed) {
+            setConfirmed(&topic, true);
+        }
+    }
+
+    qCInfo(lcMqtt) << "Subscriptions:" << m_topics.size() << "topics," << subscribed << "subscribed,"
+                   << unsubscribed << "unsubscribed"
+                   << (m_sessionRestored ? "(broker session restored)" : "");
+}
@@ -0,0 +1,62 @@
+#ifndef SUBSCRIPTIONMANAGER_H
+#define SUBSCRIPTIONMANAGER_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+#include <QtMqtt/qmqttclient.h>
+
+/**
+ * @brief MQTT订阅管理
+ * 按主题计引用，同一主题只订阅一次，引用归零时才取消订阅。
+ * 订阅变化先登记，在下一次事件循环中集中发出；连接断开期间的变化在连上后一并补发。
+ * 使用持久会话时，服务器恢复了会话则不重发已确认的订阅，重连只需一次握手
+ */
+class SubscriptionManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SubscriptionManager(QMqttClient *client, QObject *parent = nullptr);
+
+    // 增加主题的引用，首次引用时订阅
+    void acquire(const QString &filter);
+
+    // 减少主题的引用，引用归零时取消订阅
+    void release(const QString &filter);
+
+    // 当前引用中的主题
+    QStringList topics() const { return m_topics.keys(); }
+
+    // 服务器已确认的订阅个数（断开连接时为0）
+    int activeCount() const { return m_connected ? m_active : 0; }
+
+signals:
+    // 已确认的订阅个数变化
+    void activeCountChanged(int count);
+
+private slots:
+    void handleStateChanged(QMqttClient::ClientState state);
+    void handleSessionRestored();
+    void flush();
+
+private:
+    struct Topic {
+        int refs = 0;                               // 引用计数
+        QMqttSubscription *subscription = nullptr;  // 本次连接中发出的订阅
+        bool confirmed = false;                     // 服务器已确认（会话恢复时仍然有效）
+    };
+
+    void schedule();
+    void setConfirmed(Topic *topic, bool confirmed);
+
+    QMqttClient *m_client;
+    QHash<QString, Topic> m_topics;     // 主题到订阅状态
+    QStringList m_unsubscribes;         // 引用归零、尚未发出取消订阅的主题
+    QTimer *m_flushTimer;               // 合并同一轮事件中的订阅变化
+    bool m_connected;                   // 已连接且完成了连接后的核对
+    bool m_sessionRestored;             // 本次连接服务器恢复了之前的会话
+    int m_active;                       // 已确认的订阅个数
+};
+
+#endif // SUBSCRIPTIONMANAGER_H
@@ -0,0 +1,48 @@
+#include "tagtable.h"
+
+TagTable::TagTable()
+{
+}
+
+void TagTable::clear()
+{
+    m_ids.clear();
+    m_topics.clear();
+    m_addresses.clear();
+    m_values.clear();
+    m_types.clear();
+    m_flags.clear();
+    m_changed.clear();
+}
+
+int TagTable::intern(const QString &topic, const QString &address, TagType type)
+{
+    QPair<QString, QString> key(topic, address);
+    auto it = m_ids.constFind(key);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+
+    int tag = m_addresses.size();
+    m_ids.insert(key, tag);
+    m_topics.append(topic);
+    m_addresses.append(address);
+    m_values.append(TagValue::fromInt(0));
+    m_types.append(quint8(type));
+    m_flags.append(0);
+    return tag;
+}
+
+int TagTable::tagId(const QString &topic, const QString &address) const
+{
+    return m_ids.value(qMakePair(topic, address), -1);
+}
+
+void TagTable::takeChanged(QVector<int> *tags)
+{
+    tags->clear();
+    tags->swap(m_changed);
+    for (int tag : *tags) {
+        m_flags[tag] &= ~kChangedFlag;
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef TAGTABLE_H
+#define TAGTABLE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include "tagvalue.h"
+
+/**
+ * @brief 变量表
+ * 绑定的(主题, 地址)在配置阶段一次性映射为从0开始的稠密整数ID，
+ * 运行期按ID直接访问连续的数值数组。不同主题下的相同地址是不同的变量。
+ * 每个变量按配置的数据类型存放（TagValue），类型与变化标记分开存放：
+ * 类型只在登记时写入，采集线程读取时不会与界面线程写变化标记冲突。
+ * 通过update写入的值会合并到变化集合中，每帧只需处理变化过的变量
+ */
+class TagTable
+{
+public:
+    TagTable();
+
+    // 清空所有变量
+    void clear();
+
+    // 登记主题下的地址并返回其ID，已登记的返回原ID（类型以首次登记为准）
+    int intern(const QString &topic, const QString &address, TagType type = TagDouble);
+
+    // 按主题和地址查找ID，未登记时返回-1
+    int tagId(const QString &topic, const QString &address) const;
+
+    // 变量个数
+    int size() const { return m_addresses.size(); }
+
+    // ID对应的主题和地址
+    const QString &topic(int tag) const { return m_topics.at(tag); }
+    const QString &address(int tag) const { return m_addresses.at(tag); }
+
+    // 变量的数据类型（登记后不再变化，可在采集线程读取）
+    inline TagType type(int tag) const { return TagType(m_types.at(tag)); }
+
+    // 读写数值，value须已是变量的类型
+    inline TagValue value(int tag) const { return m_values.at(tag); }
+    inline void setValue(int tag, TagValue value) { m_values[tag] = value; }
+
+    // 按double读取，供不区分类型的接口使用
+    inline double toDouble(int tag) const { return m_values.at(tag).toDouble(type(tag)); }
+
+    // 更新数值并记入变化集合，同一变量在两次取出之间只记一次。
+    // value须已是变量的类型。返回true表示变化集合由空变为非空
+    inline bool update(int tag, TagValue value)
+    {
+        if (m_values.at(tag).equals(value, type(tag))) {
+            return false;
+        }
+        m_values[tag] = value;
+        quint8 flags = m_flags.at(tag);
+        if (flags & kChangedFlag) {
+            return false;
+        }
+        m_flags[tag] = flags | kChangedFlag;
+        m_changed.append(tag);
+        return m_changed.size() == 1;
+    }
+
+    // 是否有待处理的变化
+    bool hasChanges() const { return !m_changed.isEmpty(); }
+
+    // 取出自上次调用以来变化过的变量ID（tags原有内容被丢弃，容量保留复用）
+    void takeChanged(QVector<int> *tags);
+
+private:
+    static const quint8 kChangedFlag = 0x80;        // 标记字节中的变化位
+
+    QHash<QPair<QString, QString>, int> m_ids;  // (主题, 地址)到ID
+    QVector<QString> m_topics;      // ID到主题
+    QVector<QString> m_addresses;   // ID到地址
+    QVector<TagValue> m_values;     // ID到当前值
+    QVector<quint8> m_types;        // ID到类型，只在intern中写入
+    QVector<quint8> m_flags;        // 是否已在变化集合中（最高位），只在界面线程读写
+    QVector<int> m_changed;         // 变化集合
+};
+
+#endif // TAGTABLE_H
@@ -0,0 +1,27 @@
+#include "tagvalue.h"
+
+TagType tagTypeFromName(const QString &dataType)
+{
+    QString name = dataType.trimmed().toLower();
+    if (name == QLatin1String("bool") || name == QLatin1String("boolean")
+            || name == QLatin1String("bit") || name == QLatin1String("digital")) {
+        return TagBool;
+    }
+    if (name == QLatin1String("int") || name == QLatin1String("integer")
+            || name == QLatin1String("long") || name == QLatin1String("dint")
+            || name == QLatin1String("word") || name == QLatin1String("dword")
+            || name == QLatin1String("counter")) {
+        return TagInt;
+    }
+
+    // int8~int64、uint8~uint64
+    QString bits;
+    if (name.startsWith(QLatin1String("uint"))) {
+        bits = name.mid(4);
+    } else if (name.startsWith(QLatin1String("int"))) {
+        bits = name.mid(3);
+    }
+    bool ok = false;
+    bits.toInt(&ok);
+    return ok ? TagInt : TagDouble;
+}
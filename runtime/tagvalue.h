@@ -0,0 +1,64 @@
+#ifndef TAGVALUE_H
+#define TAGVALUE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <cmath>
+
+/**
+ * @brief 变量的数据类型，由变量配置的dataType决定
+ */
+enum TagType : quint8 {
+    TagDouble = 0,  // float/double/real
+    TagInt = 1,     // 整数，按64位有符号存放
+    TagBool = 2     // 开关量，存放为0/1
+};
+
+/**
+ * @brief 变量值
+ * 固定8字节，按TagType解释：TagDouble使用d，TagInt和TagBool使用i。
+ * 64位整数不经过double，计数器等大整数不丢精度
+ */
+union TagValue {
+    double d;
+    qint64 i;
+
+    static TagValue fromDouble(double value) { TagValue v; v.d = value; return v; }
+    static TagValue fromInt(qint64 value) { TagValue v; v.i = value; return v; }
+    static TagValue fromBool(bool value) { TagValue v; v.i = value ? 1 : 0; return v; }
+
+    // 按类型转换为double（用于通用接口和显示回退）
+    double toDouble(TagType type) const { return type == TagDouble ? d : double(i); }
+
+    // 从解码得到的类型转换为变量的类型
+    inline TagValue convert(TagType from, TagType to) const
+    {
+        if (from == to) {
+            return *this;
+        }
+        switch (to) {
+        case TagDouble:
+            return fromDouble(double(i));
+        case TagInt:
+            if (from == TagBool) {
+                return *this;
+            }
+            // 超出范围或非数按0处理，与QJsonValue::toInt的取值习惯一致
+            return fromInt(std::isfinite(d) && std::fabs(d) < 9.2e18 ? qint64(std::llround(d)) : 0);
+        case TagBool:
+            return fromBool(from == TagDouble ? d != 0.0 : i != 0);
+        }
+        return *this;
+    }
+
+    // 两个同类型的值是否相等
+    inline bool equals(const TagValue &other, TagType type) const
+    {
+        return type == TagDouble ? d == other.d : i == other.i;
+    }
+};
+
+// 配置中的数据类型名对应的类型，未识别的按TagDouble处理
+TagType tagTypeFromName(const QString &dataType);
+
+#endif // TAGVALUE_H
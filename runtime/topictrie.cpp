@@ -0,0 +1,125 @@
+#include "topictrie.h"
+#include <algorithm>
+
+TopicTrie::TopicTrie()
+{
+    clear();
+}
+
+void TopicTrie::clear()
+{
+    m_nodes.clear();
+    m_nodes.append(Node());
+    m_routes.clear();
+}
+
+bool TopicTrie::isWildcard(const QString &filter)
+{
+    return filter.contains(QLatin1Char('+')) || filter.contains(QLatin1Char('#'));
+}
+
+int TopicTrie::insert(const QString &filter)
+{
+    int node = 0;
+    int begin = 0;
+    for (;;) {
+        int end = filter.indexOf(QLatin1Char('/'), begin);
+        if (end < 0) {
+            end = filter.size();
+        }
+        QStringRef level = filter.midRef(begin, end - begin);
+
+        if (level == QLatin1String("#")) {
+            // #只能出现在最后一层
+            if (m_nodes.at(node).hash < 0) {
+                m_nodes[node].hash = m_routes.size();
+                m_routes.append(filter);
+            }
+            return m_nodes.at(node).hash;
+        }
+
+        int child;
+        if (level == QLatin1String("+")) {
+            child = m_nodes.at(node).plus;
+            if (child < 0) {
+                child = m_nodes.size();
+                m_nodes.append(Node());
+                m_nodes[node].plus = child;
+            }
+        } else {
+            child = findChild(m_nodes.at(node), level);
+            if (child < 0) {
+                child = m_nodes.size();
+                m_nodes.append(Node());
+                QVector<Edge> &children = m_nodes[node].children;
+                auto it = std::lower_bound(children.begin(), children.end(), level,
+                                           [](const Edge &edge, const QStringRef &name) {
+                                               return edge.level.compare(name) < 0;
+                                           });
+                children.insert(it, Edge{level.toString(), child});
+            }
+        }
+        node = child;
+
+        if (end == filter.size()) {
+            break;
+        }
+        begin = end + 1;
+    }
+
+    if (m_nodes.at(node).route < 0) {
+        m_nodes[node].route = m_routes.size();
+        m_routes.append(filter);
+    }
+    return m_nodes.at(node).route;
+}
+
+int TopicTrie::match(const QString &topic) const
+{
+    return matchFrom(0, topic, 0);
+}
+
+int TopicTrie::findChild(const Node &node, const QStringRef &level) const
+{
+    auto it = std::lower_bound(node.children.constBegin(), node.children.constEnd(), level,
+                               [](const Edge &edge, const QStringRef &name) {
+                                   return edge.level.compare(name) < 0;
+                               });
+    if (it != node.children.constEnd() && it->level == level) {
+        return it->node;
+    }
+    return -1;
+}
+
+int TopicTrie::matchFrom(int nodeIndex, const QString &topic, int begin) const
+{
+    const Node &node = m_nodes.at(nodeIndex);
+    int end = topic.indexOf(QLatin1Char('/'), begin);
+    bool last = end < 0;
+    if (last) {
+        end = topic.size();
+    }
+
+    // 以$开头的主题（如$SYS/...）不匹配首层的"+"和"#"，只能由精确层级订阅
+    bool wildcards = begin > 0 || !topic.startsWith(QLatin1Char('$'));
+
+    // 依次尝试精确层级和"+"，"#"同时匹配父层级（a/#匹配a）
+    const int candidates[] = { findChild(node, topic.midRef(begin, end - begin)),
+                               wildcards ? node.plus : -1 };
+    for (int child : candidates) {
+        if (child < 0) {
+            continue;
+        }
+        int route;
+        if (last) {
+            const Node &leaf = m_nodes.at(child);
+            route = leaf.route >= 0 ? leaf.route : leaf.hash;
+        } else {
+            route = matchFrom(child, topic, end + 1);
+        }
+        if (route >= 0) {
+            return route;
+        }
+    }
+    return wildcards ? node.hash : -1;
+}
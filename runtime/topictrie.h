@@ -0,0 +1,55 @@
+#ifndef TOPICTRIE_H
+#define TOPICTRIE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief 主题前缀树
+ * 按"/"分隔的层级登记主题（可含MQTT的+和#通配符），每个主题对应一个路由编号。
+ * 查找时逐层匹配，不分配内存，精确层级优先于+，+优先于#；
+ * 与MQTT一致，以$开头的主题不匹配首层的+和#
+ */
+class TopicTrie
+{
+public:
+    TopicTrie();
+
+    // 清空所有路由
+    void clear();
+
+    // 登记主题并返回其路由编号，已登记的主题返回原编号
+    int insert(const QString &filter);
+
+    // 与主题匹配的路由编号，没有时返回-1
+    int match(const QString &topic) const;
+
+    // 路由个数和路由编号对应的主题
+    int routeCount() const { return m_routes.size(); }
+    const QString &route(int index) const { return m_routes.at(index); }
+
+    // 主题是否包含通配符
+    static bool isWildcard(const QString &filter);
+
+private:
+    struct Edge {
+        QString level;          // 层级名
+        int node;               // 子节点
+    };
+
+    struct Node {
+        QVector<Edge> children; // 按层级名排序的子节点
+        int plus = -1;          // "+"子节点
+        int route = -1;         // 到此为止的主题的路由
+        int hash = -1;          // "#"的路由（匹配本层及以下所有层级）
+    };
+
+    int findChild(const Node &node, const QStringRef &level) const;
+    int matchFrom(int node, const QString &topic, int begin) const;
+
+    QVector<Node> m_nodes;      // 节点0为根
+    QStringList m_routes;       // 路由编号对应的主题
+};
+
+#endif // TOPICTRIE_H
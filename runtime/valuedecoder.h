@@ -0,0 +1,89 @@
+#ifndef VALUEDECODER_H
+#define VALUEDECODER_H
+
+#include <QByteArray>
+#include <cstring>
+#include "valuesink.h"
+
+/**
+ * @brief 数据报文解码器的公共接口
+ * 各格式的解码器都在原始字节上单遍扫描 {timestamp, body:[{addr,val}]}，
+ * 逐个数据点回调ValueSink，不构造中间对象
+ */
+class ValueDecoder
+{
+public:
+    // 报文格式
+    enum Format {
+        Json,       // JSON文本
+        Cbor,       // CBOR，结构与JSON相同
+        Packed      // 定长记录，见PackedValueDecoder
+    };
+
+    virtual ~ValueDecoder() {}
+
+    // 解码报文，逐个数据点回调sink；格式错误时返回false
+    virtual bool decode(const QByteArray &payload, ValueSink *sink) = 0;
+
+    // 最近一次解码的结果
+    int sampleCount() const { return m_sampleCount; }
+    bool hasBody() const { return m_hasBody; }
+    const char *errorString() const { return m_error; }
+    int errorOffset() const { return m_errorOffset; }
+
+    // 按报文开头的字节判断格式：定长记录以"SCPK"开头，
+    // CBOR以映射（0xa0~0xbf）或自描述标签（0xd9d9f7）开头，其余按JSON处理
+    static Format sniff(const QByteArray &payload)
+    {
+        if (payload.size() >= 4 && memcmp(payload.constData(), "SCPK", 4) == 0) {
+            return Packed;
+        }
+        if (!payload.isEmpty()) {
+            uchar first = uchar(payload.at(0));
+            if ((first >= 0xa0 && first <= 0xbf) || first == 0xd9) {
+                return Cbor;
+            }
+        }
+        return Json;
+    }
+
+protected:
+    ValueDecoder()
+        : m_sampleCount(0)
+        , m_hasBody(false)
+        , m_error(nullptr)
+        , m_errorOffset(-1)
+    {
+    }
+
+    // 无符号整数格式化为十进制（用于把二进制时间戳转成与JSON相同的文本），返回长度
+    static int formatUnsigned(quint64 value, char (&buffer)[24])
+    {
+        char digits[24];
+        int count = 0;
+        do {
+            digits[count++] = char('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        for (int i = 0; i < count; ++i) {
+            buffer[i] = digits[count - 1 - i];
+        }
+        return count;
+    }
+
+    // 开始解码新的报文
+    void reset()
+    {
+        m_sampleCount = 0;
+        m_hasBody = false;
+        m_error = nullptr;
+        m_errorOffset = -1;
+    }
+
+    int m_sampleCount;      // 已解码的数据点数
+    bool m_hasBody;         // 是否包含body数组
+    const char *m_error;    // 错误描述
+    int m_errorOffset;      // 出错位置
+};
+
+#endif // VALUEDECODER_H
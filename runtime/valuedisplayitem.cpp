@@ -0,0 +1,267 @@
+#include "valuedisplayitem.h"
+#include <QPainter>
+#include <QRawFont>
+#include <QGlyphRun>
+#include <QFont>
+#include <QFontMetricsF>
+#include <QtMath>
+#include <cstring>
+#include <cmath>
+
+namespace {
+
+const qreal kTextMargin = 14;   // 文本相对边框的偏移（与原QGraphicsTextItem位置一致）
+
+/**
+ * @brief 等宽数字字形缓存
+ * 所有数值显示组件共享，只在界面线程使用
+ */
+class DigitGlyphs
+{
+public:
+    DigitGlyphs()
+        : m_cellWidth(0)
+        , m_ascent(0)
+        , m_descent(0)
+    {
+        memset(m_glyphs, 0, sizeof(m_glyphs));
+        memset(m_offsets, 0, sizeof(m_offsets));
+
+        m_font = QRawFont::fromFont(QFont());
+        if (!m_font.isValid()) {
+            return;
+        }
+
+        const QString chars = QStringLiteral("0123456789+-.einfa#");
+        QVector<quint32> glyphs = m_font.glyphIndexesForString(chars);
+        if (glyphs.size() != chars.size()) {
+            m_font = QRawFont();
+            return;
+        }
+        QVector<QPointF> advances = m_font.advancesForGlyphIndexes(glyphs);
+
+        // 单元宽度取所有字符的最大宽度，数值变化时各字符位置固定
+        for (int i = 0; i < chars.size(); ++i) {
+            m_cellWidth = qMax(m_cellWidth, advances.at(i).x());
+        }
+        for (int i = 0; i < chars.size(); ++i) {
+            int c = chars.at(i).toLatin1();
+            m_glyphs[c] = glyphs.at(i);
+            m_offsets[c] = (m_cellWidth - advances.at(i).x()) / 2;
+        }
+        m_ascent = m_font.ascent();
+        m_descent = m_font.descent();
+        m_run.setRawFont(m_font);
+    }
+
+    bool isValid() const { return m_font.isValid(); }
+    qreal cellWidth() const { return m_cellWidth; }
+    qreal lineHeight() const { return m_ascent + m_descent; }
+
+    // 在指定位置绘制文本，字形和位置数组都在栈上
+    void draw(QPainter *painter, const QPointF &origin, const char *text, int length)
+    {
+        quint32 glyphs[ValueDisplayItem::kMaxLength];
+        QPointF positions[ValueDisplayItem::kMaxLength];
+        for (int i = 0; i < length; ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]) & 0x7f;
+            glyphs[i] = m_glyphs[c];
+            positions[i] = QPointF(origin.x() + i * m_cellWidth + m_offsets[c],
+                                   origin.y() + m_ascent);
+        }
+        m_run.setRawData(glyphs, positions, length);
+        painter->drawGlyphRun(QPointF(0, 0), m_run);
+    }
+
+private:
+    QRawFont m_font;            // 默认字体
+    QGlyphRun m_run;            // 复用的字形串，避免每次绘制分配
+    quint32 m_glyphs[128];      // 字符到字形索引
+    qreal m_offsets[128];       // 字符在单元内的居中偏移
+    qreal m_cellWidth;          // 等宽单元宽度
+    qreal m_ascent;             // 基线偏移
+    qreal m_descent;            // 基线以下高度
+};
+
+DigitGlyphs &digitGlyphs()
+{
+    static DigitGlyphs glyphs;
+    return glyphs;
+}
+
+// 文本超出最大长度时整段显示为#，不显示被截断后看似有效的数字
+int formatOverflow(char *buffer, int size)
+{
+    memset(buffer, '#', size_t(size));
+    return size;
+}
+
+// 区域设置无关的定点格式化，超出快速路径时回退到QString::number
+int formatValue(double value, const ValueFormat &format, char *buffer, int size)
+{
+    static const qint64 kScale[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+    if (format.format == 'f' && format.precision >= 0 && format.precision <= 9
+            && qIsFinite(value) && qAbs(value) * double(kScale[format.precision]) < 1e18) {
+        qint64 scale = kScale[format.precision];
+        qint64 scaled = std::llround(qAbs(value) * double(scale));
+        qint64 integer = scaled / scale;
+        qint64 fraction = scaled % scale;
+
+        char digits[32];
+        int count = 0;
+        for (int i = 0; i < format.precision; ++i) {
+            digits[count++] = char('0' + fraction % 10);
+            fraction /= 10;
+        }
+        if (format.precision > 0) {
+            digits[count++] = '.';
+        }
+        do {
+            digits[count++] = char('0' + integer % 10);
+            integer /= 10;
+        } while (integer > 0);
+        // 舍入为0的负数保留符号（"-0.0"），与QString::number和printf一致
+        if (std::signbit(value)) {
+            digits[count++] = '-';
+        }
+
+        if (count > size) {
+            return formatOverflow(buffer, size);
+        }
+        for (int i = 0; i < count; ++i) {
+            buffer[i] = digits[count - 1 - i];
+        }
+        return count;
+    }
+
+    QByteArray text = QString::number(value, format.format, format.precision).toLatin1();
+    if (text.size() > size) {
+        return formatOverflow(buffer, size);
+    }
+    memcpy(buffer, text.constData(), size_t(text.size()));
+    return text.size();
+}
+
+// 整数按十进制原样输出，64位整数不经过double
+int formatInteger(qint64 value, char *buffer, int size)
+{
+    char digits[24];
+    int count = 0;
+    quint64 magnitude = value < 0 ? 0 - quint64(value) : quint64(value);
+    do {
+        digits[count++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        digits[count++] = '-';
+    }
+
+    if (count > size) {
+        return formatOverflow(buffer, size);
+    }
+    for (int i = 0; i < count; ++i) {
+        buffer[i] = digits[count - 1 - i];
+    }
+    return count;
+}
+
+} // namespace
+
+ValueDisplayItem::ValueDisplayItem(qreal width, qreal height, QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , m_size(width, height)
+    , m_length(0)
+{
+    setText("0.0", 3);
+}
+
+void ValueDisplayItem::setValue(TagValue value, TagType type, const ValueFormat &format)
+{
+    char text[kMaxLength];
+    int length;
+    switch (type) {
+    case TagInt:
+        length = formatInteger(value.i, text, kMaxLength);
+        break;
+    case TagBool:
+        text[0] = value.i ? '1' : '0';
+        length = 1;
+        break;
+    default:
+        length = formatValue(value.d, format, text, kMaxLength);
+        break;
+    }
+    setText(text, length);
+}
+
+void ValueDisplayItem::setText(const char *text, int length)
+{
+    if (length == m_length && memcmp(text, m_text, size_t(length)) == 0) {
+        return;
+    }
+    memcpy(m_text, text, size_t(length));
+    m_length = quint8(length);
+
+    // 文本区域固定，只需重绘本组件
+    update();
+}
+
+QRectF ValueDisplayItem::boundingRect() const
+{
+    // 包含边框线宽
+    return QRectF(QPointF(0, 0), m_size).adjusted(-0.5, -0.5, 0.5, 0.5);
+}
+
+void ValueDisplayItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    painter->setPen(QPen(Qt::black, 1));
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRect(QRectF(QPointF(0, 0), m_size));
+
+    DigitGlyphs &glyphs = digitGlyphs();
+    qreal lineHeight = glyphs.isValid() ? glyphs.lineHeight() : painter->fontMetrics().height();
+
+    // 组件比一行文字还矮时文字会超出boundingRect，只重绘脏区域时留下残影，
+    // 此时裁剪到边框内（视图设置了DontSavePainterState，需自行保存状态）。
+    // 没有字形缓存时按字体度量绘制，宽度不可控，总是裁剪
+    bool clip = m_size.height() < lineHeight || !glyphs.isValid();
+    if (clip) {
+        painter->save();
+        painter->setClipRect(boundingRect(), Qt::IntersectClip);
+    }
+
+    if (!glyphs.isValid()) {
+        // 与字形路径一致：放不下时显示为#
+        QFontMetricsF metrics(painter->font());
+        qreal available = m_size.width() - kTextMargin;
+        QString value = text();
+        if (metrics.horizontalAdvance(value) > available) {
+            int cells = int(available / metrics.horizontalAdvance(QLatin1Char('#')));
+            value = QString(qBound(0, cells, int(kMaxLength)), QLatin1Char('#'));
+        }
+        painter->drawText(QPointF(kTextMargin, kTextMargin + metrics.ascent()), value);
+    } else {
+        // 文本尽量落在边框内，组件较矮时上移
+        QPointF origin(kTextMargin, qMin(kTextMargin, qMax<qreal>(0, m_size.height() - lineHeight)));
+
+        // 放不下时按表格惯例显示为#
+        int cells = int((m_size.width() - kTextMargin) / glyphs.cellWidth());
+        if (m_length > cells && cells > 0) {
+            char hashes[kMaxLength];
+            int length = qMin(cells, int(kMaxLength));
+            memset(hashes, '#', size_t(length));
+            glyphs.draw(painter, origin, hashes, length);
+        } else if (cells > 0) {
+            glyphs.draw(painter, origin, m_text, m_length);
+        }
+    }
+
+    if (clip) {
+        painter->restore();
+    }
+}
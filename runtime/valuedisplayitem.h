@@ -0,0 +1,41 @@
+#ifndef VALUEDISPLAYITEM_H
+#define VALUEDISPLAYITEM_H
+
+#include <QGraphicsItem>
+#include "bindingtable.h"
+#include "tagvalue.h"
+
+/**
+ * @brief 运行时数值显示组件
+ * 直接绘制边框和数字，数字按等宽字形缓存逐字绘制，
+ * 数值变化只重绘本组件，不引起几何变化，也不持有QTextDocument
+ */
+class ValueDisplayItem : public QGraphicsItem
+{
+public:
+    enum { Type = UserType + 1 };
+
+    ValueDisplayItem(qreal width, qreal height, QGraphicsItem *parent = nullptr);
+
+    // 按变量类型显示数值，浮点数使用指定格式，整数和开关量原样显示；文本未变化时不重绘
+    void setValue(TagValue value, TagType type, const ValueFormat &format);
+
+    // 当前显示的文本
+    QString text() const { return QString::fromLatin1(m_text, m_length); }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+    int type() const override { return Type; }
+
+    static const int kMaxLength = 24;   // 显示文本的最大字符数
+
+private:
+    void setText(const char *text, int length);
+
+    QSizeF m_size;              // 边框大小
+    char m_text[kMaxLength];    // 显示文本（Latin-1）
+    quint8 m_length;            // 文本长度
+};
+
+#endif // VALUEDISPLAYITEM_H
@@ -0,0 +1,24 @@
+#ifndef VALUESINK_H
+#define VALUESINK_H
+
+#include <QtGlobal>
+#include "tagvalue.h"
+
+/**
+ * @brief 解码结果接收接口
+ * 解码器每解析出一个字段就立即回调，不构造中间对象
+ */
+class ValueSink
+{
+public:
+    virtual ~ValueSink() {}
+
+    // 消息时间戳（指向原始报文内部，仅在回调期间有效）
+    virtual void onTimestamp(const char *data, int size) = 0;
+
+    // 一个 {addr, val} 数据点，type为报文中数值本身的类型：
+    // 不带小数和指数的整数为TagInt，true/false为TagBool，其余为TagDouble
+    virtual void onSample(int addr, TagValue value, TagType type) = 0;
+};
+
+#endif // VALUESINK_H
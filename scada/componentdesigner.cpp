@@ -19,7 +19,7 @@
 #include <QBuffer>
 #include <QTextStream>
 #include <QDomProcessingInstruction>
-#include <QDebug>
+#include "logcategories.h"
 #include <QComboBox>
 #include "componentfactory.h"
 
@@ -215,8 +215,8 @@ void ComponentDesigner::saveComponentToLibrary(const QString &name, const QStrin
         QString errorMsg;
         int errorLine, errorColumn;
         if (!doc.setContent(&file, &errorMsg, &errorLine, &errorColumn)) {
-            qDebug() << "Failed to parse existing XML:" << errorMsg 
-                     << "at line" << errorLine << "column" << errorColumn;
+            qCDebug(lcComponents) << "Failed to parse existing XML:" << errorMsg 
+                                  << "at line" << errorLine << "column" << errorColumn;
             // 如果无法解析现有文件，创建新的文档
             QDomProcessingInstruction xmlDeclaration = doc.createProcessingInstruction(
                 "xml", "version=\"1.0\" encoding=\"UTF-8\"");
@@ -329,10 +329,10 @@ void ComponentDesigner::saveComponentToLibrary(const QString &name, const QStrin
         componentElem.appendChild(previewElem);
 
         // 调试输出
-        qDebug() << "Preview image size:" << preview.size();
-        qDebug() << "Base64 data length:" << byteArray.toBase64().length();
+        qCDebug(lcComponents) << "Preview image size:" << preview.size();
+        qCDebug(lcComponents) << "Base64 data length:" << byteArray.toBase64().length();
     } else {
-        qDebug() << "Failed to create preview image";
+        qCDebug(lcComponents) << "Failed to create preview image";
     }
 
     // 将组件元素添加到根元素
@@ -363,12 +363,7 @@ void ComponentDesigner::saveComponentToLibrary(const QString &name, const QStrin
     doc.save(out, 4);  // 使用4个空格缩进
     file.close();
 
-    // 验证保存的文件
-    if (file.open(QIODevice::ReadOnly)) {
-        QString content = QString::fromUtf8(file.readAll());
-        qDebug() << "Saved XML content:" << content;
-        file.close();
-    }
+    qCDebug(lcComponents) << "Saved component library:" << filename << "size:" << file.size();
 
     QMessageBox::information(this, tr("成功"), 
         tr("组件已保存到组件库：%1").arg(name));
@@ -379,7 +374,7 @@ QPixmap ComponentDesigner::createComponentPreview()
     // 获取所有项目的边界矩形
     QRectF bounds = scene->itemsBoundingRect();
     if (bounds.isEmpty()) {
-        qDebug() << "Empty bounds for preview";
+        qCDebug(lcComponents) << "Empty bounds for preview";
         return QPixmap();
     }
     
@@ -420,11 +415,11 @@ QPixmap ComponentDesigner::createComponentPreview()
         Qt::KeepAspectRatio, Qt::SmoothTransformation);
     
     // 调试输出
-    qDebug() << "Scene rect:" << sceneRect;
-    qDebug() << "Bounds rect:" << bounds;
-    qDebug() << "Scale factor:" << scale;
-    qDebug() << "Target rect:" << targetRect;
-    qDebug() << "Final preview size:" << scaledPixmap.size();
+    qCDebug(lcComponents) << "Scene rect:" << sceneRect;
+    qCDebug(lcComponents) << "Bounds rect:" << bounds;
+    qCDebug(lcComponents) << "Scale factor:" << scale;
+    qCDebug(lcComponents) << "Target rect:" << targetRect;
+    qCDebug(lcComponents) << "Final preview size:" << scaledPixmap.size();
     
     return scaledPixmap;
 }
@@ -4,7 +4,7 @@
 #include <QObject>
 #include <QDomDocument>
 #include <QFile>
-#include <QDebug>
+#include "logcategories.h"
 
 // 静态成员变量，用于存储组件库
 static QDomDocument componentLibrary;
@@ -15,22 +15,19 @@ bool ComponentFactory::loadComponentLibrary(const QString &filename)
 {
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "Cannot open component library file:" << filename;
+        qCWarning(lcComponents) << "Cannot open component library file:" << filename;
         return false;
     }
 
     QString errorMsg;
     int errorLine, errorColumn;
     
-    // 读取文件内容进行调试
-    QByteArray content = file.readAll();
-    qDebug() << "XML Content:" << content;
-    file.seek(0);  // 重置文件指针
+    qCDebug(lcComponents) << "Loading component library:" << filename << "size:" << file.size();
 
     if (!componentLibrary.setContent(&file, &errorMsg, &errorLine, &errorColumn)) {
-        qDebug() << "Parse XML failed:" << errorMsg 
-                 << "at line" << errorLine 
-                 << "column" << errorColumn;
+        qCWarning(lcComponents) << "Parse XML failed:" << errorMsg 
+                                << "at line" << errorLine 
+                                << "column" << errorColumn;
         file.close();
         return false;
     }
@@ -40,18 +37,18 @@ bool ComponentFactory::loadComponentLibrary(const QString &filename)
     // 验证文档结构
     QDomElement root = componentLibrary.documentElement();
     if (root.isNull()) {
-        qDebug() << "No root element found";
+        qCWarning(lcComponents) << "No root element found";
         return false;
     }
 
     if (root.tagName() != "components") {
-        qDebug() << "Root element is not 'components', found:" << root.tagName();
+        qCWarning(lcComponents) << "Root element is not 'components', found:" << root.tagName();
         return false;
     }
 
     // 检查是否有组件
     QDomNodeList components = root.elementsByTagName("component");
-    qDebug() << "Found" << components.count() << "components";
+    qCDebug(lcComponents) << "Found" << components.count() << "components";
 
     libraryLoaded = true;
     return true;
@@ -82,23 +79,23 @@ QIcon ComponentFactory::createComponentIcon(const QString &type)
                     QByteArray imageData = QByteArray::fromBase64(previewData.toLatin1());
                     QPixmap pixmap;
                     if (pixmap.loadFromData(imageData, "PNG")) {
-                        qDebug() << "Successfully loaded preview for component:" << type
-                                << "size:" << pixmap.size();
+                        qCDebug(lcComponents) << "Successfully loaded preview for component:" << type
+                                             << "size:" << pixmap.size();
                         return QIcon(pixmap);
                     }
-                    qDebug() << "Failed to load preview image data for component:" << type
-                            << "data length:" << imageData.length();
+                    qCDebug(lcComponents) << "Failed to load preview image data for component:" << type
+                                         << "data length:" << imageData.length();
                 } else {
-                    qDebug() << "Preview data is empty for component:" << type;
+                    qCDebug(lcComponents) << "Preview data is empty for component:" << type;
                 }
             } else {
-                qDebug() << "No preview element found for component:" << type;
+                qCDebug(lcComponents) << "No preview element found for component:" << type;
             }
             break;
         }
     }
 
-    qDebug() << "Using default icon for component:" << type;
+    qCDebug(lcComponents) << "Using default icon for component:" << type;
     return createDefaultIcon(type);
 }
 
@@ -6,6 +6,7 @@
 #include <QDateTime>
 #include <QLibrary>
 #include "componentfactory.h"
+#include "trace.h"
 
 CustomView::CustomView(QGraphicsScene *scene, QWidget *parent)
     : QGraphicsView(scene, parent)
@@ -44,6 +45,7 @@ void CustomView::dropEvent(QDropEvent *event)
         scene()->addItem(item);
         item->setFlag(QGraphicsItem::ItemIsMovable);
         item->setFlag(QGraphicsItem::ItemIsSelectable);
+        item->setCacheMode(QGraphicsItem::DeviceCoordinateCache);  // 拖动时复用缓存
 
         // 生成唯一的组件ID
         QString componentId = QString("Component_%1").arg(
@@ -59,3 +61,9 @@ void CustomView::drawBackground(QPainter *painter, const QRectF &rect)
     QGraphicsView::drawBackground(painter, rect);
     emit backgroundNeedsPaint(painter, rect);
 }
+
+void CustomView::paintEvent(QPaintEvent *event)
+{
+    TRACE_SCOPE("CustomView::paint");
+    QGraphicsView::paintEvent(event);
+}
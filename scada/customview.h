@@ -21,6 +21,7 @@ protected:
     void dragMoveEvent(QDragMoveEvent *event) override;      // 拖动移动事件
     void dropEvent(QDropEvent *event) override;              // 放下事件
     void drawBackground(QPainter *painter, const QRectF &rect) override;
+    void paintEvent(QPaintEvent *event) override;            // 绘制事件（记录跟踪点）
 };
 
 #endif 
\ No newline at end of file
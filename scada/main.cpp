@@ -1,11 +1,43 @@
 #include "mainwindow.h"
 
 #include <QApplication>
+#include "trace.h"
+#include "asynclogger.h"
+#include "logcategories.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    MainWindow w;
-    w.show();
-    return a.exec();
+
+    // 日志由后台线程写出，设置SCADA_LOG_FILE时写入该文件
+    QString logFile = qEnvironmentVariable("SCADA_LOG_FILE");
+    if (!AsyncLogger::install(logFile)) {
+        AsyncLogger::install();
+        qCWarning(lcDesigner) << "Cannot open log file:" << logFile;
+    }
+
+    // 设置SCADA_TRACE_FILE时记录性能跟踪，退出时写出
+    QString traceFile = qEnvironmentVariable("SCADA_TRACE_FILE");
+    if (!traceFile.isEmpty()) {
+        Trace::setThreadName("GUI");
+        Trace::setEnabled(true);
+    }
+
+    int result;
+    {
+        MainWindow w;
+        w.show();
+        result = a.exec();
+    }
+
+    if (!traceFile.isEmpty()) {
+        Trace::setEnabled(false);
+        QString errorString;
+        if (!Trace::writeChromeTrace(traceFile, &errorString)) {
+            qCWarning(lcDesigner) << "Failed to write trace:" << traceFile << errorString;
+        }
+    }
+
+    AsyncLogger::shutdown();
+    return result;
 }
@@ -13,11 +13,12 @@
 #include <QMessageBox>
 #include "xmlconfig.h"
 #include "variablebindingdialog.h"
-#include <QDebug>
+#include "logcategories.h"
 #include "componentfactory.h"
 #include "componentdesigner.h"
 #include <QDomDocument>
 #include <QFile>
+#include "trace.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -45,7 +46,8 @@ void MainWindow::setupGraphicsView()
     // 创建自定义视图并设置基本属性
     view = new CustomView(scene);
     view->setRenderHint(QPainter::Antialiasing);    // 启用抗锯齿
-    view->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);    // 设置视图更新模式
+    view->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);    // 只重绘变化区域
+    view->setCacheMode(QGraphicsView::CacheBackground);    // 缓存网格背景，避免每次重绘网格
     view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);    // 隐藏水平滚动条
     view->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);      // 隐藏垂直滚动条
     view->setDragMode(QGraphicsView::RubberBandDrag);    // 启用橡皮筋选择模式
@@ -59,15 +61,13 @@ void MainWindow::setupGraphicsView()
     toggleGridAction->setChecked(showGrid);
     connect(toggleGridAction, &QAction::triggered, this, [this](bool checked) {
         showGrid = checked;
+        view->resetCachedContent();  // 网格变化后丢弃背景缓存
         view->viewport()->update();  // 更新视图
     });
 
     // 自定义场景背景
     scene->setBackgroundBrush(Qt::white);  // 设置白色背景
     
-    // 重写视图的drawBackground函数来绘制网格
-    view->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
-    
     // 修改信号槽连接方式
     connect(view, SIGNAL(backgroundNeedsPaint(QPainter*, const QRectF&)),
             this, SLOT(drawBackground(QPainter*, const QRectF&)));
@@ -273,15 +273,29 @@ void MainWindow::saveToFile()
         fileName += ".json";
     }
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly)) {
+    QString errorString;
+    if (!saveScene(fileName, &errorString)) {
         QMessageBox::warning(this, tr("保存失败"),
                            tr("无法写入文件 %1:\n%2.")
                            .arg(fileName)
-                           .arg(file.errorString()));
+                           .arg(errorString));
         return;
     }
 
+    QMessageBox::information(this, tr("保存成功"),
+                           tr("场景已保存到文件：%1").arg(fileName));
+}
+
+bool MainWindow::saveScene(const QString &fileName, QString *errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+
     // 创建JSON文档
     QJsonObject sceneObject;
     QJsonArray itemsArray;
@@ -336,6 +350,9 @@ void MainWindow::saveToFile()
                 bindingObject["address"] = binding.address;
                 bindingObject["updateRate"] = binding.updateRate;
                 bindingObject["accessMode"] = binding.accessMode;
+                if (!binding.topic.isEmpty()) {
+                    bindingObject["topic"] = binding.topic;
+                }
                 itemObject["binding"] = bindingObject;
             }
         }
@@ -346,9 +363,7 @@ void MainWindow::saveToFile()
     sceneObject["items"] = itemsArray;
     QJsonDocument document(sceneObject);
     file.write(document.toJson(QJsonDocument::Indented));  // 使用缩进格式保存JSON
-
-    QMessageBox::information(this, tr("保存成功"),
-                           tr("场景已保存到文件：%1").arg(fileName));
+    return true;
 }
 
 void MainWindow::openFromFile()
@@ -360,23 +375,35 @@ void MainWindow::openFromFile()
     if (fileName.isEmpty())
         return;
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
+    QString errorString;
+    if (!loadScene(fileName, &errorString)) {
         QMessageBox::warning(this, tr("打开失败"),
                            tr("无法读取文件 %1:\n%2.")
                            .arg(fileName)
-                           .arg(file.errorString()));
-        return;
+                           .arg(errorString));
+    }
+}
+
+bool MainWindow::loadScene(const QString &fileName, QString *errorString)
+{
+    TRACE_SCOPE("MainWindow::loadScene");
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
     }
 
     // 解析JSON文档
     QJsonParseError jsonError;
     QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &jsonError);
     if (document.isNull()) {
-        QMessageBox::warning(this, tr("解析失败"),
-                           tr("解析JSON文件失败：%1")
-                           .arg(jsonError.errorString()));
-        return;
+        if (errorString) {
+            *errorString = tr("解析JSON文件失败：%1").arg(jsonError.errorString());
+        }
+        return false;
     }
 
     // 清除现有场景
@@ -411,6 +438,7 @@ void MainWindow::openFromFile()
         if (item) {
             item->setFlag(QGraphicsItem::ItemIsMovable);
             item->setFlag(QGraphicsItem::ItemIsSelectable);
+            item->setCacheMode(QGraphicsItem::DeviceCoordinateCache);  // 拖动时复用缓存
 
             // 恢复组件ID和变量绑定信息
             if (itemObject.contains("componentId")) {
@@ -426,11 +454,13 @@ void MainWindow::openFromFile()
                     binding.address = bindingObject["address"].toString();
                     binding.updateRate = bindingObject["updateRate"].toString();
                     binding.accessMode = bindingObject["accessMode"].toString();
+                    binding.topic = bindingObject["topic"].toString();
                     xmlConfig->addVariableBinding(componentId, binding);
                 }
             }
         }
     }
+    return true;
 }
 
 void MainWindow::loadXmlConfig()
@@ -449,7 +479,7 @@ void MainWindow::loadXmlConfig()
     }
 
     QList<VariableInfo> variables = xmlConfig->getAvailableVariables();
-    qDebug() << "Loaded" << variables.size() << "variables";
+    qCDebug(lcDesigner) << "Loaded" << variables.size() << "variables";
 
     if (variables.isEmpty()) {
         QMessageBox::warning(this, tr("配置为空"),
@@ -483,17 +513,17 @@ void MainWindow::editVariableBinding()
 
     // 获取现有绑定
     VariableBinding binding = xmlConfig->getVariableBinding(componentId);
-    qDebug() << "Current binding for component" << componentId << ":";
-    qDebug() << "Variable:" << binding.variableName;
-    qDebug() << "Type:" << binding.dataType;
-    qDebug() << "Address:" << binding.address;
+    qCDebug(lcDesigner) << "Current binding for component" << componentId << ":";
+    qCDebug(lcDesigner) << "Variable:" << binding.variableName;
+    qCDebug(lcDesigner) << "Type:" << binding.dataType;
+    qCDebug(lcDesigner) << "Address:" << binding.address;
 
     // 显示编辑对话框
     VariableBindingDialog dialog(this);
 
     // 设置可用变量（应该在设置绑定之前）
     QList<VariableInfo> variables = xmlConfig->getAvailableVariables();
-    qDebug() << "Available variables:" << variables.size();
+    qCDebug(lcDesigner) << "Available variables:" << variables.size();
     dialog.setAvailableVariables(variables);
 
     // 设置当前绑定
@@ -516,7 +546,7 @@ void MainWindow::editVariableBinding()
 //            QMessageBox::warning(this, tr("保存失败"),
 //                               tr("无法保存变量绑定到文件：%1").arg(fileName));
 //        } else {
-//            qDebug() << "Successfully saved binding for component:" << newComponentId;
+//            qCDebug(lcDesigner) << "Successfully saved binding for component:" << newComponentId;
 //        }
     }
 }
@@ -27,6 +27,12 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    //将场景写入JSON文件，失败时通过errorString返回原因
+    bool saveScene(const QString &fileName, QString *errorString = nullptr);
+
+    //从JSON文件重建场景，失败时通过errorString返回原因
+    bool loadScene(const QString &fileName, QString *errorString = nullptr);
+
 private slots:
     //处理组件库中项目的拖拽事件
     void handleDragItem(QTreeWidgetItem *item);
@@ -2,14 +2,32 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     scada \
-    runtime
+    runtime \
+    mqttload \
+    modbussim \
+    datagen \
+    framebench \
+    bench \
+    tests
 
 scada.file = scada/scada.pro
 runtime.file = runtime/runtime.pro
+mqttload.file = tools/mqttload/mqttload.pro
+modbussim.file = tools/modbussim/modbussim.pro
+datagen.file = tools/datagen/datagen.pro
+framebench.file = tools/framebench/framebench.pro
+bench.file = bench/bench.pro
+tests.file = tests/tests.pro
 
 # 确保子项目可以找到它们需要的头文件
 scada.depends =
 runtime.depends =
+mqttload.depends =
+modbussim.depends =
+datagen.depends =
+framebench.depends = mqttload
+bench.depends =
+tests.depends =
 
 # 设置公共的构建目录
 CONFIG += ordered 
\ No newline at end of file
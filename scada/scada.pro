@@ -40,7 +40,10 @@ SOURCES += \
     xmlconfig.cpp \
     variablebindingdialog.cpp \
     componentfactory.cpp \
-    componentdesigner.cpp
+    componentdesigner.cpp \
+    ../common/trace.cpp \
+    ../common/logcategories.cpp \
+    ../common/asynclogger.cpp
 
 HEADERS += \
     mainwindow.h \
@@ -48,7 +51,10 @@ HEADERS += \
     xmlconfig.h \
     variablebindingdialog.h \
     componentfactory.h \
-    componentdesigner.h
+    componentdesigner.h \
+    ../common/trace.h \
+    ../common/logcategories.h \
+    ../common/asynclogger.h
 
 FORMS += \
     mainwindow.ui
@@ -70,3 +76,6 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 INCLUDEPATH += $$PWD/../common
+
+# 定义SCADA_NO_TRACE可在编译期去掉所有性能跟踪点
+#DEFINES += SCADA_NO_TRACE
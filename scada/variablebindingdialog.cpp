@@ -4,7 +4,7 @@
 #include <QDialogButtonBox>
 #include <QVBoxLayout>
 #include <QGroupBox>
-#include <QDebug>
+#include "logcategories.h"
 
 VariableBindingDialog::VariableBindingDialog(QWidget *parent)
     : QDialog(parent)
@@ -43,6 +43,11 @@ void VariableBindingDialog::createUI()
     accessModeCombo = new QComboBox(this);
     formLayout->addRow(tr("访问模式:"), accessModeCombo);
 
+    // MQTT主题，可直接输入，为空时使用公共主题
+    topicCombo = new QComboBox(this);
+    topicCombo->setEditable(true);
+    formLayout->addRow(tr("主题:"), topicCombo);
+
     mainLayout->addLayout(formLayout);
 
     // 按钮
@@ -62,10 +67,10 @@ void VariableBindingDialog::setupConnections()
 
 void VariableBindingDialog::setBinding(const QString &componentId, const VariableBinding &binding)
 {
-    qDebug() << "Setting binding for component:" << componentId;
-    qDebug() << "Binding info:" << binding.variableName 
-             << binding.dataType << binding.address 
-             << binding.updateRate << binding.accessMode;
+    qCDebug(lcDesigner) << "Setting binding for component:" << componentId;
+    qCDebug(lcDesigner) << "Binding info:" << binding.variableName 
+                        << binding.dataType << binding.address 
+                        << binding.updateRate << binding.accessMode;
 
     m_componentId = componentId;
     componentIdEdit->setText(componentId);
@@ -73,7 +78,7 @@ void VariableBindingDialog::setBinding(const QString &componentId, const Variabl
     // 如果有现有绑定，先选择对应的变量
     if (!binding.variableName.isEmpty()) {
         int index = variableCombo->findText(binding.variableName);
-        qDebug() << "Found variable index:" << index << "for" << binding.variableName;
+        qCDebug(lcDesigner) << "Found variable index:" << index << "for" << binding.variableName;
         if (index >= 0) {
             // 暂时断开信号连接，避免触发 onVariableSelected
             disconnect(variableCombo, &QComboBox::currentTextChanged,
@@ -84,6 +89,7 @@ void VariableBindingDialog::setBinding(const QString &componentId, const Variabl
             addressCombo->setCurrentText(binding.address);
             updateRateCombo->setCurrentText(binding.updateRate);
             accessModeCombo->setCurrentText(binding.accessMode);
+            topicCombo->setCurrentText(binding.topic);
             
             // 重新连接信号
             connect(variableCombo, &QComboBox::currentTextChanged,
@@ -96,12 +102,13 @@ void VariableBindingDialog::setBinding(const QString &componentId, const Variabl
         if (addressCombo->count() > 0) addressCombo->setCurrentIndex(0);
         if (updateRateCombo->count() > 0) updateRateCombo->setCurrentIndex(0);
         if (accessModeCombo->count() > 0) accessModeCombo->setCurrentIndex(0);
+        topicCombo->setCurrentText(QString());
     }
 }
 
 void VariableBindingDialog::setAvailableVariables(const QList<VariableInfo> &variables)
 {
-    qDebug() << "Setting" << variables.size() << "variables";
+    qCDebug(lcDesigner) << "Setting" << variables.size() << "variables";
     m_variables = variables;
 
     // 保存当前选择的值
@@ -110,17 +117,18 @@ void VariableBindingDialog::setAvailableVariables(const QList<VariableInfo> &var
     QString currentAddress = addressCombo->currentText();
     QString currentUpdateRate = updateRateCombo->currentText();
     QString currentAccessMode = accessModeCombo->currentText();
+    QString currentTopic = topicCombo->currentText();
 
     // 填充变量下拉框
     variableCombo->clear();
     variableCombo->addItem(tr("请选择变量"));
     for (const VariableInfo &var : variables) {
-        qDebug() << "Adding variable:" << var.name;
+        qCDebug(lcDesigner) << "Adding variable:" << var.name;
         variableCombo->addItem(var.name);
     }
 
     // 收集所有唯一值
-    QStringList dataTypes, addresses, updateRates, accessModes;
+    QStringList dataTypes, addresses, updateRates, accessModes, topics;
     for (const VariableInfo &var : variables) {
         if (!dataTypes.contains(var.dataType))
             dataTypes << var.dataType;
@@ -130,6 +138,8 @@ void VariableBindingDialog::setAvailableVariables(const QList<VariableInfo> &var
             updateRates << var.updateRate;
         if (!accessModes.contains(var.accessMode))
             accessModes << var.accessMode;
+        if (!var.topic.isEmpty() && !topics.contains(var.topic))
+            topics << var.topic;
     }
 
     // 填充其他下拉框
@@ -145,6 +155,9 @@ void VariableBindingDialog::setAvailableVariables(const QList<VariableInfo> &var
     accessModeCombo->clear();
     accessModeCombo->addItems(accessModes);
 
+    topicCombo->clear();
+    topicCombo->addItems(topics);
+
     // 恢复之前的选择（如果存在）
     int varIndex = variableCombo->findText(currentVariable);
     if (varIndex >= 0) variableCombo->setCurrentIndex(varIndex);
@@ -153,18 +166,19 @@ void VariableBindingDialog::setAvailableVariables(const QList<VariableInfo> &var
     if (!currentAddress.isEmpty()) addressCombo->setCurrentText(currentAddress);
     if (!currentUpdateRate.isEmpty()) updateRateCombo->setCurrentText(currentUpdateRate);
     if (!currentAccessMode.isEmpty()) accessModeCombo->setCurrentText(currentAccessMode);
-
-    qDebug() << "Combo boxes filled:";
-    qDebug() << "Variables:" << variableCombo->count() - 1;  // 减去"请选择变量"
-    qDebug() << "Data types:" << dataTypes;
-    qDebug() << "Addresses:" << addresses;
-    qDebug() << "Update rates:" << updateRates;
-    qDebug() << "Access modes:" << accessModes;
+    topicCombo->setCurrentText(currentTopic);
+
+    qCDebug(lcDesigner) << "Combo boxes filled:";
+    qCDebug(lcDesigner) << "Variables:" << variableCombo->count() - 1;  // 减去"请选择变量"
+    qCDebug(lcDesigner) << "Data types:" << dataTypes;
+    qCDebug(lcDesigner) << "Addresses:" << addresses;
+    qCDebug(lcDesigner) << "Update rates:" << updateRates;
+    qCDebug(lcDesigner) << "Access modes:" << accessModes;
 }
 
 void VariableBindingDialog::onVariableSelected(const QString &variableName)
 {
-    qDebug() << "Variable selected:" << variableName;
+    qCDebug(lcDesigner) << "Variable selected:" << variableName;
     
     // 如果选择了"请选择变量"，清空其他字段
     if (variableName.isEmpty() || variableName == tr("请选择变量")) {
@@ -172,20 +186,22 @@ void VariableBindingDialog::onVariableSelected(const QString &variableName)
         addressCombo->setCurrentIndex(0);
         updateRateCombo->setCurrentIndex(0);
         accessModeCombo->setCurrentIndex(0);
+        topicCombo->setCurrentText(QString());
         return;
     }
 
     // 当选择变量时，自动填充其他字段
     for (const VariableInfo &var : m_variables) {
         if (var.name == variableName) {
-            qDebug() << "Found matching variable:" << var.name
-                     << "type:" << var.dataType
-                     << "address:" << var.address;
+            qCDebug(lcDesigner) << "Found matching variable:" << var.name
+                                << "type:" << var.dataType
+                                << "address:" << var.address;
             
             dataTypeCombo->setCurrentText(var.dataType);
             addressCombo->setCurrentText(var.address);
             updateRateCombo->setCurrentText(var.updateRate);
             accessModeCombo->setCurrentText(var.accessMode);
+            topicCombo->setCurrentText(var.topic);
             break;
         }
     }
@@ -203,6 +219,7 @@ void VariableBindingDialog::updateUIFromBinding(const VariableBinding &binding)
     addressCombo->setCurrentText(binding.address);
     updateRateCombo->setCurrentText(binding.updateRate);
     accessModeCombo->setCurrentText(binding.accessMode);
+    topicCombo->setCurrentText(binding.topic);
 }
 
 QString VariableBindingDialog::getComponentId() const
@@ -218,5 +235,6 @@ VariableBinding VariableBindingDialog::getBinding() const
     binding.address = addressCombo->currentText();
     binding.updateRate = updateRateCombo->currentText();
     binding.accessMode = accessModeCombo->currentText();
+    binding.topic = topicCombo->currentText().trimmed();
     return binding;
 }
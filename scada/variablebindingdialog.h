@@ -73,6 +73,7 @@ private:
     QComboBox *addressCombo;           // 地址下拉框
     QComboBox *updateRateCombo;        // 更新频率下拉框
     QComboBox *accessModeCombo;        // 访问模式下拉框
+    QComboBox *topicCombo;             // MQTT主题下拉框（可编辑）
 
     QString m_componentId;              // 当前组件ID
     QList<VariableInfo> m_variables;    // 可用变量列表
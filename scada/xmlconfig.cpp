@@ -1,7 +1,8 @@
 #include "xmlconfig.h"
 #include <QFile>
 #include <QStringList>
-#include <QDebug>
+#include "logcategories.h"
+#include "trace.h"
 
 XmlConfig::XmlConfig(QObject *parent) : QObject(parent)
 {
@@ -13,16 +14,18 @@ XmlConfig::~XmlConfig()
 
 bool XmlConfig::loadConfig(const QString &filename)
 {
+    TRACE_SCOPE("XmlConfig::loadConfig");
+
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "Cannot open file:" << filename;
+        qCWarning(lcConfig) << "Cannot open file:" << filename;
         return false;
     }
 
     QString errorMsg;
     int errorLine, errorColumn;
     if (!m_doc.setContent(&file, &errorMsg, &errorLine, &errorColumn)) {
-        qDebug() << "Parse XML failed:" << errorMsg << "at line" << errorLine;
+        qCWarning(lcConfig) << "Parse XML failed:" << errorMsg << "at line" << errorLine;
         file.close();
         return false;
     }
@@ -34,22 +37,22 @@ bool XmlConfig::loadConfig(const QString &filename)
 
     // 读取变量配置
     QDomElement root = m_doc.documentElement();
-    qDebug() << "Root element tag name:" << root.tagName();
+    qCDebug(lcConfig) << "Root element tag name:" << root.tagName();
 
     // 读取变量定义
     QDomElement varsElement = root.firstChildElement("variables");
     if (varsElement.isNull()) {
-        qDebug() << "No variables element found";
+        qCWarning(lcConfig) << "No variables element found";
         return false;
     }
 
     QDomNodeList variableNodes = varsElement.elementsByTagName("variable");
-    qDebug() << "Found" << variableNodes.count() << "variables";
+    qCDebug(lcConfig) << "Found" << variableNodes.count() << "variables";
     
     for (int i = 0; i < variableNodes.count(); i++) {
         QDomElement varElem = variableNodes.at(i).toElement();
         if (varElem.isNull()) {
-            qDebug() << "Variable element" << i << "is null";
+            qCDebug(lcConfig) << "Variable element" << i << "is null";
             continue;
         }
 
@@ -59,10 +62,11 @@ bool XmlConfig::loadConfig(const QString &filename)
         info.address = varElem.attribute("address");
         info.updateRate = varElem.attribute("updateRate");
         info.accessMode = varElem.attribute("accessMode");
+        info.topic = varElem.attribute("topic");
 
-        qDebug() << "Loading variable:" << info.name
-                 << "type:" << info.dataType
-                 << "address:" << info.address;
+        qCDebug(lcConfig) << "Loading variable:" << info.name
+                          << "type:" << info.dataType
+                          << "address:" << info.address;
         m_variables.append(info);
     }
 
@@ -70,18 +74,18 @@ bool XmlConfig::loadConfig(const QString &filename)
     QDomElement bindingsElement = root.firstChildElement("bindings");
     if (!bindingsElement.isNull()) {
         QDomNodeList bindingNodes = bindingsElement.elementsByTagName("binding");
-        qDebug() << "Found" << bindingNodes.count() << "bindings";
+        qCDebug(lcConfig) << "Found" << bindingNodes.count() << "bindings";
         
         for (int i = 0; i < bindingNodes.count(); i++) {
             QDomElement bindElem = bindingNodes.at(i).toElement();
             if (bindElem.isNull()) {
-                qDebug() << "Binding element" << i << "is null";
+                qCDebug(lcConfig) << "Binding element" << i << "is null";
                 continue;
             }
 
             QString componentId = bindElem.attribute("componentId");
             if (componentId.isEmpty()) {
-                qDebug() << "Empty component ID for binding" << i;
+                qCDebug(lcConfig) << "Empty component ID for binding" << i;
                 continue;
             }
 
@@ -91,15 +95,16 @@ bool XmlConfig::loadConfig(const QString &filename)
             binding.address = bindElem.attribute("address");
             binding.updateRate = bindElem.attribute("updateRate");
             binding.accessMode = bindElem.attribute("accessMode");
+            binding.topic = bindElem.attribute("topic");
 
-            qDebug() << "Loading binding for component:" << componentId
-                     << "variable:" << binding.variableName;
+            qCDebug(lcConfig) << "Loading binding for component:" << componentId
+                              << "variable:" << binding.variableName;
             m_bindings[componentId] = binding;
         }
     }
 
-    qDebug() << "Successfully loaded" << m_variables.size() << "variables and"
-             << m_bindings.size() << "bindings";
+    qCDebug(lcConfig) << "Successfully loaded" << m_variables.size() << "variables and"
+                      << m_bindings.size() << "bindings";
     return !m_variables.isEmpty();  // 只有成功读取到变量才返回true
 }
 
@@ -135,6 +140,9 @@ bool XmlConfig::saveConfig(const QString &filename) const
         varElem.setAttribute("address", var.address);
         varElem.setAttribute("updateRate", var.updateRate);
         varElem.setAttribute("accessMode", var.accessMode);
+        if (!var.topic.isEmpty()) {
+            varElem.setAttribute("topic", var.topic);
+        }
         varsElement.appendChild(varElem);
     }
 
@@ -150,12 +158,15 @@ bool XmlConfig::saveConfig(const QString &filename) const
         bindingElem.setAttribute("address", it.value().address);
         bindingElem.setAttribute("updateRate", it.value().updateRate);
         bindingElem.setAttribute("accessMode", it.value().accessMode);
+        if (!it.value().topic.isEmpty()) {
+            bindingElem.setAttribute("topic", it.value().topic);
+        }
         bindingsElement.appendChild(bindingElem);
     }
 
     QFile file(filename);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Cannot open file for writing:" << filename;
+        qCWarning(lcConfig) << "Cannot open file for writing:" << filename;
         return false;
     }
 
@@ -163,7 +174,7 @@ bool XmlConfig::saveConfig(const QString &filename) const
     stream << doc.toString(4);  // 使用4个空格缩进
     file.close();
 
-    qDebug() << "Saved" << m_variables.size() << "variables and" 
-             << m_bindings.size() << "bindings to" << filename;
+    qCDebug(lcConfig) << "Saved" << m_variables.size() << "variables and" 
+                      << m_bindings.size() << "bindings to" << filename;
     return true;
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ struct VariableInfo {
     QString address;        // 变量地址（如DB1.DBD0）
     QString updateRate;     // 更新频率（毫秒）
     QString accessMode;     // 访问模式（read/write/readwrite）
+    QString topic;          // MQTT主题（如site/area/device），为空时使用公共主题
 };
 
 /**
@@ -31,6 +32,7 @@ struct VariableBinding {
     QString address;         // 变量地址
     QString updateRate;      // 更新频率
     QString accessMode;      // 访问模式
+    QString topic;           // MQTT主题
 };
 
 /**
@@ -0,0 +1,290 @@
+#include "cborvaluedecodertest.h"
+#include <QtTest>
+#include <QCborStreamWriter>
+#include <cmath>
+#include <limits>
+#include "cborvaluedecoder.h"
+#include "recordingsink.h"
+
+namespace {
+// 定长编码的报文：一个非文本的未知键、数字时间戳和各种形式的数据点
+QByteArray definiteMessage()
+{
+    QByteArray payload;
+    QCborStreamWriter writer(&payload);
+    writer.startMap(3);
+    writer.append(QLatin1String("timestamp"));
+    writer.append(Q_UINT64_C(1700000000123));
+    writer.append(qint64(99));
+    writer.appendNull();
+    writer.append(QLatin1String("body"));
+    writer.startArray(8);
+
+    writer.startMap(2);
+    writer.append(QLatin1String("addr"));
+    writer.append(qint64(1));
+    writer.append(QLatin1String("val"));
+    writer.append(2.5);
+    writer.endMap();
+
+    // 键的顺序不限
+    writer.startMap(2);
+    writer.append(QLatin1String("val"));
+    writer.append(qint64(-7));
+    writer.append(QLatin1String("addr"));
+    writer.append(qint64(2));
+    writer.endMap();
+
+    writer.startMap(2);
+    writer.append(QLatin1String("addr"));
+    writer.append(qint64(3));
+    writer.append(QLatin1String("val"));
+    writer.append(true);
+    writer.endMap();
+
+    writer.startMap(2);
+    writer.append(QLatin1String("addr"));
+    writer.append(qint64(4));
+    writer.append(QLatin1String("val"));
+    writer.append(0.5f);
+    writer.endMap();
+
+    // [addr, val]形式
+    writer.startArray(2);
+    writer.append(qint64(5));
+    writer.append(1e300);
+    writer.endArray();
+
+    // 非数值的val取0，未知的键跳过
+    writer.startMap(3);
+    writer.append(QLatin1String("addr"));
+    writer.append(qint64(6));
+    writer.append(QLatin1String("val"));
+    writer.append(QLatin1String("text"));
+    writer.append(QLatin1String("unit"));
+    writer.append(QLatin1String("m"));
+    writer.endMap();
+
+    // 超出int64范围的无符号整数按double取值
+    writer.startMap(2);
+    writer.append(QLatin1String("addr"));
+    writer.append(qint64(7));
+    writer.append(QLatin1String("val"));
+    writer.append(std::numeric_limits<quint64>::max());
+    writer.endMap();
+
+    writer.startMap(2);
+    writer.append(QLatin1String("addr"));
+    writer.append(qint64(8));
+    writer.append(QLatin1String("val"));
+    writer.append(std::numeric_limits<qint64>::min());
+    writer.endMap();
+
+    writer.endArray();
+    writer.endMap();
+    return payload;
+}
+}
+
+void CborValueDecoderTest::roundTrip()
+{
+    QByteArray payload = definiteMessage();
+    QCOMPARE(int(ValueDecoder::sniff(payload)), int(ValueDecoder::Cbor));
+
+    CborValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(payload, &sink));
+    QVERIFY(!decoder.errorString());
+    QVERIFY(decoder.hasBody());
+    QCOMPARE(decoder.sampleCount(), 8);
+    QCOMPARE(sink.timestamp, QByteArray("1700000000123"));
+
+    QCOMPARE(sink.samples.size(), 8);
+    for (int i = 0; i < 8; ++i) {
+        QCOMPARE(sink.samples[i].addr, i + 1);
+    }
+    QCOMPARE(int(sink.samples[0].type), int(TagDouble));
+    QCOMPARE(sink.samples[0].value.d, 2.5);
+    QCOMPARE(int(sink.samples[1].type), int(TagInt));
+    QCOMPARE(sink.samples[1].value.i, Q_INT64_C(-7));
+    QCOMPARE(int(sink.samples[2].type), int(TagBool));
+    QCOMPARE(sink.samples[2].value.i, Q_INT64_C(1));
+    QCOMPARE(int(sink.samples[3].type), int(TagDouble));
+    QCOMPARE(sink.samples[3].value.d, 0.5);
+    QCOMPARE(int(sink.samples[4].type), int(TagDouble));
+    QCOMPARE(sink.samples[4].value.d, 1e300);
+    QCOMPARE(int(sink.samples[5].type), int(TagDouble));
+    QCOMPARE(sink.samples[5].value.d, 0.0);
+    QCOMPARE(int(sink.samples[6].type), int(TagDouble));
+    QCOMPARE(sink.samples[6].value.d, 18446744073709551615.0);
+    QCOMPARE(int(sink.samples[7].type), int(TagInt));
+    QCOMPARE(sink.samples[7].value.i, std::numeric_limits<qint64>::min());
+}
+
+void CborValueDecoderTest::indefiniteLength()
+{
+    // 自描述标签开头，映射和数组都不定长，时间戳为文本且在body之后
+    QByteArray payload;
+    QCborStreamWriter writer(&payload);
+    writer.append(QCborKnownTags::Signature);
+    writer.startMap();
+    writer.append(QLatin1String("body"));
+    writer.startArray();
+    writer.startMap();
+    writer.append(QLatin1String("addr"));
+    writer.append(qint64(1));
+    writer.append(QLatin1String("val"));
+    writer.append(1.5);
+    writer.endMap();
+    writer.startArray();
+    writer.append(qint64(2));
+    writer.append(false);
+    writer.append(QLatin1String("ignored"));
+    writer.endArray();
+    writer.endArray();
+    writer.append(QLatin1String("timestamp"));
+    writer.append(QLatin1String("1700000000000"));
+    writer.endMap();
+    QCOMPARE(int(ValueDecoder::sniff(payload)), int(ValueDecoder::Cbor));
+
+    CborValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(payload, &sink));
+    QVERIFY(decoder.hasBody());
+    QCOMPARE(decoder.sampleCount(), 2);
+    QCOMPARE(sink.timestamp, QByteArray("1700000000000"));
+    QCOMPARE(sink.samples.size(), 2);
+    QCOMPARE(sink.samples[0].addr, 1);
+    QCOMPARE(int(sink.samples[0].type), int(TagDouble));
+    QCOMPARE(sink.samples[0].value.d, 1.5);
+    QCOMPARE(sink.samples[1].addr, 2);
+    QCOMPARE(int(sink.samples[1].type), int(TagBool));
+    QCOMPARE(sink.samples[1].value.i, Q_INT64_C(0));
+}
+
+void CborValueDecoderTest::numbers_data()
+{
+    // value为数值数据项的十六进制编码
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<int>("type");
+    QTest::addColumn<qint64>("intValue");
+    QTest::addColumn<double>("doubleValue");
+
+    QTest::newRow("uint inline") << QByteArray("17") << int(TagInt) << Q_INT64_C(23) << 0.0;
+    QTest::newRow("uint 1 byte") << QByteArray("1818") << int(TagInt) << Q_INT64_C(24) << 0.0;
+    QTest::newRow("uint 8 bytes") << QByteArray("1b000000174876e800")
+                                  << int(TagInt) << Q_INT64_C(100000000000) << 0.0;
+    QTest::newRow("uint64 max") << QByteArray("1bffffffffffffffff")
+                                << int(TagDouble) << Q_INT64_C(0) << 18446744073709551615.0;
+    QTest::newRow("negative") << QByteArray("20") << int(TagInt) << Q_INT64_C(-1) << 0.0;
+    QTest::newRow("negative 2 bytes") << QByteArray("3901f3") << int(TagInt) << Q_INT64_C(-500) << 0.0;
+    QTest::newRow("int64 min") << QByteArray("3b7fffffffffffffff")
+                               << int(TagInt) << (-Q_INT64_C(9223372036854775807) - 1) << 0.0;
+    QTest::newRow("below int64") << QByteArray("3b8000000000000000")
+                                 << int(TagDouble) << Q_INT64_C(0) << -9223372036854775809.0;
+    QTest::newRow("half") << QByteArray("f93e00") << int(TagDouble) << Q_INT64_C(0) << 1.5;
+    QTest::newRow("half subnormal") << QByteArray("f90001")
+                                    << int(TagDouble) << Q_INT64_C(0) << 5.9604644775390625e-8;
+    QTest::newRow("half -infinity") << QByteArray("f9fc00") << int(TagDouble) << Q_INT64_C(0)
+                                    << -std::numeric_limits<double>::infinity();
+    QTest::newRow("single") << QByteArray("fa47c35000") << int(TagDouble) << Q_INT64_C(0) << 100000.0;
+    QTest::newRow("double") << QByteArray("fb3ff199999999999a") << int(TagDouble) << Q_INT64_C(0) << 1.1;
+    QTest::newRow("false") << QByteArray("f4") << int(TagBool) << Q_INT64_C(0) << 0.0;
+    QTest::newRow("true") << QByteArray("f5") << int(TagBool) << Q_INT64_C(1) << 0.0;
+    QTest::newRow("tagged") << QByteArray("c1f93e00") << int(TagDouble) << Q_INT64_C(0) << 1.5;
+    // 不是数值时取0
+    QTest::newRow("null") << QByteArray("f6") << int(TagDouble) << Q_INT64_C(0) << 0.0;
+    QTest::newRow("text") << QByteArray("6161") << int(TagDouble) << Q_INT64_C(0) << 0.0;
+}
+
+void CborValueDecoderTest::numbers()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(int, type);
+    QFETCH(qint64, intValue);
+    QFETCH(double, doubleValue);
+
+    // {"body": [[1, value]]}
+    CborValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(QByteArray::fromHex("a164626f6479818201" + value), &sink));
+    QCOMPARE(sink.samples.size(), 1);
+    QCOMPARE(sink.samples[0].addr, 1);
+    QCOMPARE(int(sink.samples[0].type), type);
+    if (type == TagDouble) {
+        QCOMPARE(sink.samples[0].value.d, doubleValue);
+    } else {
+        QCOMPARE(sink.samples[0].value.i, intValue);
+    }
+}
+
+void CborValueDecoderTest::truncated()
+{
+    // 定长编码的报文截断在任何位置都必须报错，且出错位置不越过数据末尾
+    QByteArray payload = definiteMessage();
+    CborValueDecoder decoder;
+    for (int size = 0; size < payload.size(); ++size) {
+        RecordingSink sink;
+        QVERIFY2(!decoder.decode(payload.left(size), &sink), QByteArray::number(size).constData());
+        QVERIFY(decoder.errorString());
+        QVERIFY(decoder.errorOffset() >= 0 && decoder.errorOffset() <= size);
+    }
+}
+
+void CborValueDecoderTest::malformed_data()
+{
+    // payload为十六进制编码，"a164626f6479"是 {"body": ...
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<QByteArray>("error");
+    QTest::addColumn<int>("offset");
+
+    QTest::newRow("empty") << QByteArray() << QByteArray("unexpected end of data") << 0;
+    QTest::newRow("not a map") << QByteArray("8101") << QByteArray("document is not a map") << 1;
+    QTest::newRow("garbage") << QByteArray("a000") << QByteArray("garbage at the end of the document") << 1;
+    QTest::newRow("truncated key") << QByteArray("a164626f64")
+                                   << QByteArray("unexpected end of data") << 2;
+    QTest::newRow("truncated count") << QByteArray("a164626f64799a0000")
+                                     << QByteArray("unexpected end of data") << 7;
+    QTest::newRow("truncated double") << QByteArray("a164626f6479818201fb3ff0")
+                                      << QByteArray("unexpected end of data") << 10;
+    QTest::newRow("missing entry") << QByteArray("a164626f6479828201f5")
+                                   << QByteArray("unexpected end of data") << 10;
+    // 长度远大于实际数据时逐项读到末尾报错，不按长度预先分配
+    QTest::newRow("over-long array") << QByteArray("a164626f64799bffffffffffffffff8201f5")
+                                     << QByteArray("unexpected end of data") << 18;
+    QTest::newRow("over-long map") << QByteArray("bbffffffffffffffff6161f5")
+                                   << QByteArray("unexpected end of data") << 12;
+    QTest::newRow("over-long text") << QByteArray("a17bffffffffffffffff61")
+                                    << QByteArray("unexpected end of data") << 10;
+    QTest::newRow("missing break") << QByteArray("bf64626f64799f")
+                                   << QByteArray("unexpected end of data") << 7;
+    QTest::newRow("indefinite integer") << QByteArray("a164626f647981821f")
+                                        << QByteArray("illegal indefinite length") << 8;
+    QTest::newRow("reserved info") << QByteArray("a164626f647981821c")
+                                   << QByteArray("illegal additional information") << 8;
+    QTest::newRow("unexpected break") << QByteArray("a164626f6479818201ff")
+                                      << QByteArray("unexpected break") << 9;
+    QTest::newRow("indefinite key") << QByteArray("bf7f6162ff00ff")
+                                    << QByteArray("expected a definite-length text string") << 2;
+    // 不定长文本中混入字节串分块
+    QTest::newRow("bad string chunk") << QByteArray("a261617f4162ff64626f647980")
+                                      << QByteArray("illegal string chunk") << 5;
+}
+
+void CborValueDecoderTest::malformed()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(QByteArray, error);
+    QFETCH(int, offset);
+
+    CborValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(!decoder.decode(QByteArray::fromHex(payload), &sink));
+    QVERIFY(decoder.errorString());
+    QCOMPARE(QByteArray(decoder.errorString()), error);
+    QCOMPARE(decoder.errorOffset(), offset);
+
+    // 之后的正常报文不受影响
+    QVERIFY(decoder.decode(QByteArray::fromHex("a164626f647980"), &sink));
+    QVERIFY(!decoder.errorString());
+}
@@ -0,0 +1,24 @@
+#ifndef CBORVALUEDECODERTEST_H
+#define CBORVALUEDECODERTEST_H
+
+#include <QObject>
+
+/**
+ * @brief CborValueDecoder的行为测试
+ * 用QCborStreamWriter编码的报文做往返比对，并覆盖各种宽度的数值、截断和格式错误的报文
+ */
+class CborValueDecoderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void indefiniteLength();
+    void numbers_data();
+    void numbers();
+    void truncated();
+    void malformed_data();
+    void malformed();
+};
+
+#endif // CBORVALUEDECODERTEST_H
@@ -0,0 +1,285 @@
+#include "jsonvaluedecodertest.h"
+#include <QtTest>
+#include <cmath>
+#include "jsonvaluedecoder.h"
+#include "recordingsink.h"
+
+namespace {
+// 只有一个数据点的报文，val为给定的数值文本
+QByteArray sampleMessage(const QByteArray &value)
+{
+    return "{\"body\":[{\"addr\":1,\"val\":" + value + "}]}";
+}
+}
+
+void JsonValueDecoderTest::decodeMessage()
+{
+    QByteArray payload = R"({"timestamp":"1700000000123","body":[)"
+                         R"({"addr":1,"val":2.5},{"val":7,"addr":2},{"addr":3,"val":true},)"
+                         R"({"addr":4,"val":"text","unit":"m"}]})";
+    JsonValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(payload, &sink));
+    QVERIFY(!decoder.errorString());
+    QVERIFY(decoder.hasBody());
+    QCOMPARE(decoder.sampleCount(), 4);
+    QCOMPARE(sink.timestamp, QByteArray("1700000000123"));
+
+    QCOMPARE(sink.samples.size(), 4);
+    QCOMPARE(sink.samples[0].addr, 1);
+    QCOMPARE(int(sink.samples[0].type), int(TagDouble));
+    QCOMPARE(sink.samples[0].value.d, 2.5);
+    QCOMPARE(sink.samples[1].addr, 2);
+    QCOMPARE(int(sink.samples[1].type), int(TagInt));
+    QCOMPARE(sink.samples[1].value.i, Q_INT64_C(7));
+    QCOMPARE(sink.samples[2].addr, 3);
+    QCOMPARE(int(sink.samples[2].type), int(TagBool));
+    QCOMPARE(sink.samples[2].value.i, Q_INT64_C(1));
+    // 非数值的val与QJsonValue::toDouble()一致取0
+    QCOMPARE(sink.samples[3].addr, 4);
+    QCOMPARE(int(sink.samples[3].type), int(TagDouble));
+    QCOMPARE(sink.samples[3].value.d, 0.0);
+
+    // 未知字段跳过，空的body也算有body
+    sink = RecordingSink();
+    QVERIFY(decoder.decode(R"( { "extra" : [1, {"a":null}], "body" : [ ] } )", &sink));
+    QVERIFY(decoder.hasBody());
+    QCOMPARE(decoder.sampleCount(), 0);
+    QVERIFY(!sink.hasTimestamp);
+}
+
+void JsonValueDecoderTest::numbers_data()
+{
+    QTest::addColumn<QByteArray>("text");
+    QTest::addColumn<int>("type");
+    QTest::addColumn<qint64>("intValue");
+    QTest::addColumn<double>("doubleValue");
+
+    QTest::newRow("zero") << QByteArray("0") << int(TagInt) << Q_INT64_C(0) << 0.0;
+    QTest::newRow("integer") << QByteArray("42") << int(TagInt) << Q_INT64_C(42) << 0.0;
+    QTest::newRow("negative") << QByteArray("-17") << int(TagInt) << Q_INT64_C(-17) << 0.0;
+    QTest::newRow("int64 max") << QByteArray("9223372036854775807")
+                               << int(TagInt) << Q_INT64_C(9223372036854775807) << 0.0;
+    QTest::newRow("int64 min") << QByteArray("-9223372036854775808")
+                               << int(TagInt) << (-Q_INT64_C(9223372036854775807) - 1) << 0.0;
+    // 超出64位整数范围的整数按double取值
+    QTest::newRow("int64 overflow") << QByteArray("9223372036854775808")
+                                    << int(TagDouble) << Q_INT64_C(0) << 9223372036854775808.0;
+    QTest::newRow("int64 underflow") << QByteArray("-9223372036854775809")
+                                     << int(TagDouble) << Q_INT64_C(0) << -9223372036854775809.0;
+    QTest::newRow("20 digits") << QByteArray("12345678901234567890")
+                               << int(TagDouble) << Q_INT64_C(0) << 12345678901234567890.0;
+    QTest::newRow("uint64 overflow") << QByteArray("18446744073709551616")
+                                     << int(TagDouble) << Q_INT64_C(0) << 18446744073709551616.0;
+    QTest::newRow("fraction") << QByteArray("2.5") << int(TagDouble) << Q_INT64_C(0) << 2.5;
+    QTest::newRow("integral fraction") << QByteArray("1.0") << int(TagDouble) << Q_INT64_C(0) << 1.0;
+    QTest::newRow("tenth") << QByteArray("0.1") << int(TagDouble) << Q_INT64_C(0) << 0.1;
+    QTest::newRow("negative fraction") << QByteArray("-12.75") << int(TagDouble) << Q_INT64_C(0) << -12.75;
+    QTest::newRow("small") << QByteArray("0.000001") << int(TagDouble) << Q_INT64_C(0) << 1e-6;
+    QTest::newRow("long mantissa") << QByteArray("3.14159265358979323846")
+                                   << int(TagDouble) << Q_INT64_C(0) << 3.14159265358979323846;
+    // 有指数部分的数值即使是整数也按double取值
+    QTest::newRow("exponent") << QByteArray("1e3") << int(TagDouble) << Q_INT64_C(0) << 1000.0;
+    QTest::newRow("exponent sign") << QByteArray("1E+2") << int(TagDouble) << Q_INT64_C(0) << 100.0;
+    QTest::newRow("negative exponent") << QByteArray("25e-1") << int(TagDouble) << Q_INT64_C(0) << 2.5;
+    QTest::newRow("fraction exponent") << QByteArray("-1.5e-3") << int(TagDouble) << Q_INT64_C(0) << -1.5e-3;
+    QTest::newRow("large exponent") << QByteArray("1.5e308") << int(TagDouble) << Q_INT64_C(0) << 1.5e308;
+    QTest::newRow("small exponent") << QByteArray("2.5e-300") << int(TagDouble) << Q_INT64_C(0) << 2.5e-300;
+}
+
+void JsonValueDecoderTest::numbers()
+{
+    QFETCH(QByteArray, text);
+    QFETCH(int, type);
+    QFETCH(qint64, intValue);
+    QFETCH(double, doubleValue);
+
+    JsonValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(sampleMessage(text), &sink));
+    QCOMPARE(sink.samples.size(), 1);
+    QCOMPARE(int(sink.samples[0].type), type);
+    if (type == TagDouble) {
+        QCOMPARE(sink.samples[0].value.d, doubleValue);
+    } else {
+        QCOMPARE(sink.samples[0].value.i, intValue);
+    }
+}
+
+void JsonValueDecoderTest::negativeZero()
+{
+    JsonValueDecoder decoder;
+
+    // 负零按double保留符号，显示为"-0"而不是"0"
+    const char *texts[] = { "-0", "-0.0", "-0e3" };
+    for (const char *text : texts) {
+        RecordingSink sink;
+        QVERIFY(decoder.decode(sampleMessage(text), &sink));
+        QCOMPARE(sink.samples.size(), 1);
+        QCOMPARE(int(sink.samples[0].type), int(TagDouble));
+        QCOMPARE(sink.samples[0].value.d, 0.0);
+        QVERIFY2(std::signbit(sink.samples[0].value.d), text);
+    }
+
+    RecordingSink sink;
+    QVERIFY(decoder.decode(sampleMessage("0"), &sink));
+    QCOMPARE(int(sink.samples[0].type), int(TagInt));
+    QCOMPARE(sink.samples[0].value.i, Q_INT64_C(0));
+
+    // 地址为-0时取0
+    sink = RecordingSink();
+    QVERIFY(decoder.decode(R"({"body":[{"addr":-0,"val":1}]})", &sink));
+    QCOMPARE(sink.samples[0].addr, 0);
+}
+
+void JsonValueDecoderTest::invalidNumbers_data()
+{
+    QTest::addColumn<QByteArray>("text");
+
+    QTest::newRow("lone minus") << QByteArray("-");
+    QTest::newRow("double minus") << QByteArray("--1");
+    QTest::newRow("plus") << QByteArray("+1");
+    QTest::newRow("leading point") << QByteArray(".5");
+    QTest::newRow("trailing point") << QByteArray("1.");
+    QTest::newRow("point exponent") << QByteArray("1.e5");
+    QTest::newRow("empty exponent") << QByteArray("1e");
+    QTest::newRow("signed empty exponent") << QByteArray("1e+");
+    QTest::newRow("leading zero") << QByteArray("01");
+    QTest::newRow("hex") << QByteArray("0x10");
+    QTest::newRow("two points") << QByteArray("1.5.2");
+    QTest::newRow("nan") << QByteArray("NaN");
+    QTest::newRow("infinity") << QByteArray("-Infinity");
+}
+
+void JsonValueDecoderTest::invalidNumbers()
+{
+    QFETCH(QByteArray, text);
+
+    QByteArray payload = sampleMessage(text);
+    JsonValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(!decoder.decode(payload, &sink));
+    QVERIFY(decoder.errorString());
+    QVERIFY(decoder.errorOffset() >= 0 && decoder.errorOffset() <= payload.size());
+    QVERIFY(sink.samples.isEmpty());
+}
+
+void JsonValueDecoderTest::truncated()
+{
+    QByteArray payload = R"({"timestamp":"17\"00","meta":{"unit":["m",null,false]},"body":[)"
+                         R"({"addr":1,"val":-1.5e-3},{"addr":2,"val":true},{"addr":3,"val":123}]})";
+    JsonValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(payload, &sink));
+    QCOMPARE(sink.samples.size(), 3);
+
+    // 任意位置截断都报错，且不读出报文之外的数据
+    for (int size = 0; size < payload.size(); ++size) {
+        QByteArray prefix = payload.left(size);
+        RecordingSink partial;
+        QVERIFY2(!decoder.decode(prefix, &partial), prefix.constData());
+        QVERIFY2(decoder.errorString(), prefix.constData());
+        QVERIFY(decoder.errorOffset() >= 0 && decoder.errorOffset() <= size);
+    }
+
+    QVERIFY(!decoder.decode(R"({"timestamp":"12)", &sink));
+    QCOMPARE(QByteArray(decoder.errorString()), QByteArray("unterminated string"));
+    QVERIFY(!decoder.decode(R"({"body":[{"addr":1,"val":2})", &sink));
+    QCOMPARE(QByteArray(decoder.errorString()), QByteArray("unterminated array"));
+    QVERIFY(!decoder.decode(R"({"body":[{"addr":1)", &sink));
+    QCOMPARE(QByteArray(decoder.errorString()), QByteArray("unterminated object"));
+    QVERIFY(!decoder.decode(R"({"body":[{"addr":)", &sink));
+    QCOMPARE(QByteArray(decoder.errorString()), QByteArray("unexpected end of document"));
+}
+
+void JsonValueDecoderTest::escapedKeys()
+{
+    // 键名中的转义序列还原后再匹配
+    QByteArray payload = R"({"tim\u0065stamp":"77","b\u006fdy":[)"
+                         R"({"ad\u0064r":5,"v\u0061l":1.5},)"
+                         R"({"\u0061\u0064\u0064\u0072":6,"val\/":9,"va\u006C":2}]})";
+    JsonValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(payload, &sink));
+    QCOMPARE(sink.timestamp, QByteArray("77"));
+    QCOMPARE(sink.samples.size(), 2);
+    QCOMPARE(sink.samples[0].addr, 5);
+    QCOMPARE(sink.samples[0].value.d, 1.5);
+    QCOMPARE(sink.samples[1].addr, 6);
+    QCOMPARE(int(sink.samples[1].type), int(TagInt));
+    QCOMPARE(sink.samples[1].value.i, Q_INT64_C(2));
+
+    // 还原后不相等的键名不匹配：多出的字符、转义的引号、非ASCII字符和非法转义
+    const char *others[] = {
+        R"({"body":[{"addr\u0000":7,"val":1}]})",
+        R"({"body":[{"a\"ddr":7,"val":1}]})",
+        R"({"body":[{"\u00e4ddr":7,"val":1}]})",
+        R"({"body":[{"\addr":7,"val":1}]})",
+        R"({"body":[{"add\u72":7,"val":1}]})"
+    };
+    for (const char *other : others) {
+        sink = RecordingSink();
+        QVERIFY2(decoder.decode(other, &sink), other);
+        QCOMPARE(sink.samples.size(), 1);
+        QCOMPARE(sink.samples[0].addr, 0);
+    }
+}
+
+void JsonValueDecoderTest::escapedStrings()
+{
+    // 字符串中转义的引号和括号不结束字符串，时间戳中的转义序列原样传出
+    QByteArray payload = R"({"note":"a\\\"}]","timestamp":"12\"3","body":[{"addr":1,"val":"\"}]"}]})";
+    JsonValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(payload, &sink));
+    QCOMPARE(sink.timestamp, QByteArray(R"(12\"3)"));
+    QCOMPARE(sink.samples.size(), 1);
+    QCOMPARE(sink.samples[0].addr, 1);
+
+    // 字符串中未转义的控制字符
+    QVERIFY(!decoder.decode("{\"note\":\"a\tb\",\"body\":[]}", &sink));
+    QCOMPARE(QByteArray(decoder.errorString()), QByteArray("control character in string"));
+}
+
+void JsonValueDecoderTest::structureErrors_data()
+{
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<QByteArray>("error");
+
+    QTest::newRow("empty") << QByteArray("") << QByteArray("document is not an object");
+    QTest::newRow("array") << QByteArray("[]") << QByteArray("document is not an object");
+    QTest::newRow("trailing text") << QByteArray(R"({"body":[]} x)")
+                                   << QByteArray("garbage at the end of the document");
+    QTest::newRow("two documents") << QByteArray(R"({"body":[]}{})")
+                                   << QByteArray("garbage at the end of the document");
+    QTest::newRow("missing colon") << QByteArray(R"({"body" []})") << QByteArray("missing name separator");
+    QTest::newRow("missing comma") << QByteArray(R"({"body":[{"addr":1 "val":2}]})")
+                                   << QByteArray("missing value separator");
+    QTest::newRow("bad literal") << QByteArray(R"({"body":[tru]})") << QByteArray("illegal value");
+    QTest::newRow("unquoted key") << QByteArray(R"({body:[]})") << QByteArray("expected string");
+}
+
+void JsonValueDecoderTest::structureErrors()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(QByteArray, error);
+
+    JsonValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(!decoder.decode(payload, &sink));
+    QCOMPARE(QByteArray(decoder.errorString()), error);
+}
+
+void JsonValueDecoderTest::nestingLimit()
+{
+    JsonValueDecoder decoder;
+    RecordingSink sink;
+
+    QByteArray shallow = "{\"x\":" + QByteArray(60, '[') + QByteArray(60, ']') + ",\"body\":[]}";
+    QVERIFY(decoder.decode(shallow, &sink));
+
+    // 超过嵌套上限的未知字段报错，不会递归过深
+    QByteArray deep = "{\"x\":" + QByteArray(100, '[') + QByteArray(100, ']') + ",\"body\":[]}";
+    QVERIFY(!decoder.decode(deep, &sink));
+    QCOMPARE(QByteArray(decoder.errorString()), QByteArray("too deeply nested document"));
+}
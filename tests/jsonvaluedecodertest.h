@@ -0,0 +1,29 @@
+#ifndef JSONVALUEDECODERTEST_H
+#define JSONVALUEDECODERTEST_H
+
+#include <QObject>
+
+/**
+ * @brief JsonValueDecoder的行为测试
+ * 覆盖数值的边界（64位整数溢出、指数、-0）、截断的报文和带转义的键名
+ */
+class JsonValueDecoderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodeMessage();
+    void numbers_data();
+    void numbers();
+    void negativeZero();
+    void invalidNumbers_data();
+    void invalidNumbers();
+    void truncated();
+    void escapedKeys();
+    void escapedStrings();
+    void structureErrors_data();
+    void structureErrors();
+    void nestingLimit();
+};
+
+#endif // JSONVALUEDECODERTEST_H
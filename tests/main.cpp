@@ -0,0 +1,34 @@
+#include <QCoreApplication>
+#include <QtTest>
+#include "jsonvaluedecodertest.h"
+#include "cborvaluedecodertest.h"
+#include "packedvaluedecodertest.h"
+#include "sparkplugtest.h"
+#include "tagroutingtest.h"
+#include "topictrietest.h"
+#include "subscriptionmanagertest.h"
+#include "modbussourcetest.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    JsonValueDecoderTest jsonValueDecoderTest;
+    CborValueDecoderTest cborValueDecoderTest;
+    PackedValueDecoderTest packedValueDecoderTest;
+    SparkplugTest sparkplugTest;
+    TagRoutingTest tagRoutingTest;
+    TopicTrieTest topicTrieTest;
+    SubscriptionManagerTest subscriptionManagerTest;
+    ModbusSourceTest modbusSourceTest;
+    QList<QObject *> tests = { &jsonValueDecoderTest, &cborValueDecoderTest,
+                               &packedValueDecoderTest, &sparkplugTest, &tagRoutingTest,
+                               &topicTrieTest, &subscriptionManagerTest, &modbusSourceTest };
+
+    // 依次运行各测试类，返回失败的用例总数
+    int failures = 0;
+    for (QObject *test : tests) {
+        failures += QTest::qExec(test, a.arguments());
+    }
+    return failures;
+}
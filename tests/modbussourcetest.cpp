@@ -0,0 +1,206 @@
+#include "modbussourcetest.h"
+#include <QtTest>
+#include "modbussource.h"
+
+namespace {
+
+// 变量写作"从站/地址"，例如"2/40001:float64"
+ModbusPoint makePoint(const QString &spec, int tag)
+{
+    int slash = spec.indexOf(QLatin1Char('/'));
+    ModbusPoint point;
+    point.tag = tag;
+    point.unit = quint8(spec.left(slash).toInt());
+    if (!ModbusSource::parseAddress(spec.mid(slash + 1), TagInt, &point)) {
+        qWarning() << "Bad point in test data:" << spec;
+    }
+    return point;
+}
+
+// 块写作"从站/功能码/起始寄存器/寄存器个数/变量个数"
+QString describe(const ModbusBlock &block)
+{
+    return QString("%1/%2/%3/%4/%5").arg(block.unit).arg(block.function)
+            .arg(block.start).arg(block.count).arg(block.pointCount);
+}
+
+}
+
+void ModbusSourceTest::parseUrl_data()
+{
+    QTest::addColumn<QString>("url");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QString>("host");
+    QTest::addColumn<int>("port");
+    QTest::addColumn<int>("unit");
+
+    QTest::newRow("defaults") << "modbus://plc" << true << "plc" << 502 << 1;
+    QTest::newRow("root path") << "modbus://plc/" << true << "plc" << 502 << 1;
+    QTest::newRow("port and unit") << "modbus://10.0.0.5:1502/3" << true << "10.0.0.5" << 1502 << 3;
+    QTest::newRow("ipv6") << "modbus://[::1]:5020/7" << true << "::1" << 5020 << 7;
+    QTest::newRow("unit 0") << "modbus://plc/0" << true << "plc" << 502 << 0;
+    QTest::newRow("unit 255") << "modbus://plc/255" << true << "plc" << 502 << 255;
+    QTest::newRow("unit 256") << "modbus://plc/256" << false << QString() << 0 << 0;
+    QTest::newRow("unit not a number") << "modbus://plc/x" << false << QString() << 0 << 0;
+    QTest::newRow("nested path") << "modbus://plc/1/2" << false << QString() << 0 << 0;
+    QTest::newRow("port 0") << "modbus://plc:0" << false << QString() << 0 << 0;
+    QTest::newRow("port too large") << "modbus://plc:70000" << false << QString() << 0 << 0;
+    QTest::newRow("no host") << "modbus:///1" << false << QString() << 0 << 0;
+    QTest::newRow("wrong scheme") << "tcp://plc:502" << false << QString() << 0 << 0;
+}
+
+void ModbusSourceTest::parseUrl()
+{
+    QFETCH(QString, url);
+    QFETCH(bool, valid);
+    QFETCH(QString, host);
+    QFETCH(int, port);
+    QFETCH(int, unit);
+
+    QString parsedHost;
+    quint16 parsedPort = 0;
+    quint8 parsedUnit = 0;
+    QCOMPARE(ModbusSource::parseUrl(url, &parsedHost, &parsedPort, &parsedUnit), valid);
+    if (valid) {
+        QCOMPARE(parsedHost, host);
+        QCOMPARE(int(parsedPort), port);
+        QCOMPARE(int(parsedUnit), unit);
+    }
+}
+
+void ModbusSourceTest::parseAddress_data()
+{
+    QTest::addColumn<QString>("address");
+    QTest::addColumn<int>("type");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("function");
+    QTest::addColumn<int>("offset");
+    QTest::addColumn<int>("format");
+
+    // 未指定格式时按变量类型取默认格式
+    QTest::newRow("holding double") << "40001" << int(TagDouble) << true << 3 << 0 << int(ModbusPoint::Float32);
+    QTest::newRow("holding int") << "40001" << int(TagInt) << true << 3 << 0 << int(ModbusPoint::Int16);
+    QTest::newRow("holding bool") << "49999" << int(TagBool) << true << 3 << 9998 << int(ModbusPoint::Int16);
+    QTest::newRow("input") << "30010:int32" << int(TagDouble) << true << 4 << 9 << int(ModbusPoint::Int32);
+    QTest::newRow("format case") << "30001:FLOAT" << int(TagInt) << true << 4 << 0 << int(ModbusPoint::Float32);
+    QTest::newRow("double alias") << "40100:double" << int(TagInt) << true << 3 << 99 << int(ModbusPoint::Float64);
+
+    // 6位地址覆盖整个地址空间，多寄存器的值不能越过末尾
+    QTest::newRow("6 digits first") << "400001" << int(TagInt) << true << 3 << 0 << int(ModbusPoint::Int16);
+    QTest::newRow("6 digits last") << "365536:uint16" << int(TagInt) << true << 4 << 65535 << int(ModbusPoint::UInt16);
+    QTest::newRow("float64 at end") << "465533:float64" << int(TagInt) << true << 3 << 65532 << int(ModbusPoint::Float64);
+    QTest::newRow("float64 past end") << "465534:float64" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("int32 past end") << "465536:int32" << int(TagInt) << false << 0 << 0 << 0;
+
+    // 无效的5位和6位地址
+    QTest::newRow("5 digits zero") << "40000" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("5 digits coil") << "00001" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("5 digits discrete") << "10001" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("5 digits unknown") << "50001" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("5 digits sign") << "4+001" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("5 digits letter") << "4000a" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("6 digits zero") << "400000" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("6 digits too large") << "465537" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("6 digits unknown") << "565536" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("6 digits space") << "4 0001" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("4 digits") << "4001" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("7 digits") << "4000001" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("unknown format") << "40001:int8" << int(TagInt) << false << 0 << 0 << 0;
+    QTest::newRow("empty format") << "40001:" << int(TagInt) << false << 0 << 0 << 0;
+}
+
+void ModbusSourceTest::parseAddress()
+{
+    QFETCH(QString, address);
+    QFETCH(int, type);
+    QFETCH(bool, valid);
+    QFETCH(int, function);
+    QFETCH(int, offset);
+    QFETCH(int, format);
+
+    ModbusPoint point;
+    QCOMPARE(ModbusSource::parseAddress(address, TagType(type), &point), valid);
+    if (valid) {
+        QCOMPARE(int(point.function), function);
+        QCOMPARE(int(point.offset), offset);
+        QCOMPARE(int(point.format), format);
+    }
+}
+
+void ModbusSourceTest::planBlocks_data()
+{
+    QTest::addColumn<QStringList>("points");
+    QTest::addColumn<int>("maxGap");
+    QTest::addColumn<QStringList>("blocks");
+
+    // maxGap为0时只合并相邻寄存器，大于0时可以跨过空隙
+    QTest::newRow("adjacent") << QStringList({ "1/40001", "1/40002", "1/40003:int32" }) << 0
+                              << QStringList({ "1/3/0/4/3" });
+    QTest::newRow("gap not merged") << QStringList({ "1/40001", "1/40003" }) << 0
+                                    << QStringList({ "1/3/0/1/1", "1/3/2/1/1" });
+    QTest::newRow("gap merged") << QStringList({ "1/40001", "1/40003" }) << 1
+                                << QStringList({ "1/3/0/3/2" });
+    QTest::newRow("gap too wide") << QStringList({ "1/40001", "1/40004" }) << 1
+                                  << QStringList({ "1/3/0/1/1", "1/3/3/1/1" });
+    QTest::newRow("unsorted") << QStringList({ "1/40010", "1/40001", "1/40005" }) << 8
+                              << QStringList({ "1/3/0/10/3" });
+    QTest::newRow("overlapping") << QStringList({ "1/40001:float64", "1/40002" }) << 0
+                                 << QStringList({ "1/3/0/4/2" });
+
+    // 一块最多125个寄存器：起止相距124个寄存器时合并，125和126个时分开
+    QTest::newRow("124 apart") << QStringList({ "1/40001", "1/40125" }) << 125
+                               << QStringList({ "1/3/0/125/2" });
+    QTest::newRow("125 apart") << QStringList({ "1/40001", "1/40126" }) << 125
+                               << QStringList({ "1/3/0/1/1", "1/3/125/1/1" });
+    QTest::newRow("126 apart") << QStringList({ "1/40001", "1/40127" }) << 125
+                               << QStringList({ "1/3/0/1/1", "1/3/126/1/1" });
+
+    // float64占4个寄存器：正好填满块时合并，多出一个寄存器时另起一块
+    QTest::newRow("float64 fills block") << QStringList({ "1/40001", "1/40122:float64" }) << 125
+                                         << QStringList({ "1/3/0/125/2" });
+    QTest::newRow("float64 over edge") << QStringList({ "1/40001", "1/40123:float64" }) << 125
+                                       << QStringList({ "1/3/0/1/1", "1/3/122/4/1" });
+
+    // 不同功能码和从站各自成块，块按从站、功能码排列
+    QTest::newRow("mixed functions") << QStringList({ "1/40002", "1/30001", "1/40001", "1/30002" }) << 0
+                                     << QStringList({ "1/3/0/2/2", "1/4/0/2/2" });
+    QTest::newRow("mixed units") << QStringList({ "2/40001", "1/40002", "1/40001", "2/40002" }) << 0
+                                 << QStringList({ "1/3/0/2/2", "2/3/0/2/2" });
+    QTest::newRow("unit and function") << QStringList({ "2/30001", "1/40001", "2/40001", "1/30001" }) << 10
+                                       << QStringList({ "1/3/0/1/1", "1/4/0/1/1", "2/3/0/1/1", "2/4/0/1/1" });
+    QTest::newRow("empty") << QStringList() << 0 << QStringList();
+}
+
+void ModbusSourceTest::planBlocks()
+{
+    QFETCH(QStringList, points);
+    QFETCH(int, maxGap);
+    QFETCH(QStringList, blocks);
+
+    QVector<ModbusPoint> planned;
+    for (int i = 0; i < points.size(); ++i) {
+        planned.append(makePoint(points.at(i), i));
+    }
+    QVector<ModbusBlock> result = ModbusSource::planBlocks(&planned, maxGap);
+
+    QStringList actual;
+    for (const ModbusBlock &block : result) {
+        actual.append(describe(block));
+    }
+    QCOMPARE(actual, blocks);
+
+    // 每块的变量在数组中连续，且都落在块的寄存器范围内
+    int next = 0;
+    for (const ModbusBlock &block : result) {
+        QCOMPARE(block.firstPoint, next);
+        for (int i = block.firstPoint; i < block.firstPoint + block.pointCount; ++i) {
+            const ModbusPoint &point = planned.at(i);
+            QCOMPARE(point.unit, block.unit);
+            QCOMPARE(point.function, block.function);
+            QVERIFY(point.offset >= block.start);
+            QVERIFY(point.offset + point.width() <= block.start + block.count);
+        }
+        next += block.pointCount;
+    }
+    QCOMPARE(next, planned.size());
+}
@@ -0,0 +1,23 @@
+#ifndef MODBUSSOURCETEST_H
+#define MODBUSSOURCETEST_H
+
+#include <QObject>
+
+/**
+ * @brief Modbus数据源中纯函数的测试
+ * 数据源地址和变量地址的解析，以及寄存器块的合并规划
+ */
+class ModbusSourceTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseUrl_data();
+    void parseUrl();
+    void parseAddress_data();
+    void parseAddress();
+    void planBlocks_data();
+    void planBlocks();
+};
+
+#endif // MODBUSSOURCETEST_H
@@ -0,0 +1,162 @@
+#include "packedvaluedecodertest.h"
+#include <QtTest>
+#include <QtEndian>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include "packedvaluedecoder.h"
+#include "recordingsink.h"
+
+namespace {
+// 报文头，记录个数可以与实际的记录数不同
+QByteArray packedHeader(quint32 count, qint64 timestamp = 0)
+{
+    QByteArray header(PackedValueDecoder::kHeaderSize, '\0');
+    uchar *data = reinterpret_cast<uchar *>(header.data());
+    memcpy(data, "SCPK", 4);
+    data[4] = PackedValueDecoder::kVersion;
+    qToLittleEndian<quint32>(count, data + 8);
+    qToLittleEndian<qint64>(timestamp, data + 12);
+    return header;
+}
+
+void appendRecord(QByteArray *out, quint32 addr, double value)
+{
+    uchar record[PackedValueDecoder::kRecordSize];
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint32>(addr, record);
+    qToLittleEndian<quint64>(bits, record + 4);
+    out->append(reinterpret_cast<const char *>(record), PackedValueDecoder::kRecordSize);
+}
+
+quint64 doubleBits(double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+}
+
+void PackedValueDecoderTest::roundTrip()
+{
+    // 数值按位原样传递，包括-0、无穷大、NaN和非规格化数
+    struct Record {
+        quint32 addr;
+        double value;
+    };
+    const Record records[] = {
+        { 0, 2.5 },
+        { 7, -0.0 },
+        { 42, std::numeric_limits<double>::infinity() },
+        { 1000, std::numeric_limits<double>::quiet_NaN() },
+        { quint32(INT_MAX), std::numeric_limits<double>::denorm_min() },
+        { 0xffffffffu, -1e300 }
+    };
+    const int count = int(sizeof(records) / sizeof(records[0]));
+
+    QByteArray payload = packedHeader(quint32(count), Q_INT64_C(1700000000123));
+    for (const Record &record : records) {
+        appendRecord(&payload, record.addr, record.value);
+    }
+    QCOMPARE(int(ValueDecoder::sniff(payload)), int(ValueDecoder::Packed));
+
+    PackedValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(payload, &sink));
+    QVERIFY(!decoder.errorString());
+    QVERIFY(decoder.hasBody());
+    QCOMPARE(decoder.sampleCount(), count);
+    QCOMPARE(sink.timestamp, QByteArray("1700000000123"));
+
+    QCOMPARE(sink.samples.size(), count);
+    for (int i = 0; i < count; ++i) {
+        // 超出int范围的地址与JSON解码器一致取0
+        int addr = records[i].addr <= quint32(INT_MAX) ? int(records[i].addr) : 0;
+        QCOMPARE(sink.samples[i].addr, addr);
+        QCOMPARE(int(sink.samples[i].type), int(TagDouble));
+        QCOMPARE(doubleBits(sink.samples[i].value.d), doubleBits(records[i].value));
+    }
+}
+
+void PackedValueDecoderTest::emptyMessage()
+{
+    // 没有记录也算有body，时间戳为0或负数时不回调
+    PackedValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(decoder.decode(packedHeader(0), &sink));
+    QVERIFY(decoder.hasBody());
+    QCOMPARE(decoder.sampleCount(), 0);
+    QVERIFY(!sink.hasTimestamp);
+
+    QVERIFY(decoder.decode(packedHeader(0, -1), &sink));
+    QVERIFY(!sink.hasTimestamp);
+    QVERIFY(sink.samples.isEmpty());
+}
+
+void PackedValueDecoderTest::malformed_data()
+{
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<QByteArray>("error");
+    QTest::addColumn<int>("offset");
+
+    QByteArray oneRecord = packedHeader(1);
+    appendRecord(&oneRecord, 1, 1.0);
+
+    QByteArray badMagic = oneRecord;
+    badMagic[3] = 'X';
+    QByteArray badVersion = oneRecord;
+    badVersion[4] = char(PackedValueDecoder::kVersion + 1);
+
+    QByteArray shortRecord = oneRecord;
+    shortRecord.chop(1);
+    QByteArray trailingByte = oneRecord;
+    trailingByte.append('\0');
+    QByteArray missingRecord = packedHeader(2);
+    appendRecord(&missingRecord, 1, 1.0);
+    QByteArray maxCount = packedHeader(0xffffffffu);
+    appendRecord(&maxCount, 1, 1.0);
+    // 0x15555556 * 12 按32位计算回绕为8，长度检查必须用64位
+    QByteArray wrappedCount = packedHeader(0x15555556u) + QByteArray(8, '\0');
+
+    QTest::newRow("empty") << QByteArray() << QByteArray("truncated header") << 0;
+    QTest::newRow("short header") << packedHeader(0).left(PackedValueDecoder::kHeaderSize - 1)
+                                  << QByteArray("truncated header") << 0;
+    QTest::newRow("bad magic") << badMagic << QByteArray("bad magic") << 0;
+    QTest::newRow("json") << QByteArray(R"({"timestamp":"1","body":[]})") << QByteArray("bad magic") << 0;
+    QTest::newRow("unsupported version") << badVersion << QByteArray("unsupported version") << 4;
+    QTest::newRow("short record") << shortRecord
+                                  << QByteArray("record count does not match payload size") << 8;
+    QTest::newRow("trailing byte") << trailingByte
+                                   << QByteArray("record count does not match payload size") << 8;
+    QTest::newRow("missing record") << missingRecord
+                                    << QByteArray("record count does not match payload size") << 8;
+    QTest::newRow("over-long count") << maxCount
+                                     << QByteArray("record count does not match payload size") << 8;
+    QTest::newRow("wrapped count") << wrappedCount
+                                   << QByteArray("record count does not match payload size") << 8;
+}
+
+void PackedValueDecoderTest::malformed()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(QByteArray, error);
+    QFETCH(int, offset);
+
+    // 报文整体校验后才回调，出错时不产生任何数据点
+    PackedValueDecoder decoder;
+    RecordingSink sink;
+    QVERIFY(!decoder.decode(payload, &sink));
+    QVERIFY(decoder.errorString());
+    QCOMPARE(QByteArray(decoder.errorString()), error);
+    QCOMPARE(decoder.errorOffset(), offset);
+    QVERIFY(!decoder.hasBody());
+    QCOMPARE(decoder.sampleCount(), 0);
+    QVERIFY(!sink.hasTimestamp);
+    QVERIFY(sink.samples.isEmpty());
+
+    // 之后的正常报文不受影响
+    QVERIFY(decoder.decode(packedHeader(0), &sink));
+    QVERIFY(!decoder.errorString());
+    QCOMPARE(decoder.errorOffset(), -1);
+}
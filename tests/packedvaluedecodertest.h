@@ -0,0 +1,21 @@
+#ifndef PACKEDVALUEDECODERTEST_H
+#define PACKEDVALUEDECODERTEST_H
+
+#include <QObject>
+
+/**
+ * @brief PackedValueDecoder的行为测试
+ * 覆盖数值按位往返、时间戳，以及错误的魔数、不完整的记录和与长度不符的记录个数
+ */
+class PackedValueDecoderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void emptyMessage();
+    void malformed_data();
+    void malformed();
+};
+
+#endif // PACKEDVALUEDECODERTEST_H
@@ -0,0 +1,39 @@
+#ifndef RECORDINGSINK_H
+#define RECORDINGSINK_H
+
+#include <QByteArray>
+#include <QVector>
+#include "valuesink.h"
+
+/**
+ * @brief 记录解码结果的ValueSink，供解码器测试比对
+ */
+class RecordingSink : public ValueSink
+{
+public:
+    struct Sample {
+        int addr;
+        TagValue value;
+        TagType type;
+    };
+
+    RecordingSink() : hasTimestamp(false) {}
+
+    void onTimestamp(const char *data, int size) override
+    {
+        timestamp = QByteArray(data, size);
+        hasTimestamp = true;
+    }
+
+    void onSample(int addr, TagValue value, TagType type) override
+    {
+        Sample sample = { addr, value, type };
+        samples.append(sample);
+    }
+
+    QByteArray timestamp;       // 最后一次回调的时间戳
+    bool hasTimestamp;          // 是否回调过时间戳
+    QVector<Sample> samples;    // 按回调顺序的数据点
+};
+
+#endif // RECORDINGSINK_H
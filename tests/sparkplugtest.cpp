@@ -0,0 +1,293 @@
+#include "sparkplugtest.h"
+#include <QtTest>
+#include <algorithm>
+#include "sparkplugdecoder.h"
+#include "sparkplugencoder.h"
+#include "tagtable.h"
+#include "mqttcomm.h"
+
+namespace {
+const char kDeviceTopic[] = "spBv1.0/plant/DDATA/edge/pump";
+
+// 记录解码出的指标，名称复制出来
+class RecordingSparkplugSink : public SparkplugSink
+{
+public:
+    struct Metric {
+        QByteArray name;
+        SparkplugMetric metric;
+    };
+
+    RecordingSparkplugSink() : timestamp(0) {}
+
+    void onSparkplugTimestamp(quint64 value) override { timestamp = value; }
+
+    void onSparkplugMetric(const SparkplugMetric &metric) override
+    {
+        Metric entry = { QByteArray(metric.name, metric.nameSize), metric };
+        metrics.append(entry);
+    }
+
+    quint64 timestamp;
+    QVector<Metric> metrics;
+};
+
+// 设备的DBIRTH：speed、flow和没有绑定的other，别名依次为1、2、3
+QByteArray deviceBirth(double speed, double flow)
+{
+    QByteArray payload;
+    SparkplugEncoder encoder(&payload);
+    encoder.addTimestamp(Q_UINT64_C(1700000000000));
+    encoder.addDoubleMetric("speed", 1, speed);
+    encoder.addDoubleMetric("flow", 2, flow);
+    encoder.addDoubleMetric("other", 3, 0);
+    encoder.addSequence(0);
+    return payload;
+}
+
+// 只带别名的DDATA
+QByteArray deviceData(quint64 alias, double value)
+{
+    QByteArray payload;
+    SparkplugEncoder encoder(&payload);
+    encoder.addTimestamp(Q_UINT64_C(1700000000100));
+    encoder.addDoubleMetric(QByteArray(), alias, value);
+    encoder.addSequence(1);
+    return payload;
+}
+
+QMqttTopicName deviceTopic(const char *type)
+{
+    return QMqttTopicName(QString("spBv1.0/plant/%1/edge/pump").arg(QLatin1String(type)));
+}
+
+QMqttTopicName nodeTopic(const char *type)
+{
+    return QMqttTopicName(QString("spBv1.0/plant/%1/edge").arg(QLatin1String(type)));
+}
+}
+
+void SparkplugTest::decodePayload()
+{
+    QByteArray payload;
+    SparkplugEncoder encoder(&payload);
+    encoder.addTimestamp(Q_UINT64_C(1700000000123));
+    encoder.addDoubleMetric("speed", 300, 2.5);
+    encoder.addDoubleMetric(QByteArray(), 70000, -1.25);
+    encoder.addBooleanMetric("Node Control/Rebirth", true);
+    encoder.addSequence(255);
+
+    SparkplugDecoder decoder;
+    RecordingSparkplugSink sink;
+    QVERIFY(decoder.decode(payload, &sink));
+    QVERIFY(!decoder.errorString());
+    QCOMPARE(decoder.metricCount(), 3);
+    QCOMPARE(decoder.sequence(), 255);
+    QCOMPARE(sink.timestamp, Q_UINT64_C(1700000000123));
+    QCOMPARE(sink.metrics.size(), 3);
+
+    // BIRTH形式：名称、别名和数据类型
+    const SparkplugMetric &birth = sink.metrics[0].metric;
+    QCOMPARE(sink.metrics[0].name, QByteArray("speed"));
+    QVERIFY(birth.hasAlias);
+    QCOMPARE(birth.alias, Q_UINT64_C(300));
+    QCOMPARE(birth.datatype, quint32(SparkplugDecoder::Double));
+    TagValue value;
+    TagType type;
+    QVERIFY(SparkplugDecoder::toTagValue(birth, birth.datatype, &value, &type));
+    QCOMPARE(int(type), int(TagDouble));
+    QCOMPARE(value.d, 2.5);
+
+    // DATA形式：只有别名，数据类型按值所在的字段推断
+    const SparkplugMetric &data = sink.metrics[1].metric;
+    QVERIFY(!data.name);
+    QCOMPARE(data.alias, Q_UINT64_C(70000));
+    QCOMPARE(data.datatype, quint32(0));
+    QVERIFY(SparkplugDecoder::toTagValue(data, 0, &value, &type));
+    QCOMPARE(value.d, -1.25);
+
+    const SparkplugMetric &command = sink.metrics[2].metric;
+    QCOMPARE(sink.metrics[2].name, QByteArray("Node Control/Rebirth"));
+    QVERIFY(!command.hasAlias);
+    QVERIFY(SparkplugDecoder::toTagValue(command, command.datatype, &value, &type));
+    QCOMPARE(int(type), int(TagBool));
+    QCOMPARE(value.i, Q_INT64_C(1));
+
+    // Rebirth命令就是这样一个不带别名的布尔指标
+    sink = RecordingSparkplugSink();
+    QVERIFY(decoder.decode(SparkplugDecoder::rebirthRequest(Q_UINT64_C(1700000000123)), &sink));
+    QCOMPARE(sink.metrics.size(), 1);
+    QCOMPARE(sink.metrics[0].name, QByteArray("Node Control/Rebirth"));
+    QCOMPARE(decoder.sequence(), -1);
+}
+
+void SparkplugTest::truncated_data()
+{
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<QByteArray>("error");
+    QTest::addColumn<int>("offset");
+
+    QByteArray birth = deviceBirth(1.5, 2.5);
+
+    // 时间戳的varint（6字节）只剩前两个字节
+    QTest::newRow("varint") << birth.left(3) << QByteArray("Truncated varint") << 3;
+    // 第一个指标的长度超出报文
+    QTest::newRow("metric length") << birth.left(10) << QByteArray("Field length exceeds message") << 9;
+    // 指标长度自洽，但其中的double_value只有4字节
+    QTest::newRow("fixed64") << QByteArray::fromHex("12071001690000803f")
+                             << QByteArray("Truncated fixed-width value") << 5;
+    QTest::newRow("varint too long") << QByteArray::fromHex("08ffffffffffffffffffff01")
+                                     << QByteArray("Varint too long") << 11;
+    QTest::newRow("sequence") << QByteArray::fromHex("188002")
+                              << QByteArray("Sequence number out of range") << 3;
+}
+
+void SparkplugTest::truncated()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(QByteArray, error);
+    QFETCH(int, offset);
+
+    SparkplugDecoder decoder;
+    RecordingSparkplugSink sink;
+    QVERIFY(!decoder.decode(payload, &sink));
+    QVERIFY(decoder.errorString());
+    QCOMPARE(QByteArray(decoder.errorString()), error);
+    QCOMPARE(decoder.errorOffset(), offset);
+}
+
+void SparkplugTest::aliasLookup()
+{
+    TagTable tags;
+    int speed = tags.intern(kDeviceTopic, "speed", TagDouble);
+    int flow = tags.intern(kDeviceTopic, "flow", TagDouble);
+    MqttComm comm(&tags);
+    comm.setTags(QVector<int>() << speed << flow);
+
+    // DBIRTH按名称建立别名表并带有当前值
+    comm.handleMessage(deviceBirth(1.5, 2.5), deviceTopic("DBIRTH"));
+    QCOMPARE(tags.value(speed).d, 1.5);
+    QCOMPARE(tags.value(flow).d, 2.5);
+
+    // DDATA只按别名查表
+    comm.handleMessage(deviceData(2, 7.0), deviceTopic("DDATA"));
+    comm.handleMessage(deviceData(1, 3.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 3.0);
+    QCOMPARE(tags.value(flow).d, 7.0);
+    QCOMPARE(comm.unknownAddresses(), Q_INT64_C(0));
+
+    // BIRTH中有但没有绑定的别名，以及BIRTH中没有的别名
+    comm.handleMessage(deviceData(3, 9.0), deviceTopic("DDATA"));
+    comm.handleMessage(deviceData(9, 9.0), deviceTopic("DDATA"));
+    QCOMPARE(comm.unknownAddresses(), Q_INT64_C(2));
+    QCOMPARE(tags.value(speed).d, 3.0);
+    QCOMPARE(tags.value(flow).d, 7.0);
+}
+
+void SparkplugTest::missingBirth()
+{
+    TagTable tags;
+    int speed = tags.intern(kDeviceTopic, "speed", TagDouble);
+    MqttComm comm(&tags);
+    comm.setTags(QVector<int>() << speed);
+
+    // 没有BIRTH时别名无从解释，DATA整条忽略（连接时会请求重新BIRTH）
+    comm.handleMessage(deviceData(1, 5.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 0.0);
+    QCOMPARE(comm.receivedSamples(), Q_INT64_C(0));
+    QCOMPARE(comm.unknownAddresses(), Q_INT64_C(0));
+
+    comm.handleMessage(deviceBirth(1.5, 2.5), deviceTopic("DBIRTH"));
+    comm.handleMessage(deviceData(1, 5.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 5.0);
+}
+
+void SparkplugTest::truncatedBirth()
+{
+    TagTable tags;
+    int speed = tags.intern(kDeviceTopic, "speed", TagDouble);
+    MqttComm comm(&tags);
+    comm.setTags(QVector<int>() << speed);
+
+    // 截断在最后一个指标中间的DBIRTH：别名表不完整，之后的DATA不能使用
+    QByteArray birth = deviceBirth(1.5, 2.5);
+    comm.handleMessage(birth.left(birth.size() - 4), deviceTopic("DBIRTH"));
+    QCOMPARE(comm.decodeErrors(), Q_INT64_C(1));
+    comm.handleMessage(deviceData(1, 5.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 1.5);
+
+    comm.handleMessage(birth, deviceTopic("DBIRTH"));
+    comm.handleMessage(deviceData(1, 5.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 5.0);
+}
+
+void SparkplugTest::nodeLifecycle()
+{
+    // 只绑定设备主题时也订阅所属边缘节点的NBIRTH和NDEATH
+    TagTable tags;
+    int speed = tags.intern(kDeviceTopic, "speed", TagDouble);
+    MqttComm comm(&tags);
+    comm.setTags(QVector<int>() << speed);
+    QStringList filters = comm.subscriptionFilters();
+    std::sort(filters.begin(), filters.end());
+    QCOMPARE(filters, QStringList() << "spBv1.0/plant/+/edge/pump"
+                                    << "spBv1.0/plant/NBIRTH/edge"
+                                    << "spBv1.0/plant/NDEATH/edge");
+
+    comm.handleMessage(deviceBirth(1.5, 2.5), deviceTopic("DBIRTH"));
+    comm.handleMessage(deviceData(1, 5.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 5.0);
+
+    // NDEATH后设备的别名失效，直到设备重新DBIRTH
+    QByteArray death;
+    SparkplugEncoder deathEncoder(&death);
+    deathEncoder.addTimestamp(Q_UINT64_C(1700000000200));
+    comm.handleMessage(death, nodeTopic("NDEATH"));
+    comm.handleMessage(deviceData(1, 6.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 5.0);
+
+    comm.handleMessage(deviceBirth(1.5, 2.5), deviceTopic("DBIRTH"));
+    comm.handleMessage(deviceData(1, 6.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 6.0);
+
+    // NBIRTH同样使设备的别名失效；节点自己的指标没有绑定，不计为未知地址
+    QByteArray nodeBirth;
+    SparkplugEncoder encoder(&nodeBirth);
+    encoder.addTimestamp(Q_UINT64_C(1700000000300));
+    encoder.addDoubleMetric("bdSeq", 0, 1);
+    encoder.addSequence(0);
+    comm.handleMessage(nodeBirth, nodeTopic("NBIRTH"));
+    comm.handleMessage(deviceData(1, 7.0), deviceTopic("DDATA"));
+    QCOMPARE(tags.value(speed).d, 6.0);
+    QCOMPARE(comm.unknownAddresses(), Q_INT64_C(0));
+    QCOMPARE(comm.unroutedMessages(), Q_INT64_C(0));
+}
+
+void SparkplugTest::invalidTopics()
+{
+    // 组或节点是通配符、层级数不对的绑定不路由也不订阅
+    TagTable tags;
+    QVector<int> bound;
+    bound << tags.intern("spBv1.0/+/DDATA/edge/pump", "speed", TagDouble)
+          << tags.intern("spBv1.0/plant/DDATA/#", "speed", TagDouble)
+          << tags.intern("spBv1.0/plant/DDATA", "1", TagDouble)
+          << tags.intern("spBv1.0/plant/DDATA/edge/pump/extra", "speed", TagDouble);
+    int speed = tags.intern(kDeviceTopic, "speed", TagDouble);
+    bound << speed;
+    MqttComm comm(&tags);
+    comm.setTags(bound);
+    QStringList filters = comm.subscriptionFilters();
+    std::sort(filters.begin(), filters.end());
+    QCOMPARE(filters, QStringList() << "spBv1.0/plant/+/edge/pump"
+                                    << "spBv1.0/plant/NBIRTH/edge"
+                                    << "spBv1.0/plant/NDEATH/edge");
+
+    // 即使收到了这样的主题，报文也不会被当作其他格式解码
+    comm.handleMessage(R"({"body":[{"addr":1,"val":10}]})", QMqttTopicName("spBv1.0/plant/DDATA"));
+    QCOMPARE(comm.unroutedMessages(), Q_INT64_C(1));
+    QCOMPARE(comm.decodeErrors(), Q_INT64_C(0));
+    QCOMPARE(comm.receivedSamples(), Q_INT64_C(0));
+
+    comm.handleMessage(deviceBirth(1.5, 2.5), deviceTopic("DBIRTH"));
+    QCOMPARE(tags.value(speed).d, 1.5);
+}
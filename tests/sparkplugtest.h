@@ -0,0 +1,26 @@
+#ifndef SPARKPLUGTEST_H
+#define SPARKPLUGTEST_H
+
+#include <QObject>
+
+/**
+ * @brief Sparkplug B解码和别名路由的测试
+ * 报文由SparkplugEncoder生成，覆盖别名查找、缺少BIRTH、截断的protobuf，
+ * 只绑定设备主题时边缘节点NBIRTH/NDEATH对设备别名表的影响，以及无效的Sparkplug B绑定
+ */
+class SparkplugTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodePayload();
+    void truncated_data();
+    void truncated();
+    void aliasLookup();
+    void missingBirth();
+    void truncatedBirth();
+    void nodeLifecycle();
+    void invalidTopics();
+};
+
+#endif // SPARKPLUGTEST_H
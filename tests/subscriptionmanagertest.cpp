@@ -0,0 +1,95 @@
+#include "subscriptionmanagertest.h"
+#include <QtTest>
+#include <QHostAddress>
+#include <QtMqtt/qmqttclient.h>
+#include "subscriptionmanager.h"
+#include "minibroker.h"
+
+namespace {
+
+const int kTimeout = 5000;
+
+void setupClient(QMqttClient *client, const MiniBroker &broker)
+{
+    client->setHostname(QHostAddress(QHostAddress::LocalHost).toString());
+    client->setPort(broker.serverPort());
+    client->setClientId("subscriptionmanagertest");
+}
+
+}
+
+void SubscriptionManagerTest::refCounting()
+{
+    MiniBroker broker;
+    QVERIFY2(broker.listen(QHostAddress::LocalHost, 0), qPrintable(broker.errorString()));
+    QMqttClient client;
+    setupClient(&client, broker);
+    SubscriptionManager manager(&client);
+
+    // 连接前登记的主题在连接后一次订阅，同一主题只订阅一次
+    manager.acquire("plant/a");
+    manager.acquire("plant/a");
+    manager.acquire("plant/b");
+    QStringList topics = manager.topics();
+    topics.sort();
+    QCOMPARE(topics, QStringList({ "plant/a", "plant/b" }));
+    QCOMPARE(manager.activeCount(), 0);
+
+    client.connectToHost();
+    QTRY_COMPARE_WITH_TIMEOUT(manager.activeCount(), 2, kTimeout);
+    QVERIFY(broker.hasSubscriber("plant/a"));
+    QVERIFY(broker.hasSubscriber("plant/b"));
+
+    // 引用未归零时不取消订阅
+    manager.release("plant/a");
+    QCOMPARE(manager.topics().size(), 2);
+    QCOMPARE(manager.activeCount(), 2);
+
+    manager.release("plant/a");
+    QCOMPARE(manager.topics(), QStringList({ "plant/b" }));
+    QCOMPARE(manager.activeCount(), 1);
+    QTRY_VERIFY_WITH_TIMEOUT(!broker.hasSubscriber("plant/a"), kTimeout);
+    QVERIFY(broker.hasSubscriber("plant/b"));
+
+    // 未引用的主题释放时忽略
+    manager.release("plant/c");
+    QCOMPARE(manager.activeCount(), 1);
+
+    client.disconnectFromHost();
+    QTRY_COMPARE_WITH_TIMEOUT(client.state(), QMqttClient::Disconnected, kTimeout);
+}
+
+void SubscriptionManagerTest::resubscribeOnReconnect()
+{
+    MiniBroker broker;
+    QVERIFY2(broker.listen(QHostAddress::LocalHost, 0), qPrintable(broker.errorString()));
+    QMqttClient client;
+    setupClient(&client, broker);
+    SubscriptionManager manager(&client);
+    QSignalSpy activeSpy(&manager, &SubscriptionManager::activeCountChanged);
+
+    manager.acquire("plant/a");
+    manager.acquire("plant/b");
+    client.connectToHost();
+    QTRY_COMPARE_WITH_TIMEOUT(manager.activeCount(), 2, kTimeout);
+
+    // 断开后已确认的订阅不再计入
+    client.disconnectFromHost();
+    QTRY_COMPARE_WITH_TIMEOUT(client.state(), QMqttClient::Disconnected, kTimeout);
+    QCOMPARE(manager.activeCount(), 0);
+    QCOMPARE(activeSpy.last().at(0).toInt(), 0);
+    QTRY_COMPARE_WITH_TIMEOUT(broker.clientCount(), 0, kTimeout);
+
+    // 断开期间的变化在连上后补发；MiniBroker不保持会话，其余主题也要重新订阅
+    manager.release("plant/a");
+    manager.acquire("plant/c");
+    client.connectToHost();
+    QTRY_COMPARE_WITH_TIMEOUT(manager.activeCount(), 2, kTimeout);
+    QVERIFY(!broker.hasSubscriber("plant/a"));
+    QVERIFY(broker.hasSubscriber("plant/b"));
+    QVERIFY(broker.hasSubscriber("plant/c"));
+    QCOMPARE(activeSpy.last().at(0).toInt(), 2);
+
+    client.disconnectFromHost();
+    QTRY_COMPARE_WITH_TIMEOUT(client.state(), QMqttClient::Disconnected, kTimeout);
+}
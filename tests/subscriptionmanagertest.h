@@ -0,0 +1,19 @@
+#ifndef SUBSCRIPTIONMANAGERTEST_H
+#define SUBSCRIPTIONMANAGERTEST_H
+
+#include <QObject>
+
+/**
+ * @brief 订阅管理的测试
+ * 连接进程内的MiniBroker，检查按主题计引用，以及重连后服务器没有恢复会话时重新订阅
+ */
+class SubscriptionManagerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void refCounting();
+    void resubscribeOnReconnect();
+};
+
+#endif // SUBSCRIPTIONMANAGERTEST_H
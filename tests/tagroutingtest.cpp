@@ -0,0 +1,144 @@
+#include "tagroutingtest.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <algorithm>
+#include "tagtable.h"
+#include "mqttcomm.h"
+#include "scenefile.h"
+
+void TagRoutingTest::tagTable()
+{
+    TagTable tags;
+    int first = tags.intern("plant/a", "1", TagInt);
+    int second = tags.intern("plant/b", "1", TagDouble);
+    QVERIFY(first != second);
+    QCOMPARE(tags.size(), 2);
+
+    // 重复登记返回原ID，类型以首次登记为准
+    QCOMPARE(tags.intern("plant/a", "1", TagBool), first);
+    QCOMPARE(int(tags.type(first)), int(TagInt));
+    QCOMPARE(int(tags.type(second)), int(TagDouble));
+
+    QCOMPARE(tags.tagId("plant/a", "1"), first);
+    QCOMPARE(tags.tagId("plant/b", "1"), second);
+    QCOMPARE(tags.tagId("plant/c", "1"), -1);
+    QCOMPARE(tags.topic(second), QString("plant/b"));
+    QCOMPARE(tags.address(second), QString("1"));
+}
+
+void TagRoutingTest::sharedAddressRouting()
+{
+    TagTable tags;
+    int first = tags.intern("plant/a", "1", TagInt);
+    int second = tags.intern("plant/b", "1", TagInt);
+    int other = tags.intern("plant/b", "2", TagInt);
+    MqttComm comm(&tags);
+    comm.setTags(QVector<int>() << first << second << other);
+
+    comm.handleMessage(R"({"body":[{"addr":1,"val":10}]})", QMqttTopicName("plant/a"));
+    QCOMPARE(tags.value(first).i, Q_INT64_C(10));
+    QCOMPARE(tags.value(second).i, Q_INT64_C(0));
+
+    comm.handleMessage(R"({"body":[{"addr":1,"val":20},{"addr":2,"val":30}]})", QMqttTopicName("plant/b"));
+    QCOMPARE(tags.value(first).i, Q_INT64_C(10));
+    QCOMPARE(tags.value(second).i, Q_INT64_C(20));
+    QCOMPARE(tags.value(other).i, Q_INT64_C(30));
+
+    // 只绑定在其他主题下的地址不写入
+    comm.handleMessage(R"({"body":[{"addr":2,"val":40}]})", QMqttTopicName("plant/a"));
+    QCOMPARE(tags.value(other).i, Q_INT64_C(30));
+    QCOMPARE(comm.unknownAddresses(), Q_INT64_C(1));
+
+    QVector<int> changed;
+    tags.takeChanged(&changed);
+    std::sort(changed.begin(), changed.end());
+    QCOMPARE(changed, QVector<int>() << first << second << other);
+}
+
+void TagRoutingTest::sparseAddressRouting()
+{
+    // 远大于变量个数的地址走稀疏表，与直接索引表中的地址一样能匹配
+    TagTable tags;
+    int low = tags.intern("plant/a", "5", TagInt);
+    int high = tags.intern("plant/a", "1000000", TagInt);
+    int negative = tags.intern("plant/b", "-3", TagInt);
+    MqttComm comm(&tags);
+    comm.setTags(QVector<int>() << low << high << negative);
+
+    comm.handleMessage(R"({"body":[{"addr":1000000,"val":1},{"addr":5,"val":2},{"addr":999999,"val":3}]})",
+                       QMqttTopicName("plant/a"));
+    comm.handleMessage(R"({"body":[{"addr":-3,"val":4}]})", QMqttTopicName("plant/b"));
+    QCOMPARE(tags.value(high).i, Q_INT64_C(1));
+    QCOMPARE(tags.value(low).i, Q_INT64_C(2));
+    QCOMPARE(tags.value(negative).i, Q_INT64_C(4));
+    QCOMPARE(comm.unknownAddresses(), Q_INT64_C(1));
+}
+
+void TagRoutingTest::sharedAddressSceneFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString jsonFile = dir.filePath("scene.json");
+    QString binaryFile = dir.filePath("scene.scnb");
+
+    // 相同地址绑定在两个主题下；未指定主题与显式写公共主题是同一个变量
+    QFile json(jsonFile);
+    QVERIFY(json.open(QIODevice::WriteOnly));
+    json.write(R"({"items":[)"
+               R"({"itemType":"ValueDisplay","x":0,"y":0,"width":10,"height":10,)"
+               R"("binding":{"address":"1","topic":"plant/a","dataType":"int"}},)"
+               R"({"itemType":"ValueDisplay","x":20,"y":0,"width":10,"height":10,)"
+               R"("binding":{"address":"1","topic":"plant/b","dataType":"double"}},)"
+               R"({"itemType":"ValueDisplay","x":40,"y":0,"width":10,"height":10,)"
+               R"("binding":{"address":"1"}},)"
+               R"({"itemType":"ValueDisplay","x":60,"y":0,"width":10,"height":10,)"
+               R"("binding":{"address":"1","topic":"scada/values"}},)"
+               R"({"itemType":"ValueDisplay","x":80,"y":0,"width":10,"height":10,)"
+               R"("binding":{"address":"1","topic":"plant/a"}}]})");
+    json.close();
+
+    QString errorString;
+    QVERIFY2(SceneFile::compile(jsonFile, binaryFile, &errorString), qPrintable(errorString));
+
+    {
+        SceneFile scene;
+        QVERIFY2(scene.open(binaryFile), qPrintable(scene.errorString()));
+        QCOMPARE(scene.tagCount(), 3);
+        QCOMPARE(scene.tagTopic(0), QString("plant/a"));
+        QCOMPARE(scene.tagTopic(1), QString("plant/b"));
+        QCOMPARE(scene.tagTopic(2), QString(SceneFile::kDefaultTopic));
+        for (int tag = 0; tag < scene.tagCount(); ++tag) {
+            QCOMPARE(scene.tagAddress(tag), QString("1"));
+        }
+        QCOMPARE(int(scene.tagType(0)), int(TagInt));
+        QCOMPARE(int(scene.tagType(1)), int(TagDouble));
+
+        QCOMPARE(scene.itemCount(), 5);
+        const int expectedTags[] = { 0, 1, 2, 2, 0 };
+        for (int i = 0; i < scene.itemCount(); ++i) {
+            QCOMPARE(scene.item(i).tag, expectedTags[i]);
+        }
+    }
+
+    // (主题, 地址)重复的文件在打开时即被拒绝，查看器不会先清除现有场景
+    {
+        QFile binary(binaryFile);
+        QVERIFY(binary.open(QIODevice::ReadOnly));
+        QByteArray data = binary.readAll();
+        char *raw = data.data();
+        const SceneFileHeader *header = reinterpret_cast<const SceneFileHeader *>(raw);
+        SceneTagRecord *records = reinterpret_cast<SceneTagRecord *>(raw + header->tagsOffset);
+        records[1].topicOffset = records[0].topicOffset;
+        records[1].topicLength = records[0].topicLength;
+
+        QString duplicateFile = dir.filePath("duplicate.scnb");
+        QFile duplicate(duplicateFile);
+        QVERIFY(duplicate.open(QIODevice::WriteOnly));
+        QCOMPARE(duplicate.write(data), qint64(data.size()));
+        duplicate.close();
+
+        SceneFile scene;
+        QVERIFY(!scene.open(duplicateFile));
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef TAGROUTINGTEST_H
+#define TAGROUTINGTEST_H
+
+#include <QObject>
+
+/**
+ * @brief 变量按(主题, 地址)区分的测试
+ * 两个主题下的相同地址是不同的变量：变量表、MQTT路由和编译场景都不能把它们合并
+ */
+class TagRoutingTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tagTable();
+    void sharedAddressRouting();
+    void sparseAddressRouting();
+    void sharedAddressSceneFile();
+};
+
+#endif // TAGROUTINGTEST_H
@@ -0,0 +1,77 @@
+QT       += core mqtt network testlib
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = tests
+TEMPLATE = app
+
+# 被测代码直接编译进测试程序
+RUNTIME_DIR = $$PWD/../runtime
+COMMON_DIR = $$PWD/../common
+MQTTLOAD_DIR = $$PWD/../tools/mqttload
+
+INCLUDEPATH += $$RUNTIME_DIR $$COMMON_DIR $$MQTTLOAD_DIR
+
+SOURCES += \
+    main.cpp \
+    jsonvaluedecodertest.cpp \
+    cborvaluedecodertest.cpp \
+    packedvaluedecodertest.cpp \
+    sparkplugtest.cpp \
+    tagroutingtest.cpp \
+    topictrietest.cpp \
+    subscriptionmanagertest.cpp \
+    modbussourcetest.cpp \
+    $$RUNTIME_DIR/datasource.cpp \
+    $$RUNTIME_DIR/mqttcomm.cpp \
+    $$RUNTIME_DIR/modbussource.cpp \
+    $$RUNTIME_DIR/jsonvaluedecoder.cpp \
+    $$RUNTIME_DIR/cborvaluedecoder.cpp \
+    $$RUNTIME_DIR/packedvaluedecoder.cpp \
+    $$RUNTIME_DIR/sparkplugdecoder.cpp \
+    $$RUNTIME_DIR/sparkplugencoder.cpp \
+    $$RUNTIME_DIR/tagtable.cpp \
+    $$RUNTIME_DIR/tagvalue.cpp \
+    $$RUNTIME_DIR/topictrie.cpp \
+    $$RUNTIME_DIR/subscriptionmanager.cpp \
+    $$RUNTIME_DIR/scenefile.cpp \
+    $$RUNTIME_DIR/latencyhistogram.cpp \
+    $$RUNTIME_DIR/latencytracker.cpp \
+    $$COMMON_DIR/trace.cpp \
+    $$COMMON_DIR/logcategories.cpp \
+    $$MQTTLOAD_DIR/minibroker.cpp
+
+HEADERS += \
+    recordingsink.h \
+    jsonvaluedecodertest.h \
+    cborvaluedecodertest.h \
+    packedvaluedecodertest.h \
+    sparkplugtest.h \
+    tagroutingtest.h \
+    topictrietest.h \
+    subscriptionmanagertest.h \
+    modbussourcetest.h \
+    $$RUNTIME_DIR/datasource.h \
+    $$RUNTIME_DIR/mqttcomm.h \
+    $$RUNTIME_DIR/modbussource.h \
+    $$RUNTIME_DIR/valuesink.h \
+    $$RUNTIME_DIR/valuedecoder.h \
+    $$RUNTIME_DIR/jsonvaluedecoder.h \
+    $$RUNTIME_DIR/cborvaluedecoder.h \
+    $$RUNTIME_DIR/packedvaluedecoder.h \
+    $$RUNTIME_DIR/sparkplugdecoder.h \
+    $$RUNTIME_DIR/sparkplugencoder.h \
+    $$RUNTIME_DIR/tagtable.h \
+    $$RUNTIME_DIR/tagvalue.h \
+    $$RUNTIME_DIR/topictrie.h \
+    $$RUNTIME_DIR/subscriptionmanager.h \
+    $$RUNTIME_DIR/samplering.h \
+    $$RUNTIME_DIR/scenefile.h \
+    $$RUNTIME_DIR/latencyhistogram.h \
+    $$RUNTIME_DIR/latencytracker.h \
+    $$COMMON_DIR/trace.h \
+    $$COMMON_DIR/logcategories.h \
+    $$MQTTLOAD_DIR/minibroker.h
+
+DEFINES += QT_DEPRECATED_WARNINGS
@@ -0,0 +1,118 @@
+#include "topictrietest.h"
+#include <QtTest>
+#include "topictrie.h"
+#include "tagtable.h"
+#include "mqttcomm.h"
+
+namespace {
+
+const char *const kFilters[] = {
+    "plant/a/temp",
+    "plant/+/temp",
+    "plant/#",
+    "site/+",
+    "site/+/+",
+    "line/1"
+};
+
+}
+
+void TopicTrieTest::match_data()
+{
+    QTest::addColumn<QString>("topic");
+    QTest::addColumn<QString>("route");
+
+    // 精确层级优先于+，+优先于#
+    QTest::newRow("exact") << "plant/a/temp" << "plant/a/temp";
+    QTest::newRow("plus") << "plant/b/temp" << "plant/+/temp";
+    QTest::newRow("hash") << "plant/b/pressure" << "plant/#";
+    QTest::newRow("hash deep") << "plant/a/temp/raw" << "plant/#";
+    QTest::newRow("hash parent") << "plant" << "plant/#";
+    QTest::newRow("plus one level") << "site/x" << "site/+";
+    QTest::newRow("plus two levels") << "site/x/y" << "site/+/+";
+    QTest::newRow("plus too deep") << "site/x/y/z" << QString();
+    QTest::newRow("plus empty level") << "site/" << "site/+";
+    QTest::newRow("exact only") << "line/1" << "line/1";
+    QTest::newRow("exact prefix") << "line" << QString();
+    QTest::newRow("exact longer") << "line/1/2" << QString();
+    QTest::newRow("unknown") << "other/a" << QString();
+}
+
+void TopicTrieTest::match()
+{
+    QFETCH(QString, topic);
+    QFETCH(QString, route);
+
+    TopicTrie trie;
+    for (const char *filter : kFilters) {
+        trie.insert(filter);
+    }
+    QCOMPARE(trie.routeCount(), int(sizeof(kFilters) / sizeof(kFilters[0])));
+
+    int index = trie.match(topic);
+    if (route.isEmpty()) {
+        QCOMPARE(index, -1);
+    } else {
+        QVERIFY(index >= 0);
+        QCOMPARE(trie.route(index), route);
+    }
+}
+
+void TopicTrieTest::dollarTopics()
+{
+    TopicTrie trie;
+    int all = trie.insert("#");
+    int plus = trie.insert("+/status");
+    int sys = trie.insert("$SYS/#");
+
+    // 首层的+和#不匹配$开头的主题
+    QCOMPARE(trie.match("$SYS/broker/uptime"), sys);
+    QCOMPARE(trie.match("$share/status"), -1);
+    QCOMPARE(trie.match("plant/status"), plus);
+    QCOMPARE(trie.match("plant/a"), all);
+
+    // 非首层的$没有特殊含义
+    QCOMPARE(trie.match("plant/$x"), all);
+
+    // 重复登记返回原编号
+    QCOMPARE(trie.insert("#"), all);
+    QCOMPARE(trie.routeCount(), 3);
+}
+
+void TopicTrieTest::siblingMerge_data()
+{
+    QTest::addColumn<int>("wildcardMinTopics");
+    QTest::addColumn<QStringList>("filters");
+
+    QTest::newRow("disabled") << 0
+        << QStringList({ "plant/a", "plant/b", "plant/c", "plant/d/e", "plant/x/#", "solo" });
+    QTest::newRow("below threshold") << 4
+        << QStringList({ "plant/a", "plant/b", "plant/c", "plant/d/e", "plant/x/#", "solo" });
+    QTest::newRow("at threshold") << 3
+        << QStringList({ "plant/+", "plant/d/e", "plant/x/#", "solo" });
+}
+
+void TopicTrieTest::siblingMerge()
+{
+    QFETCH(int, wildcardMinTopics);
+    QFETCH(QStringList, filters);
+
+    // plant下有3个兄弟主题，plant/x/y已被plant/x/#覆盖，solo没有父层级，
+    // plant/d/e的父层级plant/d下只有它一个
+    TagTable tags;
+    QVector<int> bound;
+    const char *const topics[] = {
+        "plant/a", "plant/b", "plant/c", "plant/x/#", "plant/x/y", "plant/d/e", "solo"
+    };
+    for (const char *topic : topics) {
+        bound.append(tags.intern(topic, "1", TagInt));
+    }
+
+    MqttComm comm(&tags);
+    comm.setTags(bound, wildcardMinTopics);
+
+    QStringList actual = comm.subscriptionFilters();
+    actual.sort();
+    filters.sort();
+    QCOMPARE(actual, filters);
+}
@@ -0,0 +1,22 @@
+#ifndef TOPICTRIETEST_H
+#define TOPICTRIETEST_H
+
+#include <QObject>
+
+/**
+ * @brief 主题前缀树和订阅合并的测试
+ * 覆盖+和#的匹配与优先级、$开头的主题，以及按wildcardMinTopics合并兄弟主题
+ */
+class TopicTrieTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void match_data();
+    void match();
+    void dollarTopics();
+    void siblingMerge_data();
+    void siblingMerge();
+};
+
+#endif // TOPICTRIETEST_H
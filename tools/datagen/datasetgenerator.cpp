@@ -0,0 +1,352 @@
+#include "datasetgenerator.h"
+#include <QRandomGenerator>
+#include <QBuffer>
+#include <QImage>
+#include <QPainter>
+#include <QLocale>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+
+const int kFlushSize = 1024 * 1024;     // 缓冲区超过此大小时写出
+
+// 三种文件使用的随机序列编号
+enum Stream {
+    SceneStream = 1,
+    ConfigStream = 2,
+    LibraryStream = 3
+};
+
+/**
+ * @brief 带缓冲的文本输出
+ */
+class Output
+{
+public:
+    explicit Output(QIODevice *device)
+        : m_device(device)
+        , m_ok(true)
+    {
+        m_buffer.reserve(kFlushSize + 4096);
+    }
+
+    Output &operator<<(const char *text) { m_buffer.append(text); return check(); }
+    Output &operator<<(const QByteArray &text) { m_buffer.append(text); return check(); }
+    Output &operator<<(const QString &text) { m_buffer.append(text.toUtf8()); return check(); }
+
+    void indent(int level) { m_buffer.append(QByteArray(4 * level, ' ')); }
+
+    bool finish()
+    {
+        flush();
+        return m_ok;
+    }
+
+private:
+    Output &check()
+    {
+        if (m_buffer.size() >= kFlushSize) {
+            flush();
+        }
+        return *this;
+    }
+
+    void flush()
+    {
+        if (m_ok && !m_buffer.isEmpty() && m_device->write(m_buffer) != m_buffer.size()) {
+            m_ok = false;
+        }
+        m_buffer.resize(0);
+    }
+
+    QIODevice *m_device;
+    QByteArray m_buffer;
+    bool m_ok;
+};
+
+// 与QJsonDocument相同的数字格式
+QByteArray jsonNumber(double value)
+{
+    return QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+}
+
+// 与QDomElement::setAttribute(double)相同的数字格式
+QByteArray xmlNumber(double value)
+{
+    return QByteArray::number(value);
+}
+
+// QDom写属性时转义的字符
+QByteArray xmlEscape(const QString &text)
+{
+    QByteArray utf8 = text.toUtf8();
+    QByteArray escaped;
+    escaped.reserve(utf8.size());
+    for (char c : utf8) {
+        switch (c) {
+        case '<': escaped.append("&lt;"); break;
+        case '>': escaped.append("&gt;"); break;
+        case '&': escaped.append("&amp;"); break;
+        case '"': escaped.append("&quot;"); break;
+        default: escaped.append(c); break;
+        }
+    }
+    return escaped;
+}
+
+void writeAttribute(Output &out, const char *name, const QByteArray &value)
+{
+    out << " " << name << "=\"" << value << "\"";
+}
+
+template <typename T, int N>
+const T &pick(QRandomGenerator &random, const T (&values)[N])
+{
+    return values[random.bounded(N)];
+}
+
+}
+
+DatasetGenerator::DatasetGenerator(quint32 seed)
+    : m_seed(seed)
+{
+}
+
+bool DatasetGenerator::writeScene(QIODevice *device, int itemCount, int addressCount) const
+{
+    static const char *const kTypes[] = { "ValueDisplay", "Rectangle", "Ellipse" };
+    static const char *const kDataTypes[] = { "float", "int", "bool" };
+    static const char *const kUpdateRates[] = { "100", "500", "1000", "5000" };
+
+    QRandomGenerator random(m_seed * 4 + SceneStream);
+    addressCount = qMax(1, addressCount);
+
+    // 与QJsonDocument::Indented相同的布局，对象的键按字母顺序排列
+    Output out(device);
+    out << "{\n";
+    out.indent(1);
+    out << "\"items\": [\n";
+    for (int i = 0; i < itemCount; ++i) {
+        const char *type = pick(random, kTypes);
+        bool valueDisplay = (type == kTypes[0]);
+        double width = valueDisplay ? 100 : double(20 + random.bounded(180));
+        double height = valueDisplay ? 40 : double(20 + random.bounded(180));
+        double x = double(random.bounded(8000));
+        double y = double(random.bounded(6000));
+
+        out.indent(2);
+        out << "{\n";
+        if (valueDisplay) {
+            int address = int(random.bounded(addressCount));
+            out.indent(3);
+            out << "\"binding\": {\n";
+            out.indent(4);
+            out << "\"accessMode\": \"read\",\n";
+            out.indent(4);
+            out << "\"address\": \"" << QByteArray::number(address) << "\",\n";
+            out.indent(4);
+            out << "\"dataType\": \"" << pick(random, kDataTypes) << "\",\n";
+            out.indent(4);
+            out << "\"updateRate\": \"" << pick(random, kUpdateRates) << "\",\n";
+            out.indent(4);
+            out << "\"variableName\": \"var_" << QByteArray::number(address) << "\"\n";
+            out.indent(3);
+            out << "},\n";
+        }
+        out.indent(3);
+        out << "\"componentId\": \"item_" << QByteArray::number(i) << "\",\n";
+        out.indent(3);
+        out << "\"height\": " << jsonNumber(height) << ",\n";
+        out.indent(3);
+        out << "\"itemType\": \"" << type << "\",\n";
+        out.indent(3);
+        out << "\"width\": " << jsonNumber(width) << ",\n";
+        out.indent(3);
+        out << "\"x\": " << jsonNumber(x) << ",\n";
+        out.indent(3);
+        out << "\"y\": " << jsonNumber(y) << "\n";
+        out.indent(2);
+        out << (i + 1 < itemCount ? "},\n" : "}\n");
+    }
+    out.indent(1);
+    out << "]\n";
+    out << "}\n";
+    return out.finish();
+}
+
+bool DatasetGenerator::writeVariableConfig(QIODevice *device, int variableCount, int bindingCount) const
+{
+    static const char *const kDataTypes[] = { "float", "int", "bool" };
+    static const char *const kUpdateRates[] = { "100", "500", "1000", "5000" };
+    static const char *const kAccessModes[] = { "read", "write", "readwrite" };
+
+    QRandomGenerator random(m_seed * 4 + ConfigStream);
+
+    // 与QDomDocument::toString(4)相同的布局，属性按XmlConfig::saveConfig的设置顺序
+    Output out(device);
+    out << "<config>\n";
+    out.indent(1);
+    if (variableCount > 0) {
+        out << "<variables>\n";
+        for (int i = 0; i < variableCount; ++i) {
+            QByteArray index = QByteArray::number(i);
+            out.indent(2);
+            out << "<variable";
+            writeAttribute(out, "name", "var_" + index);
+            writeAttribute(out, "dataType", pick(random, kDataTypes));
+            writeAttribute(out, "address", index);
+            writeAttribute(out, "updateRate", pick(random, kUpdateRates));
+            writeAttribute(out, "accessMode", pick(random, kAccessModes));
+            out << "/>\n";
+        }
+        out.indent(1);
+        out << "</variables>\n";
+    } else {
+        out << "<variables/>\n";
+    }
+
+    // saveConfig按组件ID的字典序输出绑定
+    QVector<int> componentIds;
+    componentIds.reserve(bindingCount);
+    for (int i = 0; i < bindingCount; ++i) {
+        componentIds.append(i);
+    }
+    std::sort(componentIds.begin(), componentIds.end(), [](int a, int b) {
+        return QByteArray::number(a) < QByteArray::number(b);
+    });
+
+    out.indent(1);
+    if (bindingCount > 0 && variableCount > 0) {
+        out << "<bindings>\n";
+        for (int id : componentIds) {
+            QByteArray variable = QByteArray::number(int(random.bounded(variableCount)));
+            out.indent(2);
+            out << "<binding";
+            writeAttribute(out, "componentId", "item_" + QByteArray::number(id));
+            writeAttribute(out, "variableName", "var_" + variable);
+            writeAttribute(out, "dataType", "float");
+            writeAttribute(out, "address", variable);
+            writeAttribute(out, "updateRate", "1000");
+            writeAttribute(out, "accessMode", "read");
+            out << "/>\n";
+        }
+        out.indent(1);
+        out << "</bindings>\n";
+    } else {
+        out << "<bindings/>\n";
+    }
+    out << "</config>\n";
+    return out.finish();
+}
+
+bool DatasetGenerator::writeComponentLibrary(QIODevice *device, int componentCount) const
+{
+    static const char *const kCategories[] = { "Basic", "Instruments", "Custom", "Containers" };
+
+    QRandomGenerator random(m_seed * 4 + LibraryStream);
+
+    // 与ComponentDesigner::saveComponentToLibrary一致：UTF-8 BOM、XML声明、
+    // 组件列表，最后是最近一次保存的类别
+    Output out(device);
+    out << "\xef\xbb\xbf<?xml version='1.0' encoding='UTF-8'?>\n";
+    out << "<components>\n";
+    const char *category = kCategories[0];
+    for (int i = 0; i < componentCount; ++i) {
+        QByteArray name = "C" + QByteArray::number(i);
+        category = pick(random, kCategories);
+
+        out.indent(1);
+        out << "<component";
+        writeAttribute(out, "name", name);
+        writeAttribute(out, "displayName", name);
+        writeAttribute(out, "description", xmlEscape(QString("Generated component %1").arg(i)));
+        writeAttribute(out, "category", category);
+        out << ">\n";
+
+        // 组件由若干矩形和椭圆组成，预览图按同样的形状绘制
+        QImage preview(100, 100, QImage::Format_ARGB32);
+        preview.fill(Qt::white);
+        QPainter painter(&preview);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::black);
+        painter.scale(0.4, 0.4);
+
+        int itemCount = 1 + int(random.bounded(6));
+        out.indent(2);
+        out << "<items>\n";
+        for (int j = 0; j < itemCount; ++j) {
+            bool ellipse = random.bounded(2) == 1;
+            double width = double(20 + random.bounded(100));
+            double height = double(20 + random.bounded(80));
+            double posX = double(random.bounded(150));
+            double posY = double(random.bounded(150));
+
+            out.indent(3);
+            out << "<item";
+            writeAttribute(out, "type", ellipse ? "ellipse" : "rect");
+            writeAttribute(out, "x", xmlNumber(0));
+            writeAttribute(out, "y", xmlNumber(0));
+            writeAttribute(out, "width", xmlNumber(width));
+            writeAttribute(out, "height", xmlNumber(height));
+            writeAttribute(out, "posX", xmlNumber(posX));
+            writeAttribute(out, "posY", xmlNumber(posY));
+            writeAttribute(out, "rotation", xmlNumber(0));
+            writeAttribute(out, "scale", xmlNumber(1));
+            out << "/>\n";
+
+            QRectF rect(posX, posY, width, height);
+            if (ellipse) {
+                painter.drawEllipse(rect);
+            } else {
+                painter.drawRect(rect);
+            }
+        }
+        painter.end();
+        out.indent(2);
+        out << "</items>\n";
+
+        QByteArray png;
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        preview.save(&buffer, "PNG");
+
+        out.indent(2);
+        out << "<preview>" << png.toBase64() << "</preview>\n";
+        out.indent(1);
+        out << "</component>\n";
+    }
+    out.indent(1);
+    out << "<category";
+    writeAttribute(out, "value", category);
+    out << "/>\n";
+    out << "</components>\n";
+    return out.finish();
+}
+
+QByteArray DatasetGenerator::scene(int itemCount, int addressCount) const
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    writeScene(&buffer, itemCount, addressCount);
+    return data;
+}
+
+QByteArray DatasetGenerator::variableConfig(int variableCount, int bindingCount) const
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    writeVariableConfig(&buffer, variableCount, bindingCount);
+    return data;
+}
+
+QByteArray DatasetGenerator::componentLibrary(int componentCount) const
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    writeComponentLibrary(&buffer, componentCount);
+    return data;
+}
@@ -0,0 +1,49 @@
+#ifndef DATASETGENERATOR_H
+#define DATASETGENERATOR_H
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief 可复现的压测数据生成器
+ * 生成设计器场景JSON、变量配置XML和组件库XML，
+ * 格式分别与MainWindow::saveToFile、XmlConfig::saveConfig、
+ * ComponentDesigner::saveComponentToLibrary的输出一致。
+ * 采用流式写出，百万级的变量也不需要在内存中构造整棵文档树。
+ * 相同的种子和参数总是生成相同的内容，三种文件各自使用独立的随机序列
+ */
+class DatasetGenerator
+{
+public:
+    explicit DatasetGenerator(quint32 seed = 1);
+
+    /**
+     * @brief 生成场景
+     * 组件类型随机（数值显示、矩形、椭圆），组件ID为 item_<序号>，
+     * 数值显示绑定 [0, addressCount) 内的随机地址
+     */
+    bool writeScene(QIODevice *device, int itemCount, int addressCount) const;
+
+    /**
+     * @brief 生成变量配置
+     * 变量名为 var_<序号>，地址为序号，bindingCount个绑定指向随机变量
+     */
+    bool writeVariableConfig(QIODevice *device, int variableCount, int bindingCount) const;
+
+    /**
+     * @brief 生成组件库
+     * 组件名为 C<序号>，每个组件带若干矩形和椭圆以及Base64编码的PNG预览图
+     */
+    bool writeComponentLibrary(QIODevice *device, int componentCount) const;
+
+    // 生成到内存
+    QByteArray scene(int itemCount, int addressCount) const;
+    QByteArray variableConfig(int variableCount, int bindingCount) const;
+    QByteArray componentLibrary(int componentCount) const;
+
+private:
+    quint32 m_seed;
+};
+
+#endif // DATASETGENERATOR_H
@@ -0,0 +1,96 @@
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QSaveFile>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDebug>
+#include <functional>
+#include "datasetgenerator.h"
+
+namespace {
+
+// 生成一个文件，写完后再替换，中途失败不会留下半个文件
+bool generate(const QString &fileName, const std::function<bool(QIODevice *)> &write)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || !write(&file) || !file.commit()) {
+        qWarning() << "Failed to write" << fileName << file.errorString();
+        return false;
+    }
+    qInfo("%s: %lld bytes in %.1f s", qPrintable(fileName),
+          QFileInfo(fileName).size(), timer.elapsed() / 1000.0);
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    // 预览图需要绘制，使用offscreen平台以便在没有显示器的机器上运行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication a(argc, argv);
+
+    // 解析命令行参数
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("生成压测用的场景、变量配置和组件库"));
+    parser.addHelpOption();
+    QCommandLineOption seedOption("seed", QObject::tr("随机数种子"), "seed", "1");
+    parser.addOption(seedOption);
+    QCommandLineOption sceneOption("scene", QObject::tr("输出的场景JSON文件"), "file");
+    parser.addOption(sceneOption);
+    QCommandLineOption itemsOption("items", QObject::tr("场景中的组件个数"), "count", "10000");
+    parser.addOption(itemsOption);
+    QCommandLineOption addressesOption("addresses",
+        QObject::tr("场景中数值显示绑定的地址个数，默认与组件个数相同"), "count");
+    parser.addOption(addressesOption);
+    QCommandLineOption configOption("config", QObject::tr("输出的变量配置XML文件"), "file");
+    parser.addOption(configOption);
+    QCommandLineOption variablesOption("variables", QObject::tr("变量个数"), "count", "1000000");
+    parser.addOption(variablesOption);
+    QCommandLineOption bindingsOption("bindings",
+        QObject::tr("配置中的绑定个数，默认为变量个数的十分之一"), "count");
+    parser.addOption(bindingsOption);
+    QCommandLineOption libraryOption("library", QObject::tr("输出的组件库XML文件"), "file");
+    parser.addOption(libraryOption);
+    QCommandLineOption componentsOption("components", QObject::tr("组件库中的组件个数"), "count", "1000");
+    parser.addOption(componentsOption);
+    parser.process(a);
+
+    if (!parser.isSet(sceneOption) && !parser.isSet(configOption) && !parser.isSet(libraryOption)) {
+        qWarning() << "Nothing to generate, specify --scene, --config or --library";
+        parser.showHelp(1);
+    }
+
+    DatasetGenerator generator(parser.value(seedOption).toUInt());
+    bool ok = true;
+
+    if (parser.isSet(sceneOption)) {
+        int items = qMax(0, parser.value(itemsOption).toInt());
+        int addresses = parser.isSet(addressesOption) ? parser.value(addressesOption).toInt() : items;
+        ok &= generate(parser.value(sceneOption), [&](QIODevice *device) {
+            return generator.writeScene(device, items, addresses);
+        });
+    }
+
+    if (parser.isSet(configOption)) {
+        int variables = qMax(0, parser.value(variablesOption).toInt());
+        int bindings = parser.isSet(bindingsOption) ? parser.value(bindingsOption).toInt() : variables / 10;
+        ok &= generate(parser.value(configOption), [&](QIODevice *device) {
+            return generator.writeVariableConfig(device, variables, qMax(0, bindings));
+        });
+    }
+
+    if (parser.isSet(libraryOption)) {
+        int components = qMax(0, parser.value(componentsOption).toInt());
+        ok &= generate(parser.value(libraryOption), [&](QIODevice *device) {
+            return generator.writeComponentLibrary(device, components);
+        });
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+#include "framebench.h"
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QProcess>
+#include <QTimer>
+#include <QFile>
+#include <algorithm>
+#include "runtimeviewer.h"
+#include "processstats.h"
+#include "datasetgenerator.h"
+
+namespace {
+
+double percentile(const QVector<qint64> &sorted, double fraction)
+{
+    if (sorted.isEmpty()) {
+        return 0;
+    }
+    int index = qBound(0, int(fraction * sorted.size()), sorted.size() - 1);
+    return sorted.at(index) / 1e6;
+}
+
+// 场景中数值显示绑定的地址个数，负载生成器使用相同的地址范围
+int addressCount(int items)
+{
+    return qMax(1, items / 3);
+}
+
+}
+
+FrameBenchApplication::FrameBenchApplication(int &argc, char **argv)
+    : QApplication(argc, argv)
+    , m_watched(nullptr)
+{
+}
+
+bool FrameBenchApplication::notify(QObject *receiver, QEvent *event)
+{
+    if (event->type() != QEvent::Paint || receiver != m_watched) {
+        return QApplication::notify(receiver, event);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    bool result = QApplication::notify(receiver, event);
+    m_paintTimes.append(timer.nsecsElapsed());
+    return result;
+}
+
+FrameBench::FrameBench(FrameBenchApplication *app, const Config &config)
+    : m_app(app)
+    , m_config(config)
+{
+}
+
+QString FrameBench::sceneFile(int items)
+{
+    QString fileName = m_dir.filePath(QString("scene_%1.json").arg(items));
+    if (!QFile::exists(fileName)) {
+        QFile file(fileName);
+        if (file.open(QIODevice::WriteOnly)) {
+            DatasetGenerator(m_config.seed).writeScene(&file, items, addressCount(items));
+        }
+    }
+    return fileName;
+}
+
+void FrameBench::wait(int msec)
+{
+    QEventLoop loop;
+    QTimer::singleShot(msec, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+bool FrameBench::run(int items, int updatesPerSecond, FrameBenchResult *result)
+{
+    if (!m_dir.isValid()) {
+        m_error = QObject::tr("无法创建临时目录");
+        return false;
+    }
+    QString scene = sceneFile(items);
+
+    // 负载生成器在独立进程中运行，CPU时间只统计运行时本身
+    QProcess generator;
+    generator.setProcessChannelMode(QProcess::MergedChannels);
+    int batch = qMax(1, m_config.batchSize);
+    QStringList args;
+    args << "--port" << QString::number(m_config.port)
+         << "--rate" << QString::number(double(updatesPerSecond) / batch)
+         << "--batch" << QString::number(batch)
+         << "--addresses" << QString::number(addressCount(items))
+         << "--seed" << QString::number(m_config.seed)
+         << "--wait-subscriber";
+    generator.start(m_config.mqttload, args);
+    if (!generator.waitForStarted()) {
+        m_error = QObject::tr("无法启动%1：%2").arg(m_config.mqttload, generator.errorString());
+        return false;
+    }
+
+    // 等待服务器开始监听
+    QByteArray output;
+    QElapsedTimer startup;
+    startup.start();
+    while (!output.contains("listening") && startup.elapsed() < 5000) {
+        generator.waitForReadyRead(100);
+        output += generator.readAll();
+    }
+    if (!output.contains("listening")) {
+        m_error = QObject::tr("MQTT服务器未启动：%1").arg(QString::fromLocal8Bit(output));
+        generator.kill();
+        generator.waitForFinished();
+        return false;
+    }
+    // 之后的输出不再需要
+    QObject::connect(&generator, &QProcess::readyRead, [&generator]() { generator.readAll(); });
+
+    RuntimeOptions options = m_config.options;
+    options.brokerHost = "127.0.0.1";
+    options.brokerPort = m_config.port;
+    options.headless = false;
+
+    bool ok = true;
+    {
+        RuntimeViewer viewer(scene, options);
+        viewer.resize(m_config.windowSize);
+        viewer.show();
+        m_app->setWatched(viewer.view()->viewport());
+
+        wait(m_config.warmup * 1000);
+
+        // 预热结束后清零，开始测量
+        m_app->paintTimes().clear();
+        qint64 cpuStart = ProcessStats::cpuTimeUs();
+        qint64 messagesStart = viewer.receivedMessages();
+        qint64 samplesStart = viewer.receivedSamples();
+        QElapsedTimer clock;
+        clock.start();
+
+        wait(m_config.duration * 1000);
+
+        double seconds = clock.nsecsElapsed() / 1e9;
+        qint64 cpu = ProcessStats::cpuTimeUs() - cpuStart;
+        QVector<qint64> paints = m_app->paintTimes();
+        m_app->setWatched(nullptr);
+        std::sort(paints.begin(), paints.end());
+
+        result->items = items;
+        result->updatesPerSecond = updatesPerSecond;
+        result->seconds = seconds;
+        result->frames = paints.size();
+        result->messages = viewer.receivedMessages() - messagesStart;
+        result->samples = viewer.receivedSamples() - samplesStart;
+        result->paintP50 = percentile(paints, 0.50);
+        result->paintP90 = percentile(paints, 0.90);
+        result->paintP99 = percentile(paints, 0.99);
+        result->paintMax = paints.isEmpty() ? 0 : paints.last() / 1e6;
+        result->cpuPerUpdateUs = result->samples > 0 ? double(cpu) / result->samples : 0;
+        result->cpuPercent = cpu / (seconds * 1e4);
+        result->residentBytes = ProcessStats::residentBytes();
+
+        if (result->samples == 0) {
+            m_error = QObject::tr("测量期间没有收到数据");
+            ok = false;
+        }
+    }
+
+    generator.kill();
+    generator.waitForFinished();
+    return ok;
+}
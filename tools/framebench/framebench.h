@@ -0,0 +1,87 @@
+#ifndef FRAMEBENCH_H
+#define FRAMEBENCH_H
+
+#include <QApplication>
+#include <QTemporaryDir>
+#include <QVector>
+#include <QSize>
+#include "runtimeoptions.h"
+
+/**
+ * @brief 记录视口绘制耗时的应用程序对象
+ * 在事件分发处计时，包含QGraphicsView处理一次绘制事件的全部时间
+ */
+class FrameBenchApplication : public QApplication
+{
+public:
+    FrameBenchApplication(int &argc, char **argv);
+
+    bool notify(QObject *receiver, QEvent *event) override;
+
+    // 只统计此对象收到的绘制事件
+    void setWatched(QObject *watched) { m_watched = watched; }
+
+    // 每次绘制的耗时（纳秒）
+    QVector<qint64> &paintTimes() { return m_paintTimes; }
+
+private:
+    QObject *m_watched;
+    QVector<qint64> m_paintTimes;
+};
+
+/**
+ * @brief 一组参数的压测结果
+ */
+struct FrameBenchResult {
+    int items = 0;                  // 场景组件个数
+    int updatesPerSecond = 0;       // 设定的数据点速率
+    double seconds = 0;             // 测量时长
+    qint64 frames = 0;              // 绘制次数
+    qint64 messages = 0;            // 收到的报文数
+    qint64 samples = 0;             // 收到的数据点数
+    double paintP50 = 0;            // 绘制耗时百分位（毫秒）
+    double paintP90 = 0;
+    double paintP99 = 0;
+    double paintMax = 0;
+    double cpuPerUpdateUs = 0;      // 每个数据点的CPU时间（微秒）
+    double cpuPercent = 0;          // CPU占用（单核百分比）
+    qint64 residentBytes = 0;       // 测量结束时的常驻内存
+};
+
+/**
+ * @brief 运行时端到端帧率压测
+ * 按给定组件数生成场景并载入RuntimeViewer，由独立的mqttload进程经本地MQTT
+ * 服务器按给定速率推送数据，统计帧率、绘制耗时、每个数据点的CPU时间和内存
+ */
+class FrameBench
+{
+public:
+    struct Config {
+        QString mqttload;           // mqttload程序路径
+        quint16 port = 18830;       // 本地MQTT服务器端口
+        int batchSize = 50;         // 每条报文的数据点个数
+        int warmup = 2;             // 预热时间（秒）
+        int duration = 10;          // 每组参数的测量时间（秒）
+        QSize windowSize = QSize(1280, 800);    // 窗口大小
+        quint32 seed = 1;           // 场景和负载的随机数种子
+        RuntimeOptions options;     // 运行时选项（采集线程、帧率上限等）
+    };
+
+    FrameBench(FrameBenchApplication *app, const Config &config);
+
+    // 运行一组参数，失败时返回false
+    bool run(int items, int updatesPerSecond, FrameBenchResult *result);
+
+    QString errorString() const { return m_error; }
+
+private:
+    QString sceneFile(int items);
+    void wait(int msec);
+
+    FrameBenchApplication *m_app;
+    Config m_config;
+    QTemporaryDir m_dir;
+    QString m_error;
+};
+
+#endif // FRAMEBENCH_H
@@ -0,0 +1,83 @@
+QT       += core gui widgets mqtt network
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = framebench
+TEMPLATE = app
+
+# 运行时代码直接编译进压测程序
+RUNTIME_DIR = $$PWD/../../runtime
+DATAGEN_DIR = $$PWD/../datagen
+COMMON_DIR = $$PWD/../../common
+
+INCLUDEPATH += $$RUNTIME_DIR $$DATAGEN_DIR $$COMMON_DIR
+
+SOURCES += \
+    main.cpp \
+    framebench.cpp \
+    $$DATAGEN_DIR/datasetgenerator.cpp \
+    $$RUNTIME_DIR/runtimeviewer.cpp \
+    $$RUNTIME_DIR/datasource.cpp \
+    $$RUNTIME_DIR/mqttcomm.cpp \
+    $$RUNTIME_DIR/modbussource.cpp \
+    $$RUNTIME_DIR/jsonvaluedecoder.cpp \
+    $$RUNTIME_DIR/cborvaluedecoder.cpp \
+    $$RUNTIME_DIR/packedvaluedecoder.cpp \
+    $$RUNTIME_DIR/sparkplugdecoder.cpp \
+    $$RUNTIME_DIR/sparkplugencoder.cpp \
+    $$RUNTIME_DIR/tagtable.cpp \
+    $$RUNTIME_DIR/tagvalue.cpp \
+    $$RUNTIME_DIR/topictrie.cpp \
+    $$RUNTIME_DIR/subscriptionmanager.cpp \
+    $$RUNTIME_DIR/bindingtable.cpp \
+    $$RUNTIME_DIR/valuedisplayitem.cpp \
+    $$RUNTIME_DIR/scenefile.cpp \
+    $$RUNTIME_DIR/runtimeview.cpp \
+    $$RUNTIME_DIR/perfhud.cpp \
+    $$RUNTIME_DIR/latencyhistogram.cpp \
+    $$RUNTIME_DIR/latencytracker.cpp \
+    $$RUNTIME_DIR/metricsregistry.cpp \
+    $$RUNTIME_DIR/metricsserver.cpp \
+    $$COMMON_DIR/trace.cpp \
+    $$COMMON_DIR/logcategories.cpp \
+    $$RUNTIME_DIR/processstats.cpp
+
+HEADERS += \
+    framebench.h \
+    $$DATAGEN_DIR/datasetgenerator.h \
+    $$RUNTIME_DIR/runtimeviewer.h \
+    $$RUNTIME_DIR/datasource.h \
+    $$RUNTIME_DIR/mqttcomm.h \
+    $$RUNTIME_DIR/modbussource.h \
+    $$RUNTIME_DIR/valuesink.h \
+    $$RUNTIME_DIR/valuedecoder.h \
+    $$RUNTIME_DIR/jsonvaluedecoder.h \
+    $$RUNTIME_DIR/cborvaluedecoder.h \
+    $$RUNTIME_DIR/packedvaluedecoder.h \
+    $$RUNTIME_DIR/sparkplugdecoder.h \
+    $$RUNTIME_DIR/sparkplugencoder.h \
+    $$RUNTIME_DIR/tagtable.h \
+    $$RUNTIME_DIR/tagvalue.h \
+    $$RUNTIME_DIR/topictrie.h \
+    $$RUNTIME_DIR/subscriptionmanager.h \
+    $$RUNTIME_DIR/bindingtable.h \
+    $$RUNTIME_DIR/valuedisplayitem.h \
+    $$RUNTIME_DIR/samplering.h \
+    $$RUNTIME_DIR/runtimeoptions.h \
+    $$RUNTIME_DIR/scenefile.h \
+    $$RUNTIME_DIR/runtimeview.h \
+    $$RUNTIME_DIR/perfhud.h \
+    $$RUNTIME_DIR/latencyhistogram.h \
+    $$RUNTIME_DIR/latencytracker.h \
+    $$RUNTIME_DIR/metricsregistry.h \
+    $$RUNTIME_DIR/metricsserver.h \
+    $$COMMON_DIR/trace.h \
+    $$COMMON_DIR/logcategories.h \
+    $$RUNTIME_DIR/processstats.h
+
+win32 {
+    LIBS += -lpsapi
+}
+
+DEFINES += QT_DEPRECATED_WARNINGS
@@ -0,0 +1,154 @@
+#include <QCommandLineParser>
+#include <QStandardPaths>
+#include <QFileInfo>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include "framebench.h"
+
+namespace {
+
+QList<int> parseList(const QString &text)
+{
+    QList<int> values;
+    for (const QString &part : text.split(',', QString::SkipEmptyParts)) {
+        int value = part.trimmed().toInt();
+        if (value > 0) {
+            values.append(value);
+        }
+    }
+    return values;
+}
+
+// 默认在本程序旁边、构建目录中的相邻位置和PATH中查找mqttload
+QString findMqttload()
+{
+    QString dir = QCoreApplication::applicationDirPath();
+    for (const QString &candidate : { dir + "/mqttload", dir + "/../mqttload/mqttload",
+                                      dir + "/mqttload.exe", dir + "/../mqttload/mqttload.exe" }) {
+        if (QFileInfo(candidate).isExecutable()) {
+            return candidate;
+        }
+    }
+    return QStandardPaths::findExecutable("mqttload");
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    // 默认在offscreen平台上运行，构建机不需要显示器和GPU
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    FrameBenchApplication a(argc, argv);
+
+    // 解析命令行参数
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("运行时端到端帧率压测"));
+    parser.addHelpOption();
+    QCommandLineOption itemsOption("items", QObject::tr("场景组件个数列表"), "n,...", "1000,10000");
+    parser.addOption(itemsOption);
+    QCommandLineOption updatesOption("updates", QObject::tr("每秒数据点个数列表"), "m,...", "1000,10000,100000");
+    parser.addOption(updatesOption);
+    QCommandLineOption batchOption("batch", QObject::tr("每条报文的数据点个数"), "samples", "50");
+    parser.addOption(batchOption);
+    QCommandLineOption durationOption("duration", QObject::tr("每组参数的测量时间（秒）"), "seconds", "10");
+    parser.addOption(durationOption);
+    QCommandLineOption warmupOption("warmup", QObject::tr("预热时间（秒）"), "seconds", "2");
+    parser.addOption(warmupOption);
+    QCommandLineOption sizeOption("size", QObject::tr("窗口大小"), "WxH", "1280x800");
+    parser.addOption(sizeOption);
+    QCommandLineOption portOption("port", QObject::tr("本地MQTT服务器端口"), "port", "18830");
+    parser.addOption(portOption);
+    QCommandLineOption mqttloadOption("mqttload", QObject::tr("mqttload程序路径"), "path");
+    parser.addOption(mqttloadOption);
+    QCommandLineOption ingestThreadOption("ingest-thread", QObject::tr("运行时使用独立的采集线程"));
+    parser.addOption(ingestThreadOption);
+    QCommandLineOption maxFpsOption("max-fps", QObject::tr("运行时的最高帧率"), "fps", "60");
+    parser.addOption(maxFpsOption);
+    QCommandLineOption outputOption("output", QObject::tr("结果CSV文件"), "file");
+    parser.addOption(outputOption);
+    QCommandLineOption seedOption("seed", QObject::tr("随机数种子"), "seed", "1");
+    parser.addOption(seedOption);
+    parser.process(a);
+
+    FrameBench::Config config;
+    config.mqttload = parser.isSet(mqttloadOption) ? parser.value(mqttloadOption) : findMqttload();
+    if (config.mqttload.isEmpty()) {
+        qWarning() << "mqttload not found, use --mqttload";
+        return 1;
+    }
+    config.port = quint16(parser.value(portOption).toUInt());
+    config.batchSize = qMax(1, parser.value(batchOption).toInt());
+    config.duration = qMax(1, parser.value(durationOption).toInt());
+    config.warmup = qMax(0, parser.value(warmupOption).toInt());
+    config.seed = parser.value(seedOption).toUInt();
+    QStringList size = parser.value(sizeOption).split('x');
+    if (size.size() == 2 && size.at(0).toInt() > 0 && size.at(1).toInt() > 0) {
+        config.windowSize = QSize(size.at(0).toInt(), size.at(1).toInt());
+    }
+    config.options.ingestThread = parser.isSet(ingestThreadOption);
+    config.options.maxFps = qMax(1, parser.value(maxFpsOption).toInt());
+
+    QList<int> itemsList = parseList(parser.value(itemsOption));
+    QList<int> updatesList = parseList(parser.value(updatesOption));
+
+    QFile csvFile;
+    QTextStream csv;
+    if (parser.isSet(outputOption)) {
+        csvFile.setFileName(parser.value(outputOption));
+        if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qWarning() << "Cannot open" << csvFile.fileName() << csvFile.errorString();
+            return 1;
+        }
+        csv.setDevice(&csvFile);
+        csv << "items,updates_per_s,seconds,frames,fps,messages,samples,"
+               "paint_p50_ms,paint_p90_ms,paint_p99_ms,paint_max_ms,"
+               "cpu_us_per_update,cpu_percent,rss_mb\n";
+    }
+
+    QTextStream out(stdout);
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9\n")
+           .arg("items", 8).arg("updates/s", 10).arg("fps", 7).arg("samples/s", 10)
+           .arg("p50 ms", 8).arg("p99 ms", 8).arg("max ms", 8).arg("cpu us/upd", 10).arg("rss MB", 8);
+    out.flush();
+
+    FrameBench bench(&a, config);
+    int failures = 0;
+    for (int items : itemsList) {
+        for (int updates : updatesList) {
+            FrameBenchResult result;
+            if (!bench.run(items, updates, &result)) {
+                qWarning() << "items" << items << "updates" << updates << "failed:" << bench.errorString();
+                ++failures;
+                continue;
+            }
+
+            double fps = result.frames / result.seconds;
+            double rssMb = result.residentBytes / (1024.0 * 1024.0);
+            out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9\n")
+                   .arg(items, 8).arg(updates, 10)
+                   .arg(fps, 7, 'f', 1)
+                   .arg(result.samples / result.seconds, 10, 'f', 0)
+                   .arg(result.paintP50, 8, 'f', 2)
+                   .arg(result.paintP99, 8, 'f', 2)
+                   .arg(result.paintMax, 8, 'f', 2)
+                   .arg(result.cpuPerUpdateUs, 10, 'f', 2)
+                   .arg(rssMb, 8, 'f', 1);
+            out.flush();
+
+            if (csvFile.isOpen()) {
+                csv << items << ',' << updates << ',' << result.seconds << ','
+                    << result.frames << ',' << fps << ','
+                    << result.messages << ',' << result.samples << ','
+                    << result.paintP50 << ',' << result.paintP90 << ','
+                    << result.paintP99 << ',' << result.paintMax << ','
+                    << result.cpuPerUpdateUs << ',' << result.cpuPercent << ','
+                    << rssMb << '\n';
+                csv.flush();
+            }
+        }
+    }
+    return failures;
+}
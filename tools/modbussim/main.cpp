@@ -0,0 +1,93 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDebug>
+#include "modbusserver.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    // 解析命令行参数
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("运行时压测用的本地Modbus TCP从站模拟器"));
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", QObject::tr("监听端口"), "port", "5020");
+    parser.addOption(portOption);
+    QCommandLineOption registersOption("registers",
+        QObject::tr("保持寄存器和输入寄存器中周期变化的个数（从第一个寄存器开始）"), "count", "1000");
+    parser.addOption(registersOption);
+    QCommandLineOption intervalOption("update-interval",
+        QObject::tr("寄存器变化的间隔（毫秒），0表示不变化"), "ms", "100");
+    parser.addOption(intervalOption);
+    QCommandLineOption changeRatioOption("change-ratio",
+        QObject::tr("每次变化时寄存器的值改变的比例（0~1）"), "ratio", "0.1");
+    parser.addOption(changeRatioOption);
+    QCommandLineOption delayOption("response-delay",
+        QObject::tr("每个请求的应答延迟（毫秒），模拟现场设备的响应时间"), "ms", "0");
+    parser.addOption(delayOption);
+    QCommandLineOption durationOption("duration",
+        QObject::tr("持续时间（秒），0表示一直运行"), "seconds", "0");
+    parser.addOption(durationOption);
+    QCommandLineOption seedOption("seed", QObject::tr("随机数种子"), "seed", "1");
+    parser.addOption(seedOption);
+    parser.process(a);
+
+    ModbusServer server;
+    server.setResponseDelay(qMax(0, parser.value(delayOption).toInt()));
+    server.setSeed(parser.value(seedOption).toUInt());
+    quint16 port = quint16(parser.value(portOption).toUInt());
+    if (!server.listen(QHostAddress::Any, port)) {
+        qWarning() << "Failed to listen on port" << port << server.errorString();
+        return 1;
+    }
+    qInfo() << "Modbus TCP server listening on port" << server.serverPort();
+
+    QObject::connect(&server, &ModbusServer::clientConnected, [](const QString &peer) {
+        qInfo() << "Client connected:" << peer;
+    });
+    QObject::connect(&server, &ModbusServer::clientDisconnected, [](const QString &peer) {
+        qInfo() << "Client disconnected:" << peer;
+    });
+
+    // 先写入一次初值，再按间隔改变部分寄存器
+    int registers = qMax(0, parser.value(registersOption).toInt());
+    double changeRatio = qBound(0.0, parser.value(changeRatioOption).toDouble(), 1.0);
+    server.updateRegisters(registers, 1.0);
+    int interval = qMax(0, parser.value(intervalOption).toInt());
+    if (interval > 0 && registers > 0) {
+        QTimer *updateTimer = new QTimer(&a);
+        QObject::connect(updateTimer, &QTimer::timeout, [&server, registers, changeRatio]() {
+            server.updateRegisters(registers, changeRatio);
+        });
+        updateTimer->start(interval);
+    }
+
+    // 每秒输出一次应答速率
+    QElapsedTimer elapsed;
+    elapsed.start();
+    qint64 lastRequests = 0;
+    qint64 lastRegisters = 0;
+    QTimer *statsTimer = new QTimer(&a);
+    QObject::connect(statsTimer, &QTimer::timeout, [&]() {
+        qint64 requests = server.requests();
+        qint64 registersRead = server.registersRead();
+        if (requests != lastRequests) {
+            qInfo("t=%6.1fs clients=%d req/s=%lld registers/s=%lld exceptions=%lld",
+                  elapsed.elapsed() / 1000.0, server.clientCount(), requests - lastRequests,
+                  registersRead - lastRegisters, server.exceptions());
+        }
+        lastRequests = requests;
+        lastRegisters = registersRead;
+    });
+    statsTimer->start(1000);
+
+    int duration = qMax(0, parser.value(durationOption).toInt());
+    if (duration > 0) {
+        QTimer::singleShot(duration * 1000, &a, &QCoreApplication::quit);
+    }
+
+    return a.exec();
+}
@@ -0,0 +1,241 @@
+#include "modbusserver.h"
+#include <QTimer>
+#include <QDebug>
+
+namespace {
+// 功能码
+enum Function {
+    ReadHoldingRegisters = 3,
+    ReadInputRegisters = 4,
+    WriteSingleRegister = 6,
+    WriteMultipleRegisters = 16
+};
+
+// 异常码
+enum Exception {
+    IllegalFunction = 1,
+    IllegalDataAddress = 2,
+    IllegalDataValue = 3
+};
+
+const int kRegisterCount = 65536;       // 每类寄存器的个数
+const int kMaxReadRegisters = 125;      // 一次最多读出的寄存器个数
+const int kMaxWriteRegisters = 123;     // 一次最多写入的寄存器个数
+const int kHeaderSize = 7;              // MBAP报文头
+const int kMaxFrameLength = 254;        // 长度字段的上限
+
+inline int readWord(const uchar *data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+void appendWord(QByteArray *data, int value)
+{
+    data->append(char(value >> 8));
+    data->append(char(value & 0xff));
+}
+
+// 应答帧的MBAP报文头，长度字段为从站地址加PDU的长度
+QByteArray responseHeader(const uchar *request, int pduSize)
+{
+    QByteArray response;
+    response.reserve(kHeaderSize + pduSize);
+    response.append(reinterpret_cast<const char *>(request), 4);
+    appendWord(&response, 1 + pduSize);
+    response.append(char(request[6]));
+    return response;
+}
+}
+
+ModbusServer::ModbusServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_holding(kRegisterCount)
+    , m_input(kRegisterCount)
+    , m_responseDelay(0)
+    , m_random(1)
+    , m_requests(0)
+    , m_registersRead(0)
+    , m_exceptions(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &ModbusServer::acceptConnection);
+}
+
+ModbusServer::~ModbusServer()
+{
+    qDeleteAll(m_clients);
+}
+
+bool ModbusServer::listen(const QHostAddress &address, quint16 port)
+{
+    return m_server->listen(address, port);
+}
+
+void ModbusServer::updateRegisters(int count, double changeRatio)
+{
+    count = qBound(0, count, kRegisterCount);
+    for (int i = 0; i < count; ++i) {
+        if (m_random.generateDouble() < changeRatio) {
+            m_holding[i] = quint16(m_random.bounded(10000));
+        }
+        if (m_random.generateDouble() < changeRatio) {
+            m_input[i] = quint16(m_random.bounded(10000));
+        }
+    }
+}
+
+void ModbusServer::acceptConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        Client *client = new Client;
+        client->socket = socket;
+        client->peer = QString("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+        m_clients.append(client);
+
+        connect(socket, &QTcpSocket::readyRead, this, &ModbusServer::readClient);
+        connect(socket, &QTcpSocket::disconnected, this, &ModbusServer::dropClient);
+        emit clientConnected(client->peer);
+    }
+}
+
+void ModbusServer::readClient()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Client *client = findClient(socket);
+    if (!client) {
+        return;
+    }
+    client->buffer.append(socket->readAll());
+
+    // 逐个取出完整请求：MBAP报文头 + PDU，同一批请求的应答合并在一次写入中发出
+    const uchar *data = reinterpret_cast<const uchar *>(client->buffer.constData());
+    int size = client->buffer.size();
+    int pos = 0;
+    QByteArray responses;
+    while (size - pos >= kHeaderSize) {
+        const uchar *frame = data + pos;
+        int length = readWord(frame + 4);
+        if (readWord(frame + 2) != 0 || length < 2 || length > kMaxFrameLength) {
+            qWarning() << "Malformed Modbus TCP header from" << client->peer;
+            socket->abort();
+            return;
+        }
+        if (size - pos < 6 + length) {
+            break;
+        }
+        responses.append(processRequest(frame, 6 + length));
+        pos += 6 + length;
+    }
+    client->buffer.remove(0, pos);
+
+    if (responses.isEmpty()) {
+        return;
+    }
+    if (m_responseDelay > 0) {
+        // 延迟相同的定时器按启动顺序触发，应答顺序不变
+        QTimer::singleShot(m_responseDelay, socket, [socket, responses]() {
+            socket->write(responses);
+        });
+    } else {
+        socket->write(responses);
+    }
+}
+
+QByteArray ModbusServer::processRequest(const uchar *frame, int size)
+{
+    ++m_requests;
+    const uchar *pdu = frame + kHeaderSize;
+    int pduSize = size - kHeaderSize;
+    int function = pdu[0];
+
+    switch (function) {
+    case ReadHoldingRegisters:
+    case ReadInputRegisters: {
+        if (pduSize != 5) {
+            return exceptionResponse(frame, IllegalDataValue);
+        }
+        int start = readWord(pdu + 1);
+        int count = readWord(pdu + 3);
+        if (count < 1 || count > kMaxReadRegisters) {
+            return exceptionResponse(frame, IllegalDataValue);
+        }
+        if (start + count > kRegisterCount) {
+            return exceptionResponse(frame, IllegalDataAddress);
+        }
+        const QVector<quint16> &registers = function == ReadHoldingRegisters ? m_holding : m_input;
+        QByteArray response = responseHeader(frame, 2 + count * 2);
+        response.append(char(function));
+        response.append(char(count * 2));
+        for (int i = start; i < start + count; ++i) {
+            appendWord(&response, registers.at(i));
+        }
+        m_registersRead += count;
+        return response;
+    }
+    case WriteSingleRegister: {
+        if (pduSize != 5) {
+            return exceptionResponse(frame, IllegalDataValue);
+        }
+        m_holding[readWord(pdu + 1)] = quint16(readWord(pdu + 3));
+        // 应答与请求相同
+        return QByteArray(reinterpret_cast<const char *>(frame), size);
+    }
+    case WriteMultipleRegisters: {
+        if (pduSize < 6) {
+            return exceptionResponse(frame, IllegalDataValue);
+        }
+        int start = readWord(pdu + 1);
+        int count = readWord(pdu + 3);
+        if (count < 1 || count > kMaxWriteRegisters || pdu[5] != count * 2 || pduSize != 6 + count * 2) {
+            return exceptionResponse(frame, IllegalDataValue);
+        }
+        if (start + count > kRegisterCount) {
+            return exceptionResponse(frame, IllegalDataAddress);
+        }
+        for (int i = 0; i < count; ++i) {
+            m_holding[start + i] = quint16(readWord(pdu + 6 + i * 2));
+        }
+        QByteArray response = responseHeader(frame, 5);
+        response.append(char(function));
+        appendWord(&response, start);
+        appendWord(&response, count);
+        return response;
+    }
+    default:
+        return exceptionResponse(frame, IllegalFunction);
+    }
+}
+
+QByteArray ModbusServer::exceptionResponse(const uchar *frame, int code)
+{
+    ++m_exceptions;
+    QByteArray response = responseHeader(frame, 2);
+    response.append(char(frame[kHeaderSize] | 0x80));
+    response.append(char(code));
+    return response;
+}
+
+void ModbusServer::dropClient()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Client *client = findClient(socket);
+    if (!client) {
+        return;
+    }
+    m_clients.removeOne(client);
+    emit clientDisconnected(client->peer);
+    socket->deleteLater();
+    delete client;
+}
+
+ModbusServer::Client *ModbusServer::findClient(QTcpSocket *socket)
+{
+    for (Client *client : m_clients) {
+        if (client->socket == socket) {
+            return client;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,79 @@
+#ifndef MODBUSSERVER_H
+#define MODBUSSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QVector>
+#include <QRandomGenerator>
+
+/**
+ * @brief 最小的本地Modbus TCP从站
+ * 只实现读保持寄存器（03）、读输入寄存器（04）、写单个寄存器（06）和写多个寄存器（16），
+ * 两类寄存器各65536个，不区分从站地址。同一连接上的多个请求按到达顺序逐个应答，
+ * 可以设置应答延迟模拟现场设备的响应时间，用于离线压测运行时的Modbus轮询
+ */
+class ModbusServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ModbusServer(QObject *parent = nullptr);
+    ~ModbusServer();
+
+    // 开始监听
+    bool listen(const QHostAddress &address, quint16 port);
+    QString errorString() const { return m_server->errorString(); }
+    quint16 serverPort() const { return m_server->serverPort(); }
+
+    // 每个请求的应答延迟（毫秒），0表示立即应答
+    void setResponseDelay(int delay) { m_responseDelay = delay; }
+
+    // 寄存器变化用的随机数种子
+    void setSeed(quint32 seed) { m_random.seed(seed); }
+
+    // 改写两类寄存器的前count个中changeRatio比例的值
+    void updateRegisters(int count, double changeRatio);
+
+    // 连接的客户端个数
+    int clientCount() const { return m_clients.size(); }
+
+    // 累计应答的请求数、读出的寄存器数和异常应答数
+    qint64 requests() const { return m_requests; }
+    qint64 registersRead() const { return m_registersRead; }
+    qint64 exceptions() const { return m_exceptions; }
+
+signals:
+    void clientConnected(const QString &peer);
+    void clientDisconnected(const QString &peer);
+
+private slots:
+    void acceptConnection();
+    void readClient();
+    void dropClient();
+
+private:
+    struct Client {
+        QTcpSocket *socket;
+        QByteArray buffer;          // 未处理的接收数据
+        QString peer;               // 对端地址，用于日志
+    };
+
+    Client *findClient(QTcpSocket *socket);
+
+    // 处理一个完整的请求帧，返回应答帧
+    QByteArray processRequest(const uchar *frame, int size);
+    QByteArray exceptionResponse(const uchar *frame, int code);
+
+    QTcpServer *m_server;
+    QVector<Client *> m_clients;
+    QVector<quint16> m_holding;     // 保持寄存器
+    QVector<quint16> m_input;       // 输入寄存器
+    int m_responseDelay;            // 应答延迟（毫秒）
+    QRandomGenerator m_random;      // 寄存器变化用的随机数
+    qint64 m_requests;
+    qint64 m_registersRead;
+    qint64 m_exceptions;
+};
+
+#endif // MODBUSSERVER_H
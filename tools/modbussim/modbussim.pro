@@ -0,0 +1,24 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = modbussim
+TEMPLATE = app
+
+SOURCES += \
+    main.cpp \
+    modbusserver.cpp
+
+HEADERS += \
+    modbusserver.h
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,216 @@
+#include "loadgenerator.h"
+#include "minibroker.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+#include "sparkplugencoder.h"
+
+namespace {
+const int kTickInterval = 1;        // 发布定时器间隔（毫秒）
+const int kMaxBurst = 10000;        // 落后时每次最多补发的消息数
+const int kPackedHeaderSize = 20;   // 定长记录报文头大小
+const int kPackedRecordSize = 12;   // 每条记录的大小
+}
+
+LoadGenerator::LoadGenerator(MiniBroker *broker, const LoadProfile &profile, QObject *parent)
+    : QObject(parent)
+    , m_broker(broker)
+    , m_profile(profile)
+    , m_random(profile.seed)
+    , m_tickTimer(new QTimer(this))
+    , m_reportTimer(new QTimer(this))
+    , m_values(qMax(1, profile.addressCount), 0.0)
+    , m_sequence(0)
+    , m_sent(0)
+    , m_delivered(0)
+    , m_samples(0)
+    , m_bytes(0)
+    , m_lastDelivered(0)
+    , m_lastSamples(0)
+    , m_lastBytes(0)
+    , m_lastReport(0)
+{
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    m_tickTimer->setInterval(kTickInterval);
+    connect(m_tickTimer, &QTimer::timeout, this, &LoadGenerator::tick);
+
+    // 预留报文缓冲区；buildMessage返回引用，MiniBroker::publish只复制内容，
+    // 缓冲区不会被共享，每条消息复用同一块内存
+    m_message.reserve(32 + profile.batchSize * 40);
+
+    m_reportTimer->setInterval(1000);
+    connect(m_reportTimer, &QTimer::timeout, this, &LoadGenerator::report);
+
+    // Sparkplug B：发布主题为NDATA，同一节点的NBIRTH和NCMD只差消息类型一级
+    if (m_profile.format == LoadProfile::Sparkplug) {
+        m_birthTopic = m_profile.topic;
+        m_birthTopic.replace("/NDATA/", "/NBIRTH/");
+        m_commandTopic = m_profile.topic;
+        m_commandTopic.replace("/NDATA/", "/NCMD/");
+        connect(m_broker, &MiniBroker::messagePublished, this, &LoadGenerator::handleCommand);
+    }
+}
+
+void LoadGenerator::start()
+{
+    qInfo("Publishing %s: %.1f msg/s, %d samples/msg, %d addresses, change ratio %.2f",
+          m_profile.topic.constData(), m_profile.rate, m_profile.batchSize,
+          m_profile.addressCount, m_profile.changeRatio);
+
+    if (m_profile.format == LoadProfile::Sparkplug) {
+        publishBirth();
+    }
+
+    m_clock.start();
+    m_tickTimer->start();
+    m_reportTimer->start();
+}
+
+void LoadGenerator::tick()
+{
+    qint64 elapsed = m_clock.nsecsElapsed();
+    if (m_profile.duration > 0 && elapsed >= qint64(m_profile.duration) * 1000000000) {
+        m_tickTimer->stop();
+        m_reportTimer->stop();
+        report();
+        emit finished();
+        return;
+    }
+
+    // 按开始以来的时间计算应发的消息数，定时器抖动时补发，平均速率不漂移
+    qint64 due = qint64(elapsed / 1e9 * m_profile.rate);
+    int burst = int(qMin<qint64>(due - m_sent, kMaxBurst));
+    for (int i = 0; i < burst; ++i) {
+        const QByteArray &message = buildMessage();
+        ++m_sent;
+        int receivers = m_broker->publish(m_profile.topic, message);
+        if (receivers > 0) {
+            ++m_delivered;
+            m_samples += m_profile.batchSize;
+            m_bytes += qint64(message.size()) * receivers;
+        }
+    }
+    if (due - m_sent > 0) {
+        // 生成速度跟不上时丢弃积压，避免统计中的速率失真
+        m_sent = due;
+    }
+}
+
+void LoadGenerator::report()
+{
+    qint64 now = m_clock.elapsed();
+    double seconds = qMax<qint64>(1, now - m_lastReport) / 1000.0;
+    qInfo("t=%6.1fs clients=%d msg/s=%.0f samples/s=%.0f MB/s=%.2f pending=%lld",
+          now / 1000.0, m_broker->clientCount(),
+          (m_delivered - m_lastDelivered) / seconds,
+          (m_samples - m_lastSamples) / seconds,
+          (m_bytes - m_lastBytes) / seconds / (1024 * 1024),
+          m_broker->maxPendingBytes());
+
+    m_lastDelivered = m_delivered;
+    m_lastSamples = m_samples;
+    m_lastBytes = m_bytes;
+    m_lastReport = now;
+}
+
+const QByteArray &LoadGenerator::buildMessage()
+{
+    // 时间戳用毫秒数，便于订阅方计算端到端延迟
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    m_message.resize(0);
+    SparkplugEncoder sparkplug(&m_message);
+    switch (m_profile.format) {
+    case LoadProfile::Packed: {
+        // 报文头：魔数、版本1、保留字段，记录个数和时间戳（小端序）
+        m_message.resize(kPackedHeaderSize);
+        uchar *header = reinterpret_cast<uchar *>(m_message.data());
+        memcpy(header, "SCPK", 4);
+        header[4] = 1;
+        header[5] = 0;
+        qToLittleEndian<quint16>(0, header + 6);
+        qToLittleEndian<quint32>(quint32(m_profile.batchSize), header + 8);
+        qToLittleEndian<qint64>(timestamp, header + 12);
+        break;
+    }
+    case LoadProfile::Sparkplug:
+        sparkplug.addTimestamp(quint64(timestamp));
+        break;
+    case LoadProfile::Json:
+        m_message.append("{\"timestamp\":\"");
+        m_message.append(QByteArray::number(timestamp));
+        m_message.append("\",\"body\":[");
+        break;
+    }
+
+    int addressCount = m_values.size();
+    for (int i = 0; i < m_profile.batchSize; ++i) {
+        int index = int(m_random.bounded(addressCount));
+
+        // 按变化比例决定是否产生新值，否则重复上次的值
+        if (m_random.generateDouble() < m_profile.changeRatio) {
+            m_values[index] = double(m_random.bounded(1000000)) / 100.0;
+        }
+
+        if (m_profile.format == LoadProfile::Packed) {
+            appendPacked(m_profile.firstAddress + index, m_values.at(index));
+            continue;
+        }
+        if (m_profile.format == LoadProfile::Sparkplug) {
+            // DATA中只按别名（地址的序号）
+            sparkplug.addDoubleMetric(QByteArray(), quint64(index), m_values.at(index));
+            continue;
+        }
+        if (i > 0) {
+            m_message.append(',');
+        }
+        m_message.append("{\"addr\":");
+        m_message.append(QByteArray::number(m_profile.firstAddress + index));
+        m_message.append(",\"val\":");
+        m_message.append(QByteArray::number(m_values.at(index), 'f', 2));
+        m_message.append('}');
+    }
+
+    if (m_profile.format == LoadProfile::Json) {
+        m_message.append("]}");
+    } else if (m_profile.format == LoadProfile::Sparkplug) {
+        sparkplug.addSequence(m_sequence++);
+    }
+    return m_message;
+}
+
+void LoadGenerator::appendPacked(int addr, double value)
+{
+    // 每条记录：quint32 地址 + float64 数值
+    uchar record[kPackedRecordSize];
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint32>(quint32(addr), record);
+    qToLittleEndian<quint64>(bits, record + 4);
+    m_message.append(reinterpret_cast<const char *>(record), kPackedRecordSize);
+}
+
+void LoadGenerator::publishBirth()
+{
+    // NBIRTH带全部指标的当前值，序号从0重新开始
+    // 指标名称为地址，别名为地址的序号
+    QByteArray birth;
+    SparkplugEncoder encoder(&birth);
+    encoder.addTimestamp(quint64(QDateTime::currentMSecsSinceEpoch()));
+    for (int index = 0; index < m_values.size(); ++index) {
+        encoder.addDoubleMetric(QByteArray::number(m_profile.firstAddress + index), quint64(index), m_values.at(index));
+    }
+    encoder.addSequence(0);
+    m_sequence = 1;
+
+    int receivers = m_broker->publish(m_birthTopic, birth);
+    qInfo("Published %s: %d metrics, %d receivers", m_birthTopic.constData(), m_values.size(), receivers);
+}
+
+void LoadGenerator::handleCommand(const QByteArray &topic, const QByteArray &payload)
+{
+    if (topic == m_commandTopic && payload.contains("Node Control/Rebirth")) {
+        qInfo("Rebirth requested on %s", topic.constData());
+        publishBirth();
+    }
+}
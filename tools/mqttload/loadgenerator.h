@@ -0,0 +1,86 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+
+class MiniBroker;
+
+/**
+ * @brief 负载参数
+ */
+struct LoadProfile {
+    // 报文格式
+    enum Format {
+        Json,       // {timestamp, body:[{addr,val}]}
+        Packed,     // 定长记录（见runtime的PackedValueDecoder）
+        Sparkplug   // Sparkplug B，主题为NDATA，先发布NBIRTH，之后按别名发布
+    };
+
+    QByteArray topic = "scada/values";  // 发布的主题
+    double rate = 100;              // 每秒消息数
+    int batchSize = 10;             // 每条消息的数据点个数
+    int addressCount = 1000;        // 地址个数（从firstAddress开始连续编号）
+    int firstAddress = 0;           // 第一个地址
+    double changeRatio = 1.0;       // 数据点的值与上次不同的比例（0~1）
+    int duration = 0;               // 持续时间（秒），0表示一直运行
+    quint32 seed = 1;               // 随机数种子，保证多次压测的数据相同
+    Format format = Json;           // 报文格式
+};
+
+/**
+ * @brief 合成负载生成器
+ * 按设定速率生成 {timestamp, body:[{addr,val}]} 报文（JSON、定长记录或Sparkplug B），
+ * 通过进程内的MiniBroker直接投递给订阅者，并每秒输出一次统计
+ */
+class LoadGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    LoadGenerator(MiniBroker *broker, const LoadProfile &profile, QObject *parent = nullptr);
+
+    // 开始发布（在有订阅者之前生成的消息会被丢弃，不计入统计）
+    void start();
+
+signals:
+    // 达到持续时间后发出
+    void finished();
+
+private slots:
+    void tick();
+    void report();
+
+    // Sparkplug B：收到本节点的NCMD时重新发布NBIRTH
+    void handleCommand(const QByteArray &topic, const QByteArray &payload);
+
+private:
+    // 生成下一条报文，返回的引用在下次调用前有效
+    const QByteArray &buildMessage();
+    void appendPacked(int addr, double value);
+    void publishBirth();
+
+    MiniBroker *m_broker;
+    LoadProfile m_profile;
+    QRandomGenerator m_random;
+    QTimer *m_tickTimer;            // 发布定时器
+    QTimer *m_reportTimer;          // 统计输出定时器
+    QElapsedTimer m_clock;          // 从开始发布起的时间
+    QVector<double> m_values;       // 每个地址上次发布的值
+    QByteArray m_message;           // 复用的报文缓冲区
+    QByteArray m_birthTopic;        // Sparkplug B的NBIRTH主题
+    QByteArray m_commandTopic;      // Sparkplug B的NCMD主题
+    quint8 m_sequence;              // Sparkplug B报文序号（0~255循环）
+    qint64 m_sent;                  // 已发布的消息数（包括没有订阅者的）
+    qint64 m_delivered;             // 实际投递的消息数
+    qint64 m_samples;               // 投递的数据点数
+    qint64 m_bytes;                 // 投递的报文字节数
+    qint64 m_lastDelivered;         // 上次统计时的投递消息数
+    qint64 m_lastSamples;           // 上次统计时的投递数据点数
+    qint64 m_lastBytes;             // 上次统计时的投递字节数
+    qint64 m_lastReport;            // 上次统计的时间（毫秒）
+};
+
+#endif // LOADGENERATOR_H
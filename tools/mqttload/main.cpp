@@ -0,0 +1,110 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QHostAddress>
+#include <QTimer>
+#include <QDebug>
+#include "minibroker.h"
+#include "loadgenerator.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    // 解析命令行参数
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("运行时压测用的本地MQTT服务器和负载生成器"));
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", QObject::tr("监听端口"), "port", "1883");
+    parser.addOption(portOption);
+    QCommandLineOption brokerOnlyOption("broker-only",
+        QObject::tr("只作为MQTT服务器运行，不生成负载"));
+    parser.addOption(brokerOnlyOption);
+    QCommandLineOption topicOption("topic", QObject::tr("发布的主题"), "topic", "scada/values");
+    parser.addOption(topicOption);
+    QCommandLineOption rateOption("rate", QObject::tr("每秒消息数"), "msgs", "100");
+    parser.addOption(rateOption);
+    QCommandLineOption batchOption("batch", QObject::tr("每条消息的数据点个数"), "samples", "10");
+    parser.addOption(batchOption);
+    QCommandLineOption addressesOption("addresses", QObject::tr("地址个数"), "count", "1000");
+    parser.addOption(addressesOption);
+    QCommandLineOption firstAddressOption("first-address", QObject::tr("第一个地址"), "addr", "0");
+    parser.addOption(firstAddressOption);
+    QCommandLineOption changeRatioOption("change-ratio",
+        QObject::tr("数据点的值与上次不同的比例（0~1）"), "ratio", "1.0");
+    parser.addOption(changeRatioOption);
+    QCommandLineOption durationOption("duration",
+        QObject::tr("持续时间（秒），0表示一直运行"), "seconds", "0");
+    parser.addOption(durationOption);
+    QCommandLineOption seedOption("seed", QObject::tr("随机数种子"), "seed", "1");
+    parser.addOption(seedOption);
+    QCommandLineOption waitOption("wait-subscriber",
+        QObject::tr("等到主题有订阅者后再开始发布"));
+    parser.addOption(waitOption);
+    QCommandLineOption formatOption("format",
+        QObject::tr("报文格式：json、packed（定长记录）或sparkplug（Sparkplug B，主题须为NDATA主题）"),
+        "format", "json");
+    parser.addOption(formatOption);
+    parser.process(a);
+
+    MiniBroker broker;
+    quint16 port = quint16(parser.value(portOption).toUInt());
+    if (!broker.listen(QHostAddress::Any, port)) {
+        qWarning() << "Failed to listen on port" << port << broker.errorString();
+        return 1;
+    }
+    qInfo() << "MQTT broker listening on port" << broker.serverPort();
+
+    QObject::connect(&broker, &MiniBroker::clientConnected, [](const QString &clientId) {
+        qInfo() << "Client connected:" << clientId;
+    });
+    QObject::connect(&broker, &MiniBroker::clientDisconnected, [](const QString &clientId) {
+        qInfo() << "Client disconnected:" << clientId;
+    });
+
+    if (parser.isSet(brokerOnlyOption)) {
+        return a.exec();
+    }
+
+    LoadProfile profile;
+    profile.topic = parser.value(topicOption).toUtf8();
+    profile.rate = qMax(0.0, parser.value(rateOption).toDouble());
+    profile.batchSize = qMax(1, parser.value(batchOption).toInt());
+    profile.addressCount = qMax(1, parser.value(addressesOption).toInt());
+    profile.firstAddress = parser.value(firstAddressOption).toInt();
+    profile.changeRatio = qBound(0.0, parser.value(changeRatioOption).toDouble(), 1.0);
+    profile.duration = qMax(0, parser.value(durationOption).toInt());
+    profile.seed = parser.value(seedOption).toUInt();
+    QString format = parser.value(formatOption);
+    if (format == "packed") {
+        profile.format = LoadProfile::Packed;
+    } else if (format == "sparkplug") {
+        profile.format = LoadProfile::Sparkplug;
+        if (!profile.topic.startsWith("spBv1.0/") || !profile.topic.contains("/NDATA/")) {
+            qWarning() << "Sparkplug B topic must be spBv1.0/<group>/NDATA/<edge node>:" << profile.topic;
+            return 1;
+        }
+    } else if (format != "json") {
+        qWarning() << "Unknown message format:" << format;
+        return 1;
+    }
+
+    LoadGenerator generator(&broker, profile);
+    QObject::connect(&generator, &LoadGenerator::finished, &a, &QCoreApplication::quit);
+
+    if (parser.isSet(waitOption)) {
+        // 订阅在连接之后才到达，定时检查是否已有订阅者
+        QTimer *waitTimer = new QTimer(&a);
+        QObject::connect(waitTimer, &QTimer::timeout, [&]() {
+            if (broker.hasSubscriber(profile.topic)) {
+                waitTimer->stop();
+                generator.start();
+            }
+        });
+        waitTimer->start(50);
+        qInfo() << "Waiting for a subscriber on" << profile.topic;
+    } else {
+        generator.start();
+    }
+
+    return a.exec();
+}
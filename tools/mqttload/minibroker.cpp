@@ -0,0 +1,364 @@
+#include "minibroker.h"
+#include <QDebug>
+
+namespace {
+// MQTT控制报文类型（固定报头高4位）
+enum PacketType {
+    Connect = 1,
+    ConnAck = 2,
+    Publish = 3,
+    Subscribe = 8,
+    SubAck = 9,
+    Unsubscribe = 10,
+    UnsubAck = 11,
+    PingReq = 12,
+    PingResp = 13,
+    Disconnect = 14
+};
+
+const int kMaxPacketSize = 16 * 1024 * 1024;    // 超过此长度的报文视为协议错误
+
+// 读取两字节长度前缀的字符串，失败时返回false
+bool readString(const QByteArray &data, int *pos, QByteArray *out)
+{
+    if (*pos + 2 > data.size()) {
+        return false;
+    }
+    int length = (quint8(data.at(*pos)) << 8) | quint8(data.at(*pos + 1));
+    if (*pos + 2 + length > data.size()) {
+        return false;
+    }
+    *out = data.mid(*pos + 2, length);
+    *pos += 2 + length;
+    return true;
+}
+
+void appendString(QByteArray *data, const QByteArray &value)
+{
+    data->append(char(value.size() >> 8));
+    data->append(char(value.size() & 0xff));
+    data->append(value);
+}
+}
+
+MiniBroker::MiniBroker(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MiniBroker::acceptConnection);
+}
+
+MiniBroker::~MiniBroker()
+{
+    qDeleteAll(m_clients);
+}
+
+bool MiniBroker::listen(const QHostAddress &address, quint16 port)
+{
+    return m_server->listen(address, port);
+}
+
+int MiniBroker::publish(const QByteArray &topic, const QByteArray &payload)
+{
+    // 报文只编码一次，所有订阅者共享
+    QByteArray body;
+    body.reserve(topic.size() + payload.size() + 2);
+    appendString(&body, topic);
+    body.append(payload);
+
+    int count = 0;
+    deliver(topic, encodePacket(Publish << 4, body), &count);
+    return count;
+}
+
+int MiniBroker::clientCount() const
+{
+    int count = 0;
+    for (const Client *client : m_clients) {
+        if (client->connected) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool MiniBroker::hasSubscriber(const QByteArray &topic) const
+{
+    QString topicName = QString::fromUtf8(topic);
+    for (const Client *client : m_clients) {
+        for (const QString &filter : client->filters) {
+            if (topicMatches(filter, topicName)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+qint64 MiniBroker::maxPendingBytes() const
+{
+    qint64 pending = 0;
+    for (const Client *client : m_clients) {
+        pending = qMax(pending, client->socket->bytesToWrite());
+    }
+    return pending;
+}
+
+void MiniBroker::acceptConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        Client *client = new Client;
+        client->socket = socket;
+        client->connected = false;
+        m_clients.append(client);
+
+        connect(socket, &QTcpSocket::readyRead, this, &MiniBroker::readClient);
+        connect(socket, &QTcpSocket::disconnected, this, &MiniBroker::dropClient);
+    }
+}
+
+void MiniBroker::readClient()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Client *client = findClient(socket);
+    if (!client) {
+        return;
+    }
+    client->buffer.append(socket->readAll());
+
+    // 逐个取出完整报文：固定报头 + 变长剩余长度 + 报文体
+    int pos = 0;
+    const QByteArray &buffer = client->buffer;
+    while (pos + 2 <= buffer.size()) {
+        quint8 header = quint8(buffer.at(pos));
+        int length = 0;
+        int multiplier = 1;
+        int index = pos + 1;
+        bool complete = false;
+        for (int i = 0; i < 4 && index < buffer.size(); ++i) {
+            quint8 byte = quint8(buffer.at(index++));
+            length += (byte & 0x7f) * multiplier;
+            multiplier *= 128;
+            if (!(byte & 0x80)) {
+                complete = true;
+                break;
+            }
+        }
+        if (!complete) {
+            if (index - pos > 4) {
+                qWarning() << "Malformed remaining length from" << client->clientId;
+                socket->abort();
+                return;
+            }
+            break;
+        }
+        if (length > kMaxPacketSize) {
+            qWarning() << "Packet too large from" << client->clientId << length;
+            socket->abort();
+            return;
+        }
+        if (index + length > buffer.size()) {
+            break;
+        }
+
+        QByteArray body = buffer.mid(index, length);
+        pos = index + length;
+        PacketResult result = processPacket(client, header, body);
+        if (result == PacketInvalid) {
+            socket->abort();
+            return;
+        }
+        if (result == PacketDisconnect) {
+            // 没有待发数据时disconnectFromHost会同步发出disconnected，
+            // dropClient随即释放client，因此之后不能再访问它
+            client->buffer.clear();
+            socket->disconnectFromHost();
+            return;
+        }
+    }
+    client->buffer.remove(0, pos);
+}
+
+void MiniBroker::dropClient()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Client *client = findClient(socket);
+    if (!client) {
+        return;
+    }
+    m_clients.removeOne(client);
+    if (client->connected) {
+        emit clientDisconnected(client->clientId);
+    }
+    socket->deleteLater();
+    delete client;
+}
+
+MiniBroker::Client *MiniBroker::findClient(QTcpSocket *socket)
+{
+    for (Client *client : m_clients) {
+        if (client->socket == socket) {
+            return client;
+        }
+    }
+    return nullptr;
+}
+
+MiniBroker::PacketResult MiniBroker::processPacket(Client *client, quint8 header, const QByteArray &body)
+{
+    int type = header >> 4;
+    if (!client->connected && type != Connect) {
+        qWarning() << "Packet before CONNECT, type" << type;
+        return PacketInvalid;
+    }
+
+    switch (type) {
+    case Connect:
+        handleConnect(client, body);
+        return PacketHandled;
+    case Publish: {
+        // 转发给订阅者，只支持QoS 0
+        if ((header >> 1) & 0x3) {
+            qWarning() << "QoS > 0 not supported, client" << client->clientId;
+            return PacketInvalid;
+        }
+        int pos = 0;
+        QByteArray topic;
+        if (!readString(body, &pos, &topic)) {
+            return PacketInvalid;
+        }
+        int count = 0;
+        deliver(topic, encodePacket(Publish << 4, body), &count);
+        emit messagePublished(topic, body.mid(pos));
+        return PacketHandled;
+    }
+    case Subscribe:
+        handleSubscribe(client, body, true);
+        return PacketHandled;
+    case Unsubscribe:
+        handleSubscribe(client, body, false);
+        return PacketHandled;
+    case PingReq:
+        client->socket->write(encodePacket(PingResp << 4, QByteArray()));
+        return PacketHandled;
+    case Disconnect:
+        return PacketDisconnect;
+    default:
+        qWarning() << "Unsupported packet type" << type;
+        return PacketInvalid;
+    }
+}
+
+void MiniBroker::handleConnect(Client *client, const QByteArray &body)
+{
+    // 可变报头：协议名、协议级别、连接标志、保持连接时间，之后是客户端标识
+    int pos = 0;
+    QByteArray protocol;
+    QByteArray clientId;
+    if (readString(body, &pos, &protocol) && pos + 4 <= body.size()) {
+        pos += 4;
+        readString(body, &pos, &clientId);
+    }
+    client->clientId = QString::fromUtf8(clientId);
+    client->connected = true;
+
+    // 会话不保持，返回码0表示接受
+    QByteArray ack(2, '\0');
+    client->socket->write(encodePacket(ConnAck << 4, ack));
+    emit clientConnected(client->clientId);
+}
+
+void MiniBroker::handleSubscribe(Client *client, const QByteArray &body, bool subscribe)
+{
+    if (body.size() < 2) {
+        return;
+    }
+    QByteArray packetId = body.left(2);
+    QByteArray grants;
+
+    int pos = 2;
+    QByteArray filter;
+    while (readString(body, &pos, &filter)) {
+        QString name = QString::fromUtf8(filter);
+        if (subscribe) {
+            // 跳过请求的QoS，一律授予QoS 0
+            ++pos;
+            if (!client->filters.contains(name)) {
+                client->filters.append(name);
+            }
+            grants.append('\0');
+        } else {
+            client->filters.removeAll(name);
+        }
+    }
+
+    if (subscribe) {
+        client->socket->write(encodePacket((SubAck << 4), packetId + grants));
+    } else {
+        client->socket->write(encodePacket((UnsubAck << 4), packetId));
+    }
+}
+
+void MiniBroker::deliver(const QByteArray &topic, const QByteArray &packet, int *count)
+{
+    QString topicName = QString::fromUtf8(topic);
+    for (Client *client : m_clients) {
+        if (!client->connected) {
+            continue;
+        }
+        for (const QString &filter : client->filters) {
+            if (topicMatches(filter, topicName)) {
+                client->socket->write(packet);
+                ++*count;
+                break;
+            }
+        }
+    }
+}
+
+bool MiniBroker::topicMatches(const QString &filter, const QString &topic)
+{
+    if (filter == topic) {
+        return true;
+    }
+
+    // 支持单层通配符+和多层通配符#
+    QStringList filterLevels = filter.split('/');
+    QStringList topicLevels = topic.split('/');
+    for (int i = 0; i < filterLevels.size(); ++i) {
+        const QString &level = filterLevels.at(i);
+        if (level == QLatin1String("#")) {
+            return true;
+        }
+        if (i >= topicLevels.size()) {
+            return false;
+        }
+        if (level != QLatin1String("+") && level != topicLevels.at(i)) {
+            return false;
+        }
+    }
+    return filterLevels.size() == topicLevels.size();
+}
+
+QByteArray MiniBroker::encodePacket(quint8 header, const QByteArray &body)
+{
+    QByteArray packet;
+    packet.reserve(body.size() + 5);
+    packet.append(char(header));
+
+    // 剩余长度：每字节7位，最高位表示后面还有字节
+    int length = body.size();
+    do {
+        quint8 byte = quint8(length % 128);
+        length /= 128;
+        if (length > 0) {
+            byte |= 0x80;
+        }
+        packet.append(char(byte));
+    } while (length > 0);
+
+    packet.append(body);
+    return packet;
+}
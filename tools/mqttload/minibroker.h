@@ -0,0 +1,81 @@
+#ifndef MINIBROKER_H
+#define MINIBROKER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief 最小的本地MQTT服务器
+ * 只实现MQTT 3.1.1的QoS 0子集（CONNECT/SUBSCRIBE/UNSUBSCRIBE/PUBLISH/PINGREQ/DISCONNECT），
+ * 用于离线压测运行时，不做认证、会话保持和保留消息
+ */
+class MiniBroker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MiniBroker(QObject *parent = nullptr);
+    ~MiniBroker();
+
+    // 开始监听
+    bool listen(const QHostAddress &address, quint16 port);
+    QString errorString() const { return m_server->errorString(); }
+    quint16 serverPort() const { return m_server->serverPort(); }
+
+    // 在进程内发布消息，返回投递的客户端个数
+    int publish(const QByteArray &topic, const QByteArray &payload);
+
+    // 已完成CONNECT的客户端个数
+    int clientCount() const;
+
+    // 对应主题是否有订阅者
+    bool hasSubscriber(const QByteArray &topic) const;
+
+    // 等待发送的字节数最多的客户端的积压量，用于压测时判断订阅者是否跟得上
+    qint64 maxPendingBytes() const;
+
+signals:
+    void clientConnected(const QString &clientId);
+    void clientDisconnected(const QString &clientId);
+
+    // 收到客户端发布的消息（转发给订阅者之后发出）
+    void messagePublished(const QByteArray &topic, const QByteArray &payload);
+
+private slots:
+    void acceptConnection();
+    void readClient();
+    void dropClient();
+
+private:
+    struct Client {
+        QTcpSocket *socket;
+        QByteArray buffer;          // 未处理的接收数据
+        QString clientId;
+        bool connected;
+        QStringList filters;        // 订阅的主题过滤器
+    };
+
+    // 报文处理结果：断开时客户端可能已被dropClient释放，调用方不能再访问它
+    enum PacketResult {
+        PacketHandled,
+        PacketInvalid,
+        PacketDisconnect
+    };
+
+    Client *findClient(QTcpSocket *socket);
+    PacketResult processPacket(Client *client, quint8 header, const QByteArray &body);
+    void handleConnect(Client *client, const QByteArray &body);
+    void handleSubscribe(Client *client, const QByteArray &body, bool subscribe);
+    void deliver(const QByteArray &topic, const QByteArray &packet, int *count);
+
+    static bool topicMatches(const QString &filter, const QString &topic);
+    static QByteArray encodePacket(quint8 header, const QByteArray &body);
+
+    QTcpServer *m_server;
+    QVector<Client *> m_clients;
+};
+
+#endif // MINIBROKER_H
@@ -0,0 +1,33 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = mqttload
+TEMPLATE = app
+
+# Sparkplug报文编码与运行时共用
+RUNTIME_DIR = $$PWD/../../runtime
+
+INCLUDEPATH += $$RUNTIME_DIR
+
+SOURCES += \
+    main.cpp \
+    minibroker.cpp \
+    loadgenerator.cpp \
+    $$RUNTIME_DIR/sparkplugencoder.cpp
+
+HEADERS += \
+    minibroker.h \
+    loadgenerator.h \
+    $$RUNTIME_DIR/sparkplugencoder.h
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target